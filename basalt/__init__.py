@@ -17,6 +17,7 @@ from ._basalt import (
     DirectedGraph,
     make_id,
     default_config_file,
+    Traversal,
 )
 from ._basalt import __rocksdb_version__  # noqa
 
@@ -31,6 +32,7 @@ __all__ = [
     "Edges",
     "make_id",
     "Status",
+    "Traversal",
     "UndirectedGraph",
     "Vertices",
 ]
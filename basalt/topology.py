@@ -13,7 +13,7 @@ from cached_property import cached_property
 import numpy as np
 from six import string_types, with_metaclass
 
-from basalt import DirectedGraph, UndirectedGraph
+from basalt import DirectedGraph, Traversal, UndirectedGraph
 from .serialization import serialization_method
 
 __all__ = ["vertex", "edge", "Graph"]
@@ -340,9 +340,7 @@ class VerticesWrapper:
     def __iter__(self):
         """Get iterator over vertices of this type
         """
-        for vertex in self.g.vertices:
-            if vertex[0] == self.type:
-                yield vertex
+        return self.g.vertices.of_type(self.type)
 
     def clear(self):
         """Remove all vertices of this type"""
@@ -371,6 +369,73 @@ class VertexInfo(
         self.__cls = cls
 
 
+class TraversalWrapper:
+    """Chain of traversal steps checked against the graph schema, and executed
+    at once in C++ by :func:`TraversalWrapper.execute`"""
+
+    def __init__(self, g, vertices, type, ids):
+        """
+        Args:
+            g: low-level graph instance
+            vertices(dict): :class:`VertexInfo` of every vertex type
+            type(enum value): type of the seed vertices
+            ids(iterable of int): identifiers of the seed vertices
+        """
+        self.g = g
+        self._vertices = vertices
+        self._ids = np.asarray(ids, dtype=np.uint64)
+        self._types = np.full(len(self._ids), type.value, dtype=np.int32)
+        self._reachable = {type}
+        self._traversal = Traversal()
+
+    def out(self, type=None):
+        """Replace every vertex by its neighbours
+
+        Args:
+            type(enum value): type of the neighbours to follow,
+            all types declared by the :func:`edge` directives if not specified
+
+        Returns:
+            This instance
+        """
+        tails = set(
+            conn.tail
+            for head in self._reachable
+            for conn in self._vertices[head].connections
+        )
+        if type is None:
+            self._traversal.out()
+            self._reachable = tails
+        else:
+            if type not in tails:
+                raise ValueError(
+                    "No edge declared from {} to {}".format(
+                        ", ".join(sorted(t.name for t in self._reachable)), type.name
+                    )
+                )
+            self._traversal.out(type.value)
+            self._reachable = {type}
+        return self
+
+    def distinct(self):
+        """Remove duplicate vertices
+
+        Returns:
+            This instance
+        """
+        self._traversal.distinct()
+        return self
+
+    def execute(self):
+        """Execute all steps
+
+        Returns:
+            tuple of 2 arrays, the types as `np.array(dtype=np.int32)` and
+            the identifiers as `np.array(dtype=np.uint64)` of the resulting vertices
+        """
+        return self.g.traverse(self._types, self._ids, self._traversal)
+
+
 class Graph(with_metaclass(DirectiveMeta)):
     @classmethod
     def _generate_methods(cls):
@@ -688,6 +753,19 @@ class Graph(with_metaclass(DirectiveMeta)):
         """See :func:`basalt.Graph.edges`"""
         return self.g.edges
 
+    def traverse(self, type, ids):
+        """Start a traversal from vertices of a given type
+
+        Args:
+            type(enum value): type of the seed vertices
+            ids(iterable of int): identifiers of the seed vertices
+
+        Returns:
+            :class:`TraversalWrapper` instance, for instance:
+            ``g.traverse(Vertex.NEURON, ids).out(Vertex.ASTROCYTE).distinct().execute()``
+        """
+        return TraversalWrapper(self.g, self._vertices, type, ids)
+
     def commit(self):
         """See :func:`basalt.Graph.commit`"""
         return self.g.commit()
@@ -6,8 +6,13 @@
  *************************************************************************/
 #pragma once
 
+#include <basalt/bulk_loader.hpp>
+#include <basalt/csr.hpp>
 #include <basalt/edge_iterator.hpp>
 #include <basalt/edges.hpp>
 #include <basalt/graph.hpp>
+#include <basalt/hops.hpp>
+#include <basalt/payload_view.hpp>
+#include <basalt/traversal.hpp>
 #include <basalt/vertex_iterator.hpp>
 #include <basalt/vertices.hpp>
@@ -0,0 +1,115 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <memory>
+
+#include <basalt/fwd.hpp>
+#include <basalt/status.hpp>
+
+namespace basalt {
+
+/**
+ * \brief Load a large number of vertices and edges in a graph.
+ *
+ * Vertices and edges are sorted with a bounded amount of memory, then
+ * written in SST files that are eventually ingested all at once in the
+ * database, bypassing the write-ahead log and the memtables.
+ *
+ * Lists of vertices and edges are encoded and sorted on a pool of threads.
+ * At ingestion, records are split in ranges of keys written concurrently.
+ *
+ * Unlike \a Vertices::insert and \a Edges::insert, the loader does not check
+ * that both ends of an edge are in the graph. Nothing is visible in the graph
+ * until \a ingest is called.
+ */
+template <EdgeOrientation Orientation>
+class BulkLoader {
+  public:
+    /**
+     * Build a \a BulkLoader
+     * \param graph Pointer to implementation of the graph to load
+     * \param max_memory approximative number of bytes buffered in memory
+     * before being spilled to disk.
+     * \param num_threads number of threads, 0 means one per hardware thread
+     */
+    BulkLoader(GraphImpl<Orientation>& graph, std::size_t max_memory, std::size_t num_threads);
+    BulkLoader(BulkLoader&& other) noexcept;
+    ~BulkLoader();
+
+    /**
+     * \brief Add a vertex to load
+     * \param vertex the vertex unique identifier
+     * \param data vertex payload
+     * \param size payload length
+     * \return information whether operation succeeded or not
+     */
+    Status insert_vertex(const vertex_uid_t& vertex,
+                         const char* data = nullptr,
+                         std::size_t size = 0) __attribute__((warn_unused_result));
+
+    /**
+     * \brief Add a list of vertices to load
+     * \param types array of vertex types
+     * \param ids array of vertex identifiers
+     * \param payloads array of serialized data, \a nullptr if
+     * none of the vertices have a payload
+     * \param payloads_sizes size of every payloads, \a nullptr
+     * if none of the vertex have a payload
+     * \param num_vertices number of vertices
+     * \return information whether operation succeeded or not
+     */
+    Status insert_vertices(const vertex_t* types,
+                           const vertex_id_t* ids,
+                           const char* const* payloads,
+                           const std::size_t* payloads_sizes,
+                           std::size_t num_vertices) __attribute__((warn_unused_result));
+
+    /**
+     * \brief Add an edge to load
+     * \param vertex1 one end of the edge
+     * \param vertex2 second end of the edge
+     * \param data payload of the edge
+     * \param size payload length
+     * \return information whether operation succeeded or not
+     */
+    Status insert_edge(const vertex_uid_t& vertex1,
+                       const vertex_uid_t& vertex2,
+                       const char* data = nullptr,
+                       std::size_t size = 0) __attribute__((warn_unused_result));
+
+    /**
+     * \brief Add edges between a vertex and several vertices of the same type
+     * \param vertex the vertex to connect to others
+     * \param type target vertices type
+     * \param vertices the identifiers of the vertices to connect to \a vertex
+     * \param num_vertices number of target vertices
+     * \return information whether operation succeeded or not
+     */
+    Status insert_edges(const vertex_uid_t& vertex,
+                        vertex_t type,
+                        const vertex_id_t* vertices,
+                        std::size_t num_vertices) __attribute__((warn_unused_result));
+
+    /**
+     * \brief Write the added vertices and edges in SST files and ingest them
+     * atomically in the graph. The loader can be reused afterward.
+     * If the graph is not empty, the presence of every loaded vertex and edge
+     * is looked up in batches so that the counters of the graph only account
+     * for the new ones.
+     * \return information whether operation succeeded or not
+     */
+    Status ingest() __attribute__((warn_unused_result));
+
+  private:
+    std::unique_ptr<BulkLoaderImpl<Orientation>> pimpl_;
+};
+
+extern template class BulkLoader<EdgeOrientation::directed>;
+extern template class BulkLoader<EdgeOrientation::undirected>;
+
+}  // namespace basalt
@@ -0,0 +1,90 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <basalt/fwd.hpp>
+
+namespace basalt {
+
+/**
+ * \brief Compressed sparse row representation of the topology of a graph,
+ * built from a consistent snapshot of the database by \a Graph::snapshot_csr
+ *
+ * Vertices are indexed densely in [0, num_vertices()), sorted by type then identifier.
+ * The neighbours of the vertex at index \a i are the vertices at indices
+ * \a indices[offsets[i]] to \a indices[offsets[i + 1] - 1], sorted as well.
+ * Both directions of the edges of an undirected graph are present.
+ *
+ * Offsets and indices are signed so that they can be used as the index arrays
+ * of a SciPy sparse matrix without conversion.
+ */
+struct CSR {
+    /// type of every vertex
+    std::vector<vertex_t> types;
+    /// identifier of every vertex
+    std::vector<vertex_id_t> ids;
+    /// position of the first neighbour of every vertex in \a indices, plus the total
+    std::vector<std::int64_t> offsets;
+    /// dense index of the neighbours of every vertex
+    std::vector<std::int64_t> indices;
+
+    /// \return number of vertices
+    inline std::size_t num_vertices() const noexcept {
+        return types.size();
+    }
+
+    /// \return number of edges
+    inline std::size_t num_edges() const noexcept {
+        return indices.size();
+    }
+
+    /// \return the vertex at a dense index
+    inline vertex_uid_t vertex(std::size_t index) const {
+        return {types[index], ids[index]};
+    }
+
+    /**
+     * \brief look up the dense index of a vertex
+     * \return index of the vertex, -1 if it is not in the snapshot
+     */
+    std::int64_t index(const vertex_uid_t& vertex) const;
+
+    /**
+     * \brief label the weakly connected components of the graph with a concurrent
+     * union-find over the edges
+     * \param components replaced by the component of every vertex, i.e. the smallest
+     * dense index of the vertices of its component
+     * \param num_threads number of threads, 0 means one per hardware thread
+     */
+    void connected_components(std::vector<std::int64_t>& components,
+                              std::size_t num_threads = 0) const;
+
+    /**
+     * \brief compute the PageRank of every vertex by power iteration.
+     * Ranks of the vertices without neighbours are distributed among all vertices.
+     * \param ranks replaced by the rank of every vertex, summing to 1
+     * \param damping probability to follow an edge rather than jump to any vertex
+     * \param tolerance iterations stop once the L1 norm of the change of ranks
+     * is below this value
+     * \param max_iterations maximum number of iterations
+     * \param num_threads number of threads, 0 means one per hardware thread
+     * \return number of iterations performed
+     */
+    std::size_t pagerank(std::vector<double>& ranks,
+                         double damping = 0.85,
+                         double tolerance = 1e-6,
+                         std::size_t max_iterations = 100,
+                         std::size_t num_threads = 0) const;
+
+    /// \brief release all arrays
+    void clear();
+};
+
+}  // namespace basalt
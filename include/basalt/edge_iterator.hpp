@@ -8,6 +8,7 @@
 
 #include <iterator>
 #include <memory>
+#include <string>
 
 #include <basalt/fwd.hpp>
 
@@ -29,6 +30,20 @@ class EdgeIterator: public std::iterator<std::input_iterator_tag, const edge_uid
     template <EdgeOrientation Orientation>
     EdgeIterator(const GraphImpl<Orientation>& pimpl, size_t from);
 
+    /**
+     * Create an iterator over edges starting at a given one
+     * \param pimpl Pointer to implementation
+     * \param from first edge to visit, or the next one if missing
+     */
+    template <EdgeOrientation Orientation>
+    EdgeIterator(const GraphImpl<Orientation>& pimpl, const edge_uid_t& from);
+
+    /**
+     * Create an iterator from its implementation
+     * \param pimpl Pointer to implementation, past-the-end if null
+     */
+    explicit EdgeIterator(std::shared_ptr<EdgeIteratorImpl> pimpl);
+
     /**
      * Copy constructor
      * \param other Other iterator
@@ -61,6 +76,13 @@ class EdgeIterator: public std::iterator<std::input_iterator_tag, const edge_uid
      */
     const value_type& operator*();
 
+    /**
+     * \brief Opaque token to resume the iteration at the current edge,
+     * see \a Edges::resume
+     * \return an empty string if the iteration is over
+     */
+    std::string token() const;
+
     using EdgeIteratorImpl_ptr = std::shared_ptr<EdgeIteratorImpl>;
 
   private:
@@ -73,5 +95,11 @@ extern template EdgeIterator::EdgeIterator(
 extern template EdgeIterator::EdgeIterator(
     const basalt::GraphImpl<EdgeOrientation::undirected>& pimpl,
     size_t from);
+extern template EdgeIterator::EdgeIterator(
+    const basalt::GraphImpl<EdgeOrientation::directed>& pimpl,
+    const edge_uid_t& from);
+extern template EdgeIterator::EdgeIterator(
+    const basalt::GraphImpl<EdgeOrientation::undirected>& pimpl,
+    const edge_uid_t& from);
 
 }  // namespace basalt
@@ -6,6 +6,10 @@
  *************************************************************************/
 #pragma once
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include <basalt/fwd.hpp>
 #include <basalt/status.hpp>
 
@@ -26,10 +30,44 @@ class Edges {
     /**
      * \brief Iterator over the edges of the graph
      * \param position starting position, default at the beginning
+     * Every edge before \a position is visited, see \a begin(from) to resume
+     * an iteration in logarithmic time.
      * \return edge iterator
      */
     EdgeIterator begin(std::size_t position = 0) const;
 
+    /**
+     * \brief Iterator over the edges of the graph starting at a given one, without
+     * visiting the previous edges.
+     * \param from first edge to visit, or the next one if not in the graph
+     * \return edge iterator
+     */
+    EdgeIterator begin(const edge_uid_t& from) const;
+
+    /**
+     * \brief Resume an iteration over edges
+     * \param token value returned by \a EdgeIterator::token
+     * \return edge iterator at the edge the token was taken at, or the next one
+     * if it has been removed since
+     */
+    EdgeIterator resume(const std::string& token) const;
+
+    /**
+     * \brief Iterate over the edges of the graph, every undirected edge only once.
+     *
+     * Both directions of an undirected edge are stored, so \a begin visits
+     * every edge twice. This iteration only yields the direction whose source is
+     * the smaller vertex and seeks past the other ones, at about half the cost of a
+     * full pass. Edges of directed graphs are all visited, like with \a begin.
+     * \return edge iterator, equal to \a end_unique() once exhausted
+     */
+    EdgeIterator begin_unique() const;
+
+    /**
+     * \return an iterator referring to the past-the-end of \a begin_unique
+     */
+    EdgeIterator end_unique() const;
+
     /**
      * \return an iterator referring to the past-the-end
      */
@@ -125,6 +163,15 @@ class Edges {
     Status get(const edge_uid_t& edge, std::string* value) const
         __attribute__((warn_unused_result));
 
+    /**
+     * \brief Retrieve an edge payload without copying it
+     * \param edge unique identifier to retrieve
+     * \param value view updated if the edge exists, empty if it has no payload
+     * \return information whether operation succeeded or not
+     */
+    Status get(const edge_uid_t& edge, PayloadView& value) const
+        __attribute__((warn_unused_result));
+
     /**
      * \brief check connectivity between 2 vertices
      * \param vertex1 first end of the edge to look for
@@ -156,6 +203,178 @@ class Edges {
     Status get(const vertex_uid_t& vertex, vertex_t filter, vertex_uids_t& edges) const
         __attribute__((warn_unused_result));
 
+    /**
+     * \brief get vertices of a specific type connected to one vertex
+     * whose identifiers are in a given range
+     * \param vertex one end of the edges to look
+     * \param filter type of target vertices
+     * \param first lower bound of target vertices identifiers, inclusive
+     * \param last upper bound of target vertices identifiers, exclusive
+     * \param edges accumulator where connected vertices are added, sorted by identifier
+     * \return information whether operation succeeded or not
+     */
+    Status get(const vertex_uid_t& vertex,
+               vertex_t filter,
+               vertex_id_t first,
+               vertex_id_t last,
+               vertex_uids_t& edges) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief get identifiers of the vertices of a specific type connected to one vertex.
+     * Unlike \a get(vertex, filter, edges), the type is not repeated for every
+     * neighbour.
+     * \param vertex one end of the edges to look
+     * \param filter type of target vertices
+     * \param ids accumulator where identifiers of connected vertices are added
+     * \return information whether operation succeeded or not
+     */
+    Status get(const vertex_uid_t& vertex, vertex_t filter, std::vector<vertex_id_t>& ids) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief get vertices connected to a vertex as a structure of arrays
+     * \param vertex for directed graph, the head of the edges to look for,
+     * any end of the edges otherwise
+     * \param types accumulator where types of connected vertices are added
+     * \param ids accumulator where identifiers of connected vertices are added
+     * \return information whether operation succeeded or not
+     */
+    Status get(const vertex_uid_t& vertex,
+               std::vector<vertex_t>& types,
+               std::vector<vertex_id_t>& ids) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief get vertices connected to a vertex along with the payloads of the edges,
+     * in a single scan of the edges of the vertex instead of one lookup per edge
+     * \param vertex for directed graph, the head of the edges to look for,
+     * any end of the edges otherwise
+     * \param edges accumulator where connected vertices are added
+     * \param payloads buffer where the payloads of the edges are appended
+     * \param offsets positions of the payloads in \a payloads: the payload of the
+     * i-th added vertex spans [offsets[i], offsets[i + 1]). Initialized with the size
+     * of \a payloads if empty, then one element is added per connected vertex.
+     * \return information whether operation succeeded or not
+     */
+    Status get_with_payloads(const vertex_uid_t& vertex,
+                             vertex_uids_t& edges,
+                             std::string& payloads,
+                             std::vector<std::size_t>& offsets) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief get identifiers of the vertices of a specific type connected to a vertex
+     * along with the payloads of the edges
+     * \param vertex one end of the edges to look
+     * \param filter type of target vertices
+     * \param ids accumulator where identifiers of connected vertices are added
+     * \param payloads buffer where the payloads of the edges are appended
+     * \param offsets positions of the payloads in \a payloads, see
+     * \a get_with_payloads(vertex, edges, payloads, offsets)
+     * \return information whether operation succeeded or not
+     */
+    Status get_with_payloads(const vertex_uid_t& vertex,
+                             vertex_t filter,
+                             std::vector<vertex_id_t>& ids,
+                             std::string& payloads,
+                             std::vector<std::size_t>& offsets) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief get identifiers of the vertices of a specific type connected to several
+     * vertices, in compressed sparse row format. The vertices are visited in sorted
+     * order with forward seeks of the same iterator.
+     * \param types types of the vertices
+     * \param ids identifiers of the vertices
+     * \param num_vertices number of vertices
+     * \param filter type of target vertices
+     * \param offsets replaced by \a num_vertices + 1 elements: the neighbours of the i-th
+     * vertex are neighbours[offsets[i]:offsets[i + 1]]
+     * \param neighbours replaced by the identifiers of the connected vertices,
+     * sorted for every vertex
+     * \param num_threads maximum number of threads visiting the vertices,
+     * 0 for one per hardware thread, 1 to only use the calling thread
+     * \return information whether operation succeeded or not
+     */
+    Status get_many(const vertex_t* types,
+                    const vertex_id_t* ids,
+                    std::size_t num_vertices,
+                    vertex_t filter,
+                    std::vector<std::size_t>& offsets,
+                    std::vector<vertex_id_t>& neighbours,
+                    std::size_t num_threads = 1) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief get the vertices connected to two vertices
+     * \param vertex1 first vertex
+     * \param vertex2 second vertex
+     * \param vertices replaced by the common neighbours, sorted
+     * \return information whether operation succeeded or not
+     */
+    Status common(const vertex_uid_t& vertex1,
+                  const vertex_uid_t& vertex2,
+                  vertex_uids_t& vertices) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief get identifiers of the vertices of a specific type connected to two vertices
+     * \param vertex1 first vertex
+     * \param vertex2 second vertex
+     * \param filter type of target vertices
+     * \param ids replaced by the identifiers of the common neighbours, sorted
+     * \return information whether operation succeeded or not
+     */
+    Status common(const vertex_uid_t& vertex1,
+                  const vertex_uid_t& vertex2,
+                  vertex_t filter,
+                  std::vector<vertex_id_t>& ids) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief combine the identifiers of the vertices of a specific type connected
+     * to several vertices. All neighbour lists are read with the same iterator,
+     * and an intersection or a difference stops reading as soon as it is empty.
+     * \param operation how to combine the neighbour lists
+     * \param vertices vertices whose neighbours are combined, in order
+     * \param filter type of target vertices
+     * \param ids replaced by the resulting identifiers, sorted
+     * \return information whether operation succeeded or not
+     */
+    Status combine(SetOperation operation,
+                   const vertex_uids_t& vertices,
+                   vertex_t filter,
+                   std::vector<vertex_id_t>& ids) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief get number of vertices connected to a vertex
+     * \param vertex for directed graph, the head of the edges to look for,
+     * any end of the edges otherwise
+     * \param degree non-const reference updated by this member function
+     * \return information whether operation succeeded or not
+     */
+    Status degree(const vertex_uid_t& vertex, std::size_t& degree) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief get number of vertices of a specific type connected to a vertex
+     * \param vertex one end of the edges to look
+     * \param filter type of target vertices
+     * \param degree non-const reference updated by this member function
+     * \return information whether operation succeeded or not
+     */
+    Status degree(const vertex_uid_t& vertex, vertex_t filter, std::size_t& degree) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief get number of vertices connected to several vertices
+     * \param types types of the vertices
+     * \param ids identifiers of the vertices
+     * \param num_vertices number of vertices
+     * \param degrees array of \a num_vertices elements filled by this member function
+     * \return information whether operation succeeded or not
+     */
+    Status degree(const vertex_t* types,
+                  const vertex_id_t* ids,
+                  std::size_t num_vertices,
+                  std::size_t* degrees) const __attribute__((warn_unused_result));
+
     /**
      * \brief remove edge between 2 vertices
      * \param vertex1 one end of the edge to remove
@@ -194,6 +413,48 @@ class Edges {
      */
     Status count(std::size_t& count) const __attribute__((warn_unused_result));
 
+    /**
+     * \brief get number of edges between vertices of the given types
+     * \param head type of the vertices where the edges start
+     * \param tail type of the vertices where the edges end
+     * \param count non-const reference updated by this member function
+     * \return information whether operation succeeded or not
+     */
+    Status count(vertex_t head, vertex_t tail, std::size_t& count) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief Visit all edges of the graph on several threads, like \a begin does,
+     * so both directions of undirected edges. The edges are split in ranges of similar
+     * sizes on disk, at the boundaries of the database files, and every range is
+     * visited on its own thread from the same snapshot.
+     * \param visitor function called with the index of a range, in [0, num_partitions),
+     * and every edge of this range in order. Calls for different ranges are concurrent.
+     * \param num_partitions maximum number of ranges, 0 for one per hardware thread
+     * \return information whether operation succeeded or not
+     */
+    Status parallel_for_each(const std::function<void(std::size_t, const edge_uid_t&)>& visitor,
+                             std::size_t num_partitions = 0) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief Visit all edges of the graph on several threads, with one state per
+     * range of edges reduced once all of them are visited
+     * \tparam State default constructible accumulator of a range
+     * \param result state passed to \a reduce along with the state of every range
+     * \param visitor function called with the state of a range and every edge of
+     * this range, see \a parallel_for_each(visitor, num_partitions)
+     * \param reduce function called with \a result and the state of every range, in order
+     * \param num_partitions maximum number of ranges, 0 for one per hardware thread
+     * \return information whether operation succeeded or not
+     */
+    template <typename State, typename Visitor, typename Reduce>
+    Status parallel_for_each(State& result,
+                             Visitor visitor,
+                             Reduce reduce,
+                             std::size_t num_partitions = 0) const
+        __attribute__((warn_unused_result));
+
     /**
      * \brief Remove all edges of the graph along. Vertices are kept intact.
      * \param commit whether uncommitted operations should be flushed or not
@@ -209,3 +470,5 @@ extern template class Edges<EdgeOrientation::directed>;
 extern template class Edges<EdgeOrientation::undirected>;
 
 }  // namespace basalt
+
+#include <basalt/edges.ipp>
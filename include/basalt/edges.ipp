@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <basalt/status.hpp>
+
+namespace basalt {
+
+template <EdgeOrientation Orientation>
+template <typename State, typename Visitor, typename Reduce>
+Status Edges<Orientation>::parallel_for_each(State& result,
+                                             Visitor visitor,
+                                             Reduce reduce,
+                                             std::size_t num_partitions) const {
+    if (num_partitions == 0) {
+        num_partitions = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<State> states(num_partitions);
+    const auto status = parallel_for_each(
+        [&states, &visitor](std::size_t partition, const edge_uid_t& element) {
+            visitor(states[partition], element);
+        },
+        num_partitions);
+    if (status) {
+        for (auto& state: states) {
+            reduce(result, state);
+        }
+    }
+    return status;
+}
+
+}  // namespace basalt
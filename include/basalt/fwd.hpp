@@ -17,13 +17,31 @@ enum class EdgeOrientation {
     directed,
 };
 
+/// operations combining the sorted neighbours of several vertices
+enum class SetOperation {
+    /// neighbours of all vertices
+    set_intersection,
+    /// neighbours of any vertex
+    set_union,
+    /// neighbours of the first vertex but none of the others
+    set_difference,
+};
+
 /// Forward declarations
 template <EdgeOrientation Orientation>
+class BulkLoader;
+template <EdgeOrientation Orientation>
+class BulkLoaderImpl;
+struct CSR;
+template <EdgeOrientation Orientation>
 class Edges;
 class EdgeIterator;
 class EdgeIteratorImpl;
 template <EdgeOrientation Orientation>
 class GraphImpl;
+struct Hops;
+class Traversal;
+class PayloadView;
 class VertexIteratorImpl;
 class VertexIterator;
 template <EdgeOrientation Orientation>
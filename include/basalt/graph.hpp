@@ -68,6 +68,80 @@ class Graph {
      */
     Status commit() __attribute__((warn_unused_result));
 
+    /**
+     * \brief Recompute the number of vertices and edges by iterating
+     * over the whole database. Counters are otherwise maintained
+     * along every insertion and removal.
+     * \return information whether operation succeeded or not
+     */
+    Status recount() __attribute__((warn_unused_result));
+
+    /**
+     * \brief Create a loader to insert a large number of vertices and edges
+     * \param max_memory approximative number of bytes the loader buffers in memory
+     * \param num_threads number of threads used to sort and write vertices and edges,
+     * 0 means one per hardware thread
+     * \return a new loader
+     */
+    BulkLoader<Orientation> bulk_loader(std::size_t max_memory = 256ul * 1024 * 1024,
+                                        std::size_t num_threads = 0);
+
+    /**
+     * \brief Build the compressed sparse row representation of the graph topology
+     * from a consistent snapshot of the database, in one parallel pass over the
+     * vertices then the edges
+     * \param csr structure overwritten with the vertices and edges of the graph
+     * \param num_partitions maximum number of ranges of vertices and edges visited
+     * concurrently, 0 for one per hardware thread
+     * \return information whether operation succeeded or not
+     */
+    Status snapshot_csr(CSR& csr, std::size_t num_partitions = 0) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief Write the compressed sparse row representation of the graph topology
+     * in the graph directory. Graphs later opened in read-only mode map this file
+     * in memory to answer neighbour queries and degree queries, unless the database
+     * was modified after the export. Processes reading the same graph share the
+     * mapped pages.
+     * \param num_partitions maximum number of ranges of vertices and edges visited
+     * concurrently, 0 for one per hardware thread
+     * \return information whether operation succeeded or not
+     */
+    Status export_csr(std::size_t num_partitions = 0) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief Visit the graph breadth-first from a set of vertices. Every hop expands
+     * the whole frontier at once, visiting its vertices in sorted order with forward
+     * seeks of the same iterator, and all hops read the same snapshot of the database.
+     * \param seeds vertices to start from
+     * \param num_hops number of hops
+     * \param type_filters type of the vertices reached at every hop, \a num_hops
+     * elements, or empty to follow edges to vertices of any type
+     * \param hops overwritten with the vertices first reached at every hop
+     * \return information whether operation succeeded or not, an invalid argument
+     * error if \a type_filters is neither empty nor of \a num_hops elements
+     */
+    Status k_hop(const vertex_uids_t& seeds,
+                 std::size_t num_hops,
+                 const std::vector<vertex_t>& type_filters,
+                 Hops& hops) const __attribute__((warn_unused_result));
+
+    /**
+     * \brief Execute a traversal from a set of vertices. Every step is applied to all
+     * vertices at once with batched scans, and all steps read the same snapshot
+     * of the database.
+     * \param seeds vertices to start from
+     * \param traversal steps to execute
+     * \param types overwritten with the types of the resulting vertices
+     * \param ids overwritten with the identifiers of the resulting vertices
+     * \return information whether operation succeeded or not
+     */
+    Status traverse(const vertex_uids_t& seeds,
+                    const Traversal& traversal,
+                    std::vector<vertex_t>& types,
+                    std::vector<vertex_id_t>& ids) const __attribute__((warn_unused_result));
+
     /**
      * \brief Provides human readable string of all database counters
      */
@@ -0,0 +1,45 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <vector>
+
+#include <basalt/fwd.hpp>
+
+namespace basalt {
+
+/**
+ * \brief Vertices reached hop by hop by a breadth-first traversal of a graph,
+ * filled by \a Graph::k_hop
+ *
+ * The vertices first reached at hop \a h, in [1, num_hops()], are at positions
+ * \a offsets[h - 1] to \a offsets[h] - 1 of \a types and \a ids, sorted by type
+ * then identifier. Every vertex, including the seeds, appears at most once.
+ */
+struct Hops {
+    /// position of the first vertex of every hop in \a types and \a ids, plus the total
+    std::vector<std::size_t> offsets;
+    /// type of every reached vertex
+    std::vector<vertex_t> types;
+    /// identifier of every reached vertex
+    std::vector<vertex_id_t> ids;
+
+    /// \return number of hops
+    inline std::size_t num_hops() const noexcept {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    /// \return number of vertices reached at a hop, in [1, num_hops()]
+    inline std::size_t size(std::size_t hop) const {
+        return offsets[hop] - offsets[hop - 1];
+    }
+
+    /// \brief release all arrays
+    void clear();
+};
+
+}  // namespace basalt
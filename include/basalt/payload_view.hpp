@@ -0,0 +1,61 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace rocksdb {
+
+/// forward declaration
+class PinnableSlice;
+
+}  // namespace rocksdb
+
+namespace basalt {
+
+/**
+ * \brief Read-only access to a payload without copying it.
+ *
+ * The payload memory stays pinned in the RocksDB block cache as long as the
+ * view holds it. The view keeps the database open so that it may outlive the
+ * graph it was filled from.
+ */
+class PayloadView {
+  public:
+    PayloadView();
+    PayloadView(PayloadView&& other) noexcept;
+    PayloadView& operator=(PayloadView&& other) noexcept;
+    ~PayloadView();
+
+    /// \return pointer to the first byte of the payload
+    const char* data() const noexcept;
+
+    /// \return payload length
+    std::size_t size() const noexcept;
+
+    /// \return true if there is no payload
+    inline bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /// \brief release the pinned memory
+    void reset();
+
+    /// \return the underlying slice filled by the graph lookups
+    rocksdb::PinnableSlice& slice();
+
+    /// \brief keep the owner of the pinned memory alive as long as the view holds it
+    void keep_alive(std::shared_ptr<const void> owner);
+
+  private:
+    /// declared first so that the pinned memory is released before its owner
+    std::shared_ptr<const void> owner_;
+    std::unique_ptr<rocksdb::PinnableSlice> slice_;
+};
+
+}  // namespace basalt
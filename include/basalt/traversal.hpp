@@ -0,0 +1,64 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <vector>
+
+#include <basalt/fwd.hpp>
+
+namespace basalt {
+
+/**
+ * \brief Declarative traversal of a graph, executed at once by \a Graph::traverse
+ *
+ * A traversal is a sequence of steps transforming a multiset of vertices, starting
+ * with the seeds. Steps are only recorded by this class, for instance:
+ *
+ * \code
+ * Traversal traversal;
+ * traversal.out(astrocyte).out(endfoot).distinct();
+ * \endcode
+ *
+ * Like in a path query, a vertex reached by several paths appears several times
+ * until a \a distinct step. Such a vertex is nevertheless only expanded once,
+ * and its copies are dropped early when a later \a distinct step makes them irrelevant.
+ */
+class Traversal {
+  public:
+    enum class Operation {
+        /// replace every vertex by its neighbours
+        out,
+        /// remove duplicate vertices
+        distinct,
+    };
+
+    struct Step {
+        Operation operation;
+        /// true if the neighbours of an \a out step are restricted to \a type
+        bool filtered;
+        vertex_t type;
+    };
+
+    /// \brief replace every vertex by its neighbours of all types
+    Traversal& out();
+
+    /// \brief replace every vertex by its neighbours of a given type
+    Traversal& out(vertex_t type);
+
+    /// \brief remove duplicate vertices
+    Traversal& distinct();
+
+    /// \return recorded steps, in order
+    inline const std::vector<Step>& steps() const noexcept {
+        return steps_;
+    }
+
+  private:
+    std::vector<Step> steps_;
+};
+
+}  // namespace basalt
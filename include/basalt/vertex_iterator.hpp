@@ -8,6 +8,7 @@
 
 #include <iterator>
 #include <memory>
+#include <string>
 
 #include <basalt/fwd.hpp>
 
@@ -29,6 +30,20 @@ class VertexIterator: public std::iterator<std::input_iterator_tag, const vertex
     template <EdgeOrientation Orientation>
     VertexIterator(const GraphImpl<Orientation>& pimpl, size_t from);
 
+    /**
+     * Create an iterator over vertices starting at a given one
+     * \param pimpl Pointer to implementation
+     * \param from first vertex to visit, or the next one if missing
+     */
+    template <EdgeOrientation Orientation>
+    VertexIterator(const GraphImpl<Orientation>& pimpl, const vertex_uid_t& from);
+
+    /**
+     * Create an iterator from its implementation
+     * \param pimpl Pointer to implementation, past-the-end if null
+     */
+    explicit VertexIterator(std::shared_ptr<VertexIteratorImpl> pimpl);
+
     /**
      * Copy constructor
      * \param other Other iterator
@@ -61,6 +76,13 @@ class VertexIterator: public std::iterator<std::input_iterator_tag, const vertex
      */
     const value_type& operator*();
 
+    /**
+     * \brief Opaque token to resume the iteration at the current vertex,
+     * see \a Vertices::resume
+     * \return an empty string if the iteration is over
+     */
+    std::string token() const;
+
     using VertexIteratorImpl_ptr = std::shared_ptr<VertexIteratorImpl>;
 
   private:
@@ -73,5 +95,11 @@ extern template VertexIterator::VertexIterator(
 extern template VertexIterator::VertexIterator(
     const basalt::GraphImpl<EdgeOrientation::directed>& pimpl,
     size_t from);
+extern template VertexIterator::VertexIterator(
+    const basalt::GraphImpl<EdgeOrientation::directed>& pimpl,
+    const vertex_uid_t& from);
+extern template VertexIterator::VertexIterator(
+    const basalt::GraphImpl<EdgeOrientation::undirected>& pimpl,
+    const vertex_uid_t& from);
 
 }  // namespace basalt
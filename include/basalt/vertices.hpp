@@ -6,6 +6,8 @@
  *************************************************************************/
 #pragma once
 
+#include <functional>
+
 #include <basalt/fwd.hpp>
 #include <basalt/graph.hpp>
 #include <basalt/status.hpp>
@@ -26,10 +28,43 @@ class Vertices {
     /**
      * \brief Iterate over vertices
      * \param position starting position, default at the beginning
+     * Every vertex before \a position is visited, see \a begin(from) to resume
+     * an iteration in logarithmic time.
      * \return vertex iterator
      */
     VertexIterator begin(std::size_t position = 0) const;
 
+    /**
+     * \brief Iterate over vertices starting at a given one, without visiting
+     * the previous vertices.
+     * \param from first vertex to visit, or the next one if not in the graph
+     * \return vertex iterator
+     */
+    VertexIterator begin(const vertex_uid_t& from) const;
+
+    /**
+     * \brief Resume an iteration over vertices
+     * \param token value returned by \a VertexIterator::token
+     * \return vertex iterator at the vertex the token was taken at, or the next one
+     * if it has been removed since
+     */
+    VertexIterator resume(const std::string& token) const;
+
+    /**
+     * \brief Iterate over the vertices of a certain type only. The iteration
+     * seeks to the first vertex of this type and stops after the last one,
+     * vertices of other types are never read.
+     * \param type type of the vertices to visit
+     * \return vertex iterator, equal to \a end_type(type) once exhausted
+     */
+    VertexIterator begin_type(vertex_t type) const;
+
+    /**
+     * \param type type of the vertices visited by \a begin_type
+     * \return an iterator referring to the past-the-end
+     */
+    VertexIterator end_type(vertex_t type) const;
+
     /**
      * \return an iterator referring to the past-the-end
      */
@@ -51,6 +86,37 @@ class Vertices {
      */
     Status count(vertex_t type, std::size_t& count) const __attribute__((warn_unused_result));
 
+    /**
+     * \brief Visit all vertices of the graph on several threads. The vertices are split
+     * in ranges of similar sizes on disk, at the boundaries of the database files,
+     * and every range is visited on its own thread from the same snapshot.
+     * \param visitor function called with the index of a range, in [0, num_partitions),
+     * and every vertex of this range in order. Calls for different ranges are concurrent.
+     * \param num_partitions maximum number of ranges, 0 for one per hardware thread
+     * \return information whether operation succeeded or not
+     */
+    Status parallel_for_each(const std::function<void(std::size_t, const vertex_uid_t&)>& visitor,
+                             std::size_t num_partitions = 0) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief Visit all vertices of the graph on several threads, with one state per
+     * range of vertices reduced once all of them are visited
+     * \tparam State default constructible accumulator of a range
+     * \param result state passed to \a reduce along with the state of every range
+     * \param visitor function called with the state of a range and every vertex of
+     * this range, see \a parallel_for_each(visitor, num_partitions)
+     * \param reduce function called with \a result and the state of every range, in order
+     * \param num_partitions maximum number of ranges, 0 for one per hardware thread
+     * \return information whether operation succeeded or not
+     */
+    template <typename State, typename Visitor, typename Reduce>
+    Status parallel_for_each(State& result,
+                             Visitor visitor,
+                             Reduce reduce,
+                             std::size_t num_partitions = 0) const
+        __attribute__((warn_unused_result));
+
     /**
      * \brief Remove all vertices of the graph along with their edges
      * \param commit whether uncommitted operations should be flushed or not
@@ -129,6 +195,15 @@ class Vertices {
     Status get(const vertex_uid_t& vertex, std::string* value) const
         __attribute__((warn_unused_result));
 
+    /**
+     * \brief Retrieve a vertex payload without copying it
+     * \param vertex the vertex to retrieve
+     * \param value view updated if vertex exists, empty if it has no payload
+     * \return information whether operation succeeded or not
+     */
+    Status get(const vertex_uid_t& vertex, PayloadView& value) const
+        __attribute__((warn_unused_result));
+
     /**
      * \brief Check presence of a vertex in the graph
      * \param vertex the vertex to look for
@@ -137,6 +212,27 @@ class Vertices {
      */
     Status has(const vertex_uid_t& vertex, bool& result) const __attribute__((warn_unused_result));
 
+    /**
+     * \brief Check presence of several vertices in the graph with batched lookups
+     * \param vertices array of vertices to look for
+     * \param num_vertices number of vertices
+     * \param results array updated with the presence of every vertex
+     * \return information whether operation managed to update \a results
+     */
+    Status has(const vertex_uid_t* vertices, std::size_t num_vertices, bool* results) const
+        __attribute__((warn_unused_result));
+
+    /**
+     * \brief Get vertices of a certain type whose identifiers are in a given range
+     * \param type type of the vertices to look for
+     * \param first lower bound of the identifiers range, inclusive
+     * \param last upper bound of the identifiers range, exclusive
+     * \param vertices accumulator where vertices are added, sorted by identifier
+     * \return information whether operation succeeded or not
+     */
+    Status range(vertex_t type, vertex_id_t first, vertex_id_t last, vertex_uids_t& vertices) const
+        __attribute__((warn_unused_result));
+
     /**
      * \brief Remove a vertex from the graph
      * \param vertex the vertex to remove
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <basalt/graph.hpp>
+#include <basalt/payload_view.hpp>
 #include <basalt/status.hpp>
 
 namespace basalt {
@@ -21,14 +25,37 @@ Status Vertices<Orientation>::insert(const vertex_uid_t& vertex, const Payload&
 template <EdgeOrientation Orientation>
 template <typename T>
 Status Vertices<Orientation>::get(const vertex_uid_t& vertex, T& payload) const {
-    std::string data;
-    auto const& status = get(vertex, &data);
+    PayloadView data;
+    auto const& status = get(vertex, data);
     if (status) {
         std::istringstream istr;
-        istr.rdbuf()->pubsetbuf(const_cast<char*>(data.c_str()), static_cast<long>(data.size()));
+        istr.rdbuf()->pubsetbuf(const_cast<char*>(data.data()), static_cast<long>(data.size()));
         payload.deserialize(istr);
     }
     return status;
 }
 
+template <EdgeOrientation Orientation>
+template <typename State, typename Visitor, typename Reduce>
+Status Vertices<Orientation>::parallel_for_each(State& result,
+                                                Visitor visitor,
+                                                Reduce reduce,
+                                                std::size_t num_partitions) const {
+    if (num_partitions == 0) {
+        num_partitions = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<State> states(num_partitions);
+    const auto status = parallel_for_each(
+        [&states, &visitor](std::size_t partition, const vertex_uid_t& element) {
+            visitor(states[partition], element);
+        },
+        num_partitions);
+    if (status) {
+        for (auto& state: states) {
+            reduce(result, state);
+        }
+    }
+    return status;
+}
+
 }  // namespace basalt
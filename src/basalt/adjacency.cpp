@@ -0,0 +1,195 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "adjacency.hpp"
+
+namespace basalt {
+
+constexpr char AdjacencyList::insertion_op;
+constexpr char AdjacencyList::removal_op;
+
+/**
+ * \name LEB128 varint helpers
+ * \{
+ */
+
+static inline void put_varint(std::string& dst, vertex_id_t value) {
+    while (value >= 0x80u) {
+        dst.push_back(static_cast<char>(value | 0x80u));
+        value >>= 7u;
+    }
+    dst.push_back(static_cast<char>(value));
+}
+
+static inline const char* get_varint(const char* data, const char* end, vertex_id_t& value) {
+    vertex_id_t result = 0;
+    for (unsigned int shift = 0; data != end && shift < 64; shift += 7) {
+        const auto byte = static_cast<unsigned char>(*data++);
+        result |= static_cast<vertex_id_t>(byte & 0x7fu) << shift;
+        if ((byte & 0x80u) == 0) {
+            value = result;
+            return data;
+        }
+    }
+    throw std::runtime_error("Corrupted adjacency list");
+}
+
+/** \} */
+
+void AdjacencyList::encode(const ids_t& ids, std::string& value) {
+    value.reserve(value.size() + 2 + ids.size());
+    put_varint(value, ids.size());
+    vertex_id_t previous = 0;
+    for (const auto id: ids) {
+        put_varint(value, id - previous);
+        previous = id;
+    }
+}
+
+void AdjacencyList::decode(const char* data, std::size_t size, ids_t& ids) {
+    if (size == 0) {
+        return;
+    }
+    const auto end = data + size;
+    vertex_id_t count;
+    data = get_varint(data, end, count);
+    // every identifier takes at least one byte, do not trust a corrupted count
+    ids.reserve(ids.size() + std::min<std::size_t>(count, static_cast<std::size_t>(end - data)));
+    vertex_id_t id = 0;
+    for (auto i = 0ul; i < count; ++i) {
+        vertex_id_t delta;
+        data = get_varint(data, end, delta);
+        id += delta;
+        ids.push_back(id);
+    }
+}
+
+std::size_t AdjacencyList::count(const char* data, std::size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    vertex_id_t count;
+    get_varint(data, data + size, count);
+    return count;
+}
+
+bool AdjacencyList::contains(const char* data, std::size_t size, vertex_id_t id) {
+    if (size == 0) {
+        return false;
+    }
+    const auto end = data + size;
+    vertex_id_t count;
+    data = get_varint(data, end, count);
+    vertex_id_t current = 0;
+    for (auto i = 0ul; i < count; ++i) {
+        vertex_id_t delta;
+        data = get_varint(data, end, delta);
+        current += delta;
+        if (current >= id) {
+            return current == id;
+        }
+    }
+    return false;
+}
+
+void AdjacencyList::encode_operand(char op, const ids_t& ids, std::string& operand) {
+    operand.clear();
+    operand.push_back(op);
+    encode(ids, operand);
+}
+
+void AdjacencyList::normalize(ids_t& ids) {
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+/**
+ * Apply one merge operand to a sorted list of identifiers
+ */
+static bool apply_operand(const rocksdb::Slice& operand, AdjacencyList::ids_t& ids) {
+    if (operand.empty()) {
+        return false;
+    }
+    AdjacencyList::ids_t operand_ids;
+    AdjacencyList::decode(operand.data() + 1, operand.size() - 1, operand_ids);
+    AdjacencyList::ids_t result;
+    result.reserve(ids.size() + operand_ids.size());
+    if (operand[0] == AdjacencyList::insertion_op) {
+        std::set_union(ids.begin(),
+                       ids.end(),
+                       operand_ids.begin(),
+                       operand_ids.end(),
+                       std::back_inserter(result));
+    } else if (operand[0] == AdjacencyList::removal_op) {
+        std::set_difference(ids.begin(),
+                            ids.end(),
+                            operand_ids.begin(),
+                            operand_ids.end(),
+                            std::back_inserter(result));
+    } else {
+        return false;
+    }
+    ids.swap(result);
+    return true;
+}
+
+bool AdjacencyMergeOperator::FullMergeV2(const MergeOperationInput& merge_in,
+                                         MergeOperationOutput* merge_out) const {
+    AdjacencyList::ids_t ids;
+    try {
+        if (merge_in.existing_value != nullptr) {
+            AdjacencyList::decode(merge_in.existing_value->data(),
+                                  merge_in.existing_value->size(),
+                                  ids);
+        }
+        for (const auto& operand: merge_in.operand_list) {
+            if (!apply_operand(operand, ids)) {
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    merge_out->new_value.clear();
+    AdjacencyList::encode(ids, merge_out->new_value);
+    return true;
+}
+
+bool AdjacencyMergeOperator::PartialMerge(const rocksdb::Slice& /*key*/,
+                                          const rocksdb::Slice& left_operand,
+                                          const rocksdb::Slice& right_operand,
+                                          std::string* new_value,
+                                          rocksdb::Logger* /*logger*/) const {
+    // only operands of the same kind can be combined, insertions and removals
+    // do not commute.
+    if (left_operand.empty() || right_operand.empty() || left_operand[0] != right_operand[0]) {
+        return false;
+    }
+    AdjacencyList::ids_t ids;
+    try {
+        AdjacencyList::decode(left_operand.data() + 1, left_operand.size() - 1, ids);
+        const auto left_size = ids.size();
+        AdjacencyList::decode(right_operand.data() + 1, right_operand.size() - 1, ids);
+        std::inplace_merge(ids.begin(),
+                           ids.begin() + static_cast<std::ptrdiff_t>(left_size),
+                           ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    } catch (const std::exception&) {
+        return false;
+    }
+    AdjacencyList::encode_operand(left_operand[0], ids, *new_value);
+    return true;
+}
+
+const char* AdjacencyMergeOperator::Name() const {
+    return "basalt.AdjacencyMergeOperator";
+}
+
+}  // namespace basalt
@@ -0,0 +1,93 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <rocksdb/merge_operator.h>
+
+#include <basalt/fwd.hpp>
+
+namespace basalt {
+
+/**
+ * Encode and decode the values of the "adjacency" column family used by the
+ * packed edge storage mode.
+ *
+ * A value holds the sorted identifiers of the neighbours of one vertex having the
+ * same type. It starts with the number of identifiers followed by the
+ * differences between consecutive identifiers, all written as LEB128 varints.
+ *
+ * Merge operands start with an operation byte, either \a insertion_op or
+ * \a removal_op, followed by a list encoded the same way.
+ */
+class AdjacencyList {
+  public:
+    using ids_t = std::vector<vertex_id_t>;
+
+    constexpr static char insertion_op = '+';
+    constexpr static char removal_op = '-';
+
+    /**
+     * \brief Encode a list of identifiers
+     * \param ids sorted identifiers without duplicates
+     * \param value string where the encoded list is appended
+     */
+    static void encode(const ids_t& ids, std::string& value);
+
+    /**
+     * \brief Decode a list of identifiers
+     * \param data encoded list
+     * \param size encoded list length
+     * \param ids vector where identifiers are appended
+     */
+    static void decode(const char* data, std::size_t size, ids_t& ids);
+
+    /**
+     * \return number of identifiers in an encoded list without decoding it
+     */
+    static std::size_t count(const char* data, std::size_t size);
+
+    /**
+     * \return true if an encoded list contains an identifier
+     */
+    static bool contains(const char* data, std::size_t size, vertex_id_t id);
+
+    /**
+     * \brief Encode a merge operand
+     * \param op either \a insertion_op or \a removal_op
+     * \param ids sorted identifiers without duplicates
+     * \param operand string where the operand is written
+     */
+    static void encode_operand(char op, const ids_t& ids, std::string& operand);
+
+    /**
+     * \brief sort a list of identifiers and remove duplicates
+     */
+    static void normalize(ids_t& ids);
+};
+
+/**
+ * RocksDB merge operator applying insertions and removals of
+ * neighbours to adjacency lists.
+ */
+class AdjacencyMergeOperator: public rocksdb::MergeOperator {
+  public:
+    bool FullMergeV2(const MergeOperationInput& merge_in,
+                     MergeOperationOutput* merge_out) const override;
+
+    bool PartialMerge(const rocksdb::Slice& key,
+                      const rocksdb::Slice& left_operand,
+                      const rocksdb::Slice& right_operand,
+                      std::string* new_value,
+                      rocksdb::Logger* logger) const override;
+
+    const char* Name() const override;
+};
+
+}  // namespace basalt
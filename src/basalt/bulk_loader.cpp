@@ -0,0 +1,71 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <basalt/bulk_loader.hpp>
+
+#include "bulk_loader_impl.hpp"
+
+namespace basalt {
+
+template <EdgeOrientation Orientation>
+BulkLoader<Orientation>::BulkLoader(GraphImpl<Orientation>& graph,
+                                    std::size_t max_memory,
+                                    std::size_t num_threads)
+    : pimpl_(new BulkLoaderImpl<Orientation>(graph, max_memory, num_threads)) {}
+
+template <EdgeOrientation Orientation>
+BulkLoader<Orientation>::BulkLoader(BulkLoader&& other) noexcept = default;
+
+template <EdgeOrientation Orientation>
+BulkLoader<Orientation>::~BulkLoader() = default;
+
+template <EdgeOrientation Orientation>
+Status BulkLoader<Orientation>::insert_vertex(const vertex_uid_t& vertex,
+                                              const char* data,
+                                              std::size_t size) {
+    return pimpl_->insert_vertex(vertex, {data, size});
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoader<Orientation>::insert_vertices(const vertex_t* types,
+                                                const vertex_id_t* ids,
+                                                const char* const* payloads,
+                                                const std::size_t* payloads_sizes,
+                                                std::size_t num_vertices) {
+    if (payloads == nullptr) {
+        return pimpl_->insert_vertices({types, num_vertices}, {ids, num_vertices}, {}, {});
+    }
+    return pimpl_->insert_vertices({types, num_vertices},
+                                   {ids, num_vertices},
+                                   {payloads, num_vertices},
+                                   {payloads_sizes, num_vertices});
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoader<Orientation>::insert_edge(const vertex_uid_t& vertex1,
+                                            const vertex_uid_t& vertex2,
+                                            const char* data,
+                                            std::size_t size) {
+    return pimpl_->insert_edge(vertex1, vertex2, {data, size});
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoader<Orientation>::insert_edges(const vertex_uid_t& vertex,
+                                             vertex_t type,
+                                             const vertex_id_t* vertices,
+                                             std::size_t num_vertices) {
+    return pimpl_->insert_edges(vertex, type, {vertices, num_vertices});
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoader<Orientation>::ingest() {
+    return pimpl_->ingest();
+}
+
+template class BulkLoader<EdgeOrientation::directed>;
+template class BulkLoader<EdgeOrientation::undirected>;
+
+}  // namespace basalt
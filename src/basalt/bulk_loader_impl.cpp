@@ -0,0 +1,570 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#include <rocksdb/db.h>
+#include <rocksdb/sst_file_writer.h>
+
+#include "bulk_loader_impl.hpp"
+#include "graph_impl.hpp"
+
+namespace basalt {
+
+/**
+ * Write sorted records of a column family in a sequence of SST files
+ */
+class SstFiles {
+  public:
+    /// SST files are closed once they reach this size
+    constexpr static std::uint64_t max_file_size = 256ul * 1024 * 1024;
+
+    SstFiles(rocksdb::DB& db, rocksdb::ColumnFamilyHandle* column, std::string prefix)
+        : db_(db)
+        , column_(column)
+        , prefix_(std::move(prefix)) {}
+
+    ~SstFiles() {
+        // files not ingested
+        for (const auto& file: files_) {
+            std::remove(file.c_str());
+        }
+    }
+
+    rocksdb::Status put(const rocksdb::Slice& key, const rocksdb::Slice& value) {
+        auto status = open();
+        if (status.ok()) {
+            status = writer_->Put(key, value);
+        }
+        return status.ok() ? rotate() : status;
+    }
+
+    rocksdb::Status merge(const rocksdb::Slice& key, const rocksdb::Slice& value) {
+        auto status = open();
+        if (status.ok()) {
+            status = writer_->Merge(key, value);
+        }
+        return status.ok() ? rotate() : status;
+    }
+
+    /// \brief close the current SST file, if any
+    rocksdb::Status finish() {
+        if (!writer_) {
+            return rocksdb::Status::OK();
+        }
+        const auto status = writer_->Finish();
+        writer_.reset();
+        return status;
+    }
+
+    inline const std::vector<std::string>& files_get() const noexcept {
+        return files_;
+    }
+
+  private:
+    rocksdb::Status open() {
+        if (writer_) {
+            return rocksdb::Status::OK();
+        }
+        writer_.reset(new rocksdb::SstFileWriter(rocksdb::EnvOptions(),
+                                                 db_.GetOptions(column_),
+                                                 column_));
+        files_.push_back(prefix_ + '-' + std::to_string(files_.size()) + ".sst");
+        return writer_->Open(files_.back());
+    }
+
+    rocksdb::Status rotate() {
+        if (writer_->FileSize() < max_file_size) {
+            return rocksdb::Status::OK();
+        }
+        return finish();
+    }
+
+    rocksdb::DB& db_;
+    rocksdb::ColumnFamilyHandle* column_;
+    const std::string prefix_;
+    std::unique_ptr<rocksdb::SstFileWriter> writer_;
+    std::vector<std::string> files_;
+};
+
+constexpr std::uint64_t SstFiles::max_file_size;
+
+/**
+ * \brief look up sorted keys of a column family with a single \a MultiGet call
+ * \param visitor called for every key with its value, or \a nullptr if the key is missing
+ */
+static rocksdb::Status multi_get(
+    rocksdb::DB& db,
+    rocksdb::ColumnFamilyHandle* column,
+    const std::vector<std::string>& keys,
+    const std::function<void(std::size_t index, const rocksdb::Slice* value)>& visitor) {
+    std::vector<rocksdb::Slice> slices(keys.begin(), keys.end());
+    std::vector<rocksdb::PinnableSlice> values(keys.size());
+    std::vector<rocksdb::Status> statuses(keys.size());
+    db.MultiGet(rocksdb::ReadOptions(),
+                column,
+                keys.size(),
+                slices.data(),
+                values.data(),
+                statuses.data(),
+                true);
+    for (auto i = 0ul; i < keys.size(); ++i) {
+        if (statuses[i].ok()) {
+            visitor(i, &values[i]);
+        } else if (statuses[i].IsNotFound()) {
+            visitor(i, nullptr);
+        } else {
+            return statuses[i];
+        }
+    }
+    return rocksdb::Status::OK();
+}
+
+/**
+ * \brief create a unique temporary directory inside the database directory
+ */
+template <EdgeOrientation Orientation>
+static std::string make_directory(const std::string& path) {
+    std::string pattern = path + "/bulk-XXXXXX";
+    if (mkdtemp(&pattern[0]) == nullptr) {
+        GraphImpl<Orientation>::to_status(
+            rocksdb::Status::IOError("Could not create temporary directory", pattern))
+            .raise_on_error();
+    }
+    return pattern;
+}
+
+/// \return the sorters as expected by \a ExternalSorter::merge
+static std::vector<const ExternalSorter*> sorters(
+    const std::vector<std::unique_ptr<ExternalSorter>>& owners) {
+    std::vector<const ExternalSorter*> result;
+    result.reserve(owners.size());
+    for (const auto& sorter: owners) {
+        result.push_back(sorter.get());
+    }
+    return result;
+}
+
+template <EdgeOrientation Orientation>
+constexpr std::size_t BulkLoaderImpl<Orientation>::min_chunk_size;
+
+template <EdgeOrientation Orientation>
+constexpr std::size_t BulkLoaderImpl<Orientation>::lookup_batch_size;
+
+template <EdgeOrientation Orientation>
+BulkLoaderImpl<Orientation>::BulkLoaderImpl(GraphImpl<Orientation>& graph,
+                                            std::size_t max_memory,
+                                            std::size_t num_threads)
+    : graph_(graph)
+    , directory_(make_directory<Orientation>(graph.path_get()))
+    , pool_(num_threads)
+    , sequence_() {
+    const auto sorter_memory = std::max<std::size_t>(max_memory / (2 * pool_.size()), 1);
+    for (auto i = 0ul; i < pool_.size(); ++i) {
+        vertices_.emplace_back(
+            new ExternalSorter(directory_, "vertices-" + std::to_string(i), sorter_memory));
+        edges_.emplace_back(
+            new ExternalSorter(directory_, "edges-" + std::to_string(i), sorter_memory));
+    }
+}
+
+template <EdgeOrientation Orientation>
+BulkLoaderImpl<Orientation>::~BulkLoaderImpl() {
+    vertices_.clear();
+    edges_.clear();
+    rmdir(directory_.c_str());
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoaderImpl<Orientation>::parallel_add(sorters_t& sorters,
+                                                 std::size_t count,
+                                                 const add_function_t& add) {
+    const auto chunks = std::max(1ul, std::min(sorters.size(), count / min_chunk_size));
+    std::vector<rocksdb::Status> statuses(chunks);
+    pool_.parallel_for(chunks, [&](std::size_t chunk) {
+        const auto first = chunk * count / chunks;
+        const auto last = (chunk + 1) * count / chunks;
+        statuses[chunk] = add(*sorters[chunk], first, last);
+    });
+    sequence_ += count;
+    for (const auto& status: statuses) {
+        if (!status.ok()) {
+            return GraphImpl<Orientation>::to_status(status);
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoaderImpl<Orientation>::insert_vertex(const vertex_uid_t& vertex,
+                                                  const gsl::span<const char>& payload) {
+    GraphKV::vertex_key_t key;
+    GraphKV::encode(vertex, key);
+    return GraphImpl<Orientation>::to_status(
+        vertices_.front()->add(rocksdb::Slice(key.data(), key.size()),
+                               rocksdb::Slice(payload.data(), payload.size()),
+                               sequence_++));
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoaderImpl<Orientation>::insert_vertices(
+    const gsl::span<const vertex_t> types,
+    const gsl::span<const vertex_id_t> ids,
+    const gsl::span<const char* const> payloads,
+    const gsl::span<const std::size_t> payloads_sizes) {
+    const auto sequence = sequence_;
+    return parallel_add(
+        vertices_, ids.size(), [&](ExternalSorter& sorter, std::size_t first, std::size_t last) {
+            GraphKV::vertex_key_t key;
+            for (auto i = first; i < last; ++i) {
+                GraphKV::encode(types[i], ids[i], key);
+                const auto payload = payloads.empty()
+                                         ? rocksdb::Slice()
+                                         : rocksdb::Slice(payloads[i], payloads_sizes[i]);
+                const auto status =
+                    sorter.add(rocksdb::Slice(key.data(), key.size()), payload, sequence + i);
+                if (!status.ok()) {
+                    return status;
+                }
+            }
+            return rocksdb::Status::OK();
+        });
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoaderImpl<Orientation>::insert_edge(const vertex_uid_t& vertex1,
+                                                const vertex_uid_t& vertex2,
+                                                const gsl::span<const char>& payload) {
+    typename GraphImpl<Orientation>::edge_keys_t keys;
+    GraphKV::encode(vertex1, vertex2, keys);
+    const auto sequence = sequence_++;
+    const rocksdb::Slice data(payload.data(), payload.size());
+    // keys of an undirected edge are (vertex1, vertex2) then (vertex2, vertex1)
+    const auto& canonical = vertex2 < vertex1 ? keys.back() : keys.front();
+    for (const auto& key: keys) {
+        // the other key is an empty marker, dropped in packed mode
+        const auto stored = !graph_.canonical_payloads() || key == canonical;
+        const auto status = edges_.front()->add(rocksdb::Slice(key.data(), key.size()),
+                                                stored ? data : rocksdb::Slice(),
+                                                sequence);
+        if (!status.ok()) {
+            return GraphImpl<Orientation>::to_status(status);
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoaderImpl<Orientation>::insert_edges(const vertex_uid_t& vertex,
+                                                 vertex_t type,
+                                                 const gsl::span<const vertex_id_t>& vertices) {
+    const auto sequence = sequence_;
+    return parallel_add(
+        edges_, vertices.size(), [&](ExternalSorter& sorter, std::size_t first, std::size_t last) {
+            typename GraphImpl<Orientation>::edge_keys_t keys;
+            for (auto i = first; i < last; ++i) {
+                GraphKV::encode(vertex, make_id(type, vertices[i]), keys);
+                for (const auto& key: keys) {
+                    const auto status = sorter.add(rocksdb::Slice(key.data(), key.size()),
+                                                   rocksdb::Slice(),
+                                                   sequence + i);
+                    if (!status.ok()) {
+                        return status;
+                    }
+                }
+            }
+            return rocksdb::Status::OK();
+        });
+}
+
+template <EdgeOrientation Orientation>
+std::vector<std::string> BulkLoaderImpl<Orientation>::partition(const sorters_t& sorters,
+                                                                std::size_t prefix_size) const {
+    std::vector<std::string> samples;
+    for (const auto& sorter: sorters) {
+        for (const auto& sample: sorter->samples()) {
+            samples.push_back(prefix_size != 0 ? sample.substr(0, prefix_size) : sample);
+        }
+    }
+    std::vector<std::string> splits;
+    if (samples.empty()) {
+        return splits;
+    }
+    std::sort(samples.begin(), samples.end());
+    for (auto i = 1ul; i < pool_.size(); ++i) {
+        const auto& split = samples[i * samples.size() / pool_.size()];
+        if (!split.empty() && (splits.empty() || splits.back() != split)) {
+            splits.push_back(split);
+        }
+    }
+    return splits;
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoaderImpl<Orientation>::write(const sorters_t& sorters,
+                                          rocksdb::ColumnFamilyHandle* column,
+                                          bool edges,
+                                          bool lookup,
+                                          std::vector<rocksdb::IngestExternalFileArg>& args,
+                                          std::vector<std::unique_ptr<SstFiles>>& files,
+                                          Counters& counters) {
+    pool_.parallel_for(sorters.size(), [&sorters](std::size_t i) { sorters[i]->prepare(); });
+    const auto splits =
+        partition(sorters, edges ? std::tuple_size<GraphKV::edge_key_type_prefix_t>::value : 0);
+    const auto partitions = splits.size() + 1;
+    const auto adjacency_column = edges ? graph_.adjacency_column_get() : nullptr;
+    const std::string name = edges ? "/edges-" : "/vertices-";
+
+    auto& db = *graph_.db_get();
+    std::vector<std::unique_ptr<SstFiles>> outputs;
+    std::vector<std::unique_ptr<SstFiles>> adjacency_outputs;
+    for (auto p = 0ul; p < partitions; ++p) {
+        outputs.emplace_back(new SstFiles(db, column, directory_ + name + std::to_string(p)));
+        if (adjacency_column != nullptr) {
+            adjacency_outputs.emplace_back(new SstFiles(
+                db, adjacency_column, directory_ + "/adjacency-" + std::to_string(p)));
+        }
+    }
+    std::vector<Counters> partition_counters(partitions);
+    std::vector<rocksdb::Status> statuses(partitions);
+    pool_.parallel_for(partitions, [&](std::size_t p) {
+        const auto& lower = p == 0 ? std::string() : splits[p - 1];
+        const auto& upper = p == splits.size() ? std::string() : splits[p];
+        if (edges) {
+            statuses[p] = write_edges(lower,
+                                      upper,
+                                      *outputs[p],
+                                      adjacency_column ? adjacency_outputs[p].get() : nullptr,
+                                      lookup,
+                                      partition_counters[p]);
+        } else {
+            statuses[p] =
+                write_vertices(lower, upper, *outputs[p], lookup, partition_counters[p]);
+        }
+    });
+    for (auto p = 0ul; p < partitions; ++p) {
+        if (!statuses[p].ok()) {
+            return GraphImpl<Orientation>::to_status(statuses[p]);
+        }
+        counters.add(partition_counters[p]);
+    }
+
+    // partitions are sorted and do not overlap, their files are ingested together
+    const auto append = [&args, &files](rocksdb::ColumnFamilyHandle* handle,
+                                        std::vector<std::unique_ptr<SstFiles>>& outputs) {
+        rocksdb::IngestExternalFileArg arg;
+        arg.column_family = handle;
+        arg.options.move_files = true;
+        for (auto& output: outputs) {
+            const auto& paths = output->files_get();
+            arg.external_files.insert(arg.external_files.end(), paths.begin(), paths.end());
+            files.push_back(std::move(output));
+        }
+        if (!arg.external_files.empty()) {
+            args.push_back(std::move(arg));
+        }
+    };
+    append(column, outputs);
+    append(adjacency_column, adjacency_outputs);
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status BulkLoaderImpl<Orientation>::ingest() {
+    graph_.logger_get()->debug("bulk_loader.ingest(threads={})", pool_.size());
+    std::vector<rocksdb::IngestExternalFileArg> args;
+    std::vector<std::unique_ptr<SstFiles>> files;
+    Counters counters;
+    // records already in the graph must not be counted again
+    bool lookup = false;
+    const auto lookup_status = graph_.ingest_overlaps(lookup);
+    const auto vertices_status =
+        lookup_status
+            ? write(vertices_, graph_.vertices_column_get(), false, lookup, args, files, counters)
+            : lookup_status;
+    const auto edges_status =
+        vertices_status
+            ? write(edges_, graph_.edges_column_get(), true, lookup, args, files, counters)
+            : vertices_status;
+    for (auto& sorter: vertices_) {
+        sorter->clear();
+    }
+    for (auto& sorter: edges_) {
+        sorter->clear();
+    }
+    if (!edges_status) {
+        return edges_status;
+    }
+    return graph_.ingest(args, counters);
+}
+
+template <EdgeOrientation Orientation>
+rocksdb::Status BulkLoaderImpl<Orientation>::write_vertices(const std::string& lower,
+                                                            const std::string& upper,
+                                                            SstFiles& files,
+                                                            bool lookup,
+                                                            Counters& counters) const {
+    // keys of the vertices whose presence in the graph is not known yet
+    std::vector<std::string> pending;
+    vertex_uid_t vertex;
+    const auto count_pending = [&]() {
+        if (pending.empty()) {
+            return rocksdb::Status::OK();
+        }
+        const auto status =
+            multi_get(*graph_.db_get(),
+                      graph_.vertices_column_get(),
+                      pending,
+                      [&](std::size_t index, const rocksdb::Slice* value) {
+                          if (value == nullptr) {
+                              const auto& key = pending[index];
+                              GraphKV::decode_vertex(key.data(), key.size(), vertex);
+                              counters.add_vertices(vertex.first, 1);
+                          }
+                      });
+        pending.clear();
+        return status;
+    };
+    auto status = ExternalSorter::merge(
+        sorters(vertices_),
+        lower,
+        upper,
+        [&](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+            if (!lookup) {
+                GraphKV::decode_vertex(key.data(), key.size(), vertex);
+                counters.add_vertices(vertex.first, 1);
+                return files.put(key, value);
+            }
+            pending.push_back(key.ToString());
+            const auto counted =
+                pending.size() < lookup_batch_size ? rocksdb::Status::OK() : count_pending();
+            return counted.ok() ? files.put(key, value) : counted;
+        });
+    if (status.ok()) {
+        status = count_pending();
+    }
+    return status.ok() ? files.finish() : status;
+}
+
+template <EdgeOrientation Orientation>
+rocksdb::Status BulkLoaderImpl<Orientation>::write_edges(const std::string& lower,
+                                                         const std::string& upper,
+                                                         SstFiles& edges,
+                                                         SstFiles* adjacency,
+                                                         bool lookup,
+                                                         Counters& counters) const {
+    // keys whose presence in the graph is not known yet: edges keys, or keys
+    // of adjacency lists along with their identifiers in packed mode
+    std::vector<std::string> pending;
+    std::vector<AdjacencyList::ids_t> pending_ids;
+    const auto count_pending = [&]() {
+        if (pending.empty()) {
+            return rocksdb::Status::OK();
+        }
+        const auto visitor = [&](std::size_t index, const rocksdb::Slice* value) {
+            const auto& key = pending[index];
+            if (adjacency == nullptr) {
+                if (value == nullptr) {
+                    edge_uid_t edge;
+                    GraphKV::decode_edge(key.data(), key.size(), edge);
+                    counters.add_edges(edge.first.first, edge.second.first, 1);
+                }
+                return;
+            }
+            AdjacencyList::ids_t existing;
+            if (value != nullptr) {
+                AdjacencyList::decode(value->data(), value->size(), existing);
+            }
+            vertex_uid_t vertex;
+            vertex_t target_type;
+            GraphKV::decode_adjacency(key.data(), key.size(), vertex, target_type);
+            std::int64_t added = 0;
+            for (const auto id: pending_ids[index]) {
+                if (!std::binary_search(existing.begin(), existing.end(), id)) {
+                    ++added;
+                }
+            }
+            counters.add_edges(vertex.first, target_type, added);
+        };
+        const auto status = multi_get(*graph_.db_get(),
+                                      adjacency != nullptr ? graph_.adjacency_column_get()
+                                                           : graph_.edges_column_get(),
+                                      pending,
+                                      visitor);
+        pending.clear();
+        pending_ids.clear();
+        return status;
+    };
+    const auto lookup_key = [&](const rocksdb::Slice& key) {
+        pending.push_back(key.ToString());
+        return pending.size() < lookup_batch_size ? rocksdb::Status::OK() : count_pending();
+    };
+
+    // adjacency list being built: source vertex, target type and identifiers
+    vertex_uid_t source;
+    vertex_t type = 0;
+    AdjacencyList::ids_t ids;
+    std::string operand;
+    const auto flush_list = [&]() {
+        if (ids.empty()) {
+            return rocksdb::Status::OK();
+        }
+        GraphKV::adjacency_key_t key;
+        GraphKV::encode_adjacency(source, type, key);
+        AdjacencyList::encode_operand(AdjacencyList::insertion_op, ids, operand);
+        const rocksdb::Slice list(key.data(), key.size());
+        auto status = rocksdb::Status::OK();
+        if (lookup) {
+            pending_ids.push_back(std::move(ids));
+            status = lookup_key(list);
+        }
+        ids.clear();
+        return status.ok() ? adjacency->merge(list, operand) : status;
+    };
+
+    edge_uid_t edge;
+    const auto callback = [&](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+        GraphKV::decode_edge(key.data(), key.size(), edge);
+        if (!lookup) {
+            counters.add_edges(edge.first.first, edge.second.first, 1);
+        }
+        if (adjacency == nullptr) {
+            const auto looked_up = lookup ? lookup_key(key) : rocksdb::Status::OK();
+            return looked_up.ok() ? edges.put(key, value) : looked_up;
+        }
+        // edges are sorted by source vertex, then by target type and identifier
+        if (edge.first != source || edge.second.first != type) {
+            const auto flushed = flush_list();
+            if (!flushed.ok()) {
+                return flushed;
+            }
+            source = edge.first;
+            type = edge.second.first;
+        }
+        ids.push_back(edge.second.second);
+        // in packed mode, only payloads are kept in the edges column family
+        return value.empty() ? rocksdb::Status::OK() : edges.put(key, value);
+    };
+    auto status = ExternalSorter::merge(sorters(edges_), lower, upper, callback);
+    if (status.ok() && adjacency != nullptr) {
+        status = flush_list();
+        if (status.ok()) {
+            status = adjacency->finish();
+        }
+    }
+    if (status.ok()) {
+        status = count_pending();
+    }
+    return status.ok() ? edges.finish() : status;
+}
+
+template class BulkLoaderImpl<EdgeOrientation::directed>;
+template class BulkLoaderImpl<EdgeOrientation::undirected>;
+
+}  // namespace basalt
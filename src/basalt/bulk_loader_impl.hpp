@@ -0,0 +1,130 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gsl>
+
+#include <basalt/fwd.hpp>
+#include <basalt/status.hpp>
+
+#include "external_sorter.hpp"
+#include "fwd.hpp"
+#include "thread_pool.hpp"
+
+namespace basalt {
+
+class Counters;
+class SstFiles;
+
+/**
+ * \brief BulkLoader pointer to implementation
+ *
+ * Every worker of the pool encodes a chunk of the input in its own pair of
+ * sorters. At ingestion, split keys are chosen among the keys sampled by the
+ * sorters, and every worker merges one key range of all the sorters into its
+ * own SST files. Since key ranges do not overlap, all SST files are ingested
+ * at once.
+ */
+template <EdgeOrientation Orientation>
+class BulkLoaderImpl {
+  public:
+    /// inputs smaller than this are not split among the workers
+    constexpr static std::size_t min_chunk_size = 4096;
+    /// number of merged records whose presence in the graph is looked up at once
+    constexpr static std::size_t lookup_batch_size = 1024;
+
+    /**
+     * \param graph graph to load
+     * \param max_memory approximative number of bytes buffered in memory by all workers
+     * \param num_threads number of workers, 0 means one per hardware thread
+     */
+    BulkLoaderImpl(GraphImpl<Orientation>& graph, std::size_t max_memory, std::size_t num_threads);
+    /// remove the temporary files
+    ~BulkLoaderImpl();
+
+    Status insert_vertex(const vertex_uid_t& vertex, const gsl::span<const char>& payload);
+    Status insert_vertices(const gsl::span<const vertex_t> types,
+                           const gsl::span<const vertex_id_t> ids,
+                           const gsl::span<const char* const> payloads,
+                           const gsl::span<const std::size_t> payloads_sizes);
+    Status insert_edge(const vertex_uid_t& vertex1,
+                       const vertex_uid_t& vertex2,
+                       const gsl::span<const char>& payload);
+    Status insert_edges(const vertex_uid_t& vertex,
+                        vertex_t type,
+                        const gsl::span<const vertex_id_t>& vertices);
+    Status ingest();
+
+  private:
+    using sorters_t = std::vector<std::unique_ptr<ExternalSorter>>;
+    /**
+     * \brief add records to a sorter
+     * \param sorter where records are added
+     * \param first index of the first input element
+     * \param last index after the last input element
+     */
+    using add_function_t = std::function<
+        rocksdb::Status(ExternalSorter& sorter, std::size_t first, std::size_t last)>;
+
+    /// \brief split an input of \a count elements in chunks added concurrently
+    Status parallel_add(sorters_t& sorters, std::size_t count, const add_function_t& add);
+    /**
+     * \brief choose the keys splitting sorted records in ranges of similar sizes
+     * \param prefix_size if not 0, truncate split keys so that records whose key
+     * share this prefix are in the same range.
+     */
+    std::vector<std::string> partition(const sorters_t& sorters, std::size_t prefix_size) const;
+    /**
+     * \brief write sorted vertices of a key range in SST files
+     * \param lookup if true, only count the vertices not already in the graph
+     */
+    rocksdb::Status write_vertices(const std::string& lower,
+                                   const std::string& upper,
+                                   SstFiles& files,
+                                   bool lookup,
+                                   Counters& counters) const;
+    /**
+     * \brief write sorted edges of a key range in SST files, either keys or adjacency lists
+     * \param lookup if true, only count the edges not already in the graph
+     */
+    rocksdb::Status write_edges(const std::string& lower,
+                                const std::string& upper,
+                                SstFiles& edges,
+                                SstFiles* adjacency,
+                                bool lookup,
+                                Counters& counters) const;
+    /**
+     * \brief write the records of every sorter in SST files of a column family
+     * \param lookup if true, only count the records not already in the graph
+     */
+    Status write(const sorters_t& sorters,
+                 rocksdb::ColumnFamilyHandle* column,
+                 bool edges,
+                 bool lookup,
+                 std::vector<rocksdb::IngestExternalFileArg>& args,
+                 std::vector<std::unique_ptr<SstFiles>>& files,
+                 Counters& counters);
+
+    GraphImpl<Orientation>& graph_;
+    /// temporary directory where sorted runs and SST files are written
+    const std::string directory_;
+    ThreadPool pool_;
+    sorters_t vertices_;
+    sorters_t edges_;
+    /// sequence number of the next added record, so that the last one wins
+    std::uint64_t sequence_;
+};
+
+extern template class BulkLoaderImpl<EdgeOrientation::directed>;
+extern template class BulkLoaderImpl<EdgeOrientation::undirected>;
+
+}  // namespace basalt
@@ -8,6 +8,7 @@
 #include <cctype>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
 
 #include <gsl>
@@ -20,7 +21,11 @@
 
 #include <basalt/status.hpp>
 
+#include "adjacency.hpp"
 #include "config.hpp"
+#include "counters.hpp"
+#include "graph_kv.hpp"
+#include "memory_registry.hpp"
 #include "system.hpp"
 
 namespace basalt {
@@ -111,13 +116,12 @@ static const rocksdb::SliceTransform* fixed_prefix_extractor(const nlohmann::jso
  * \return number of bytes
  */
 static size_t capacity_from_string(const std::string& capacity) {
-    if (capacity.size() < 2) {
-        throw std::runtime_error("Invalid lru cache capacity. Expecting at least 2 characters: '" +
-                                 capacity + '\'');
+    if (capacity.empty()) {
+        throw std::runtime_error("Invalid memory size. Expecting a non-empty string");
     }
     auto size_len = capacity.size();
     size_t factor = 1;
-    if (std::isdigit(capacity.back()) != 0) {
+    if (std::isdigit(capacity.back()) == 0) {
         size_len -= 1;
         auto unit = capacity.back();
         if (unit == 't' || unit == 'T') {
@@ -129,11 +133,11 @@ static size_t capacity_from_string(const std::string& capacity) {
         } else if (unit == 'k' || unit == 'K') {
             factor <<= 10u;
         } else if (unit == '%') {
-            size_t percent;
+            double percent;
             std::istringstream iss(capacity.substr(0, size_len));
             iss >> percent;
-
-            return system::available_memory_bytes() / percent;
+            return static_cast<size_t>(static_cast<double>(system::available_memory_bytes()) *
+                                       percent / 100.);
         } else {
             throw std::runtime_error(std::string("Unknown unit: ") + unit);
         }
@@ -144,6 +148,22 @@ static size_t capacity_from_string(const std::string& capacity) {
     return size * factor;
 }
 
+/**
+ * \brief get number of bytes from JSON config
+ * \param capacity either a number or a string parsed by \a capacity_from_string
+ * \return number of bytes
+ */
+static size_t capacity_from_json(const nlohmann::json& capacity) {
+    if (capacity.is_string()) {
+        return capacity_from_string(capacity.get<std::string>());
+    }
+    if (capacity.is_number()) {
+        return capacity.get<size_t>();
+    }
+    throw std::runtime_error(
+        "Unexpected type for memory size. Expecting either string or number");
+}
+
 /**
  * Get least recent use block cache rocksdb config from JSON config
  */
@@ -155,17 +175,7 @@ static std::shared_ptr<rocksdb::Cache> lru_block_cache(const nlohmann::json& con
             num_shard_bits_json.value().get_to(num_shard_bits);
         }
     }
-    auto capacity_json = config["capacity"];
-    size_t capacity;
-    if (capacity_json.is_string()) {
-        capacity = capacity_from_string(capacity_json.get<std::string>());
-    } else if (capacity_json.is_number()) {
-        capacity_json.get_to(capacity);
-    } else {
-        throw std::runtime_error(
-            "Unexpected type for lru cache capacity. Expecting either string or number");
-    }
-
+    const auto capacity = capacity_from_json(config["capacity"]);
     return rocksdb::NewLRUCache(capacity, num_shard_bits);
 }
 
@@ -185,6 +195,14 @@ static std::shared_ptr<rocksdb::Cache> block_cache(
         return global_block_cache;
     }
     if (type == "lru") {
+        // named caches are shared by every database of the process
+        const auto name = config.find("name");
+        if (name != config.end()) {
+            const auto& lru_config = config["config"];
+            return MemoryRegistry::block_cache(name.value().get<std::string>(), [&lru_config]() {
+                return lru_block_cache(lru_config);
+            });
+        }
         return lru_block_cache(config["config"]);
     }
     throw std::runtime_error(std::string("Unknown block cache type: ") + type);
@@ -206,16 +224,48 @@ static std::shared_ptr<rocksdb::Cache> block_cache_if_present(
     return result;
 }
 
+/**
+ * Ensure that a JSON object only provides supported keys
+ * \param config JSON object to check
+ * \param keys supported keys
+ * \param context description of the JSON object used in error messages
+ */
+static void check_keys(const nlohmann::json& config,
+                       std::initializer_list<const char*> keys,
+                       const std::string& context) {
+    if (!config.is_object()) {
+        throw std::runtime_error("Expecting a JSON object for " + context);
+    }
+    for (auto it = config.begin(); it != config.end(); ++it) {
+        const auto& key = it.key();
+        if (std::none_of(keys.begin(), keys.end(), [&key](const char* k) { return key == k; })) {
+            throw std::runtime_error("Unknown key in " + context + ": '" + key + '\'');
+        }
+    }
+}
+
+/**
+ * Read an optional entry of a JSON object
+ * \param config JSON object
+ * \param key entry name
+ * \param value variable to update if the entry is present
+ */
+template <typename T>
+static void get_if_present(const nlohmann::json& config, const char* key, T& value) {
+    const auto it = config.find(key);
+    if (it != config.end()) {
+        it.value().get_to(value);
+    }
+}
+
 /**
  * Get rocksdb bloom filter policy config from JSON config
  */
 static std::shared_ptr<const rocksdb::FilterPolicy> bloom_filter_policy(
     const nlohmann::json& config) {
+    check_keys(config, {"bits_per_key", "use_block_based_builder"}, "bloom filter config");
     bool use_block_based_builder = true;
-    const auto& ubbb = config.find("use_block_based_builder");
-    if (ubbb != config.end()) {
-        use_block_based_builder = ubbb.value().get<bool>();
-    }
+    get_if_present(config, "use_block_based_builder", use_block_based_builder);
     const auto bits_per_key = config["bits_per_key"].get<int>();
     return std::shared_ptr<const rocksdb::FilterPolicy>(
         rocksdb::NewBloomFilterPolicy(bits_per_key, use_block_based_builder));
@@ -225,6 +275,7 @@ static std::shared_ptr<const rocksdb::FilterPolicy> bloom_filter_policy(
  * get rocksdb filter policy config from JSON config
  */
 static std::shared_ptr<const rocksdb::FilterPolicy> filter_policy(const nlohmann::json& config) {
+    check_keys(config, {"type", "config"}, "filter policy");
     auto const type = config["type"].get<std::string>();
     if (type == "bloom") {
         return bloom_filter_policy(config["config"]);
@@ -232,6 +283,70 @@ static std::shared_ptr<const rocksdb::FilterPolicy> filter_policy(const nlohmann
     throw std::runtime_error("Unknown filter policy type=" + type);
 }
 
+/**
+ * Get the rocksdb index type of SST files from its name in JSON config
+ */
+static rocksdb::BlockBasedTableOptions::IndexType index_type(const std::string& name) {
+    if (name == "binary_search" || name == "binary") {
+        return rocksdb::BlockBasedTableOptions::kBinarySearch;
+    }
+    if (name == "hash_search" || name == "hash") {
+        return rocksdb::BlockBasedTableOptions::kHashSearch;
+    }
+    if (name == "two_level_index_search" || name == "two_level") {
+        return rocksdb::BlockBasedTableOptions::kTwoLevelIndexSearch;
+    }
+    throw std::runtime_error("Unknown index type: '" + name +
+                             "'. Expected either 'binary_search', 'hash_search' or "
+                             "'two_level_index_search'");
+}
+
+/**
+ * Get the rocksdb index type of data blocks from its name in JSON config
+ */
+static rocksdb::BlockBasedTableOptions::DataBlockIndexType data_block_index_type(
+    const std::string& name) {
+    if (name == "binary_search" || name == "binary") {
+        return rocksdb::BlockBasedTableOptions::kDataBlockBinarySearch;
+    }
+    if (name == "binary_and_hash" || name == "hash") {
+        return rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+    }
+    throw std::runtime_error("Unknown data block index type: '" + name +
+                             "'. Expected either 'binary_search' or 'binary_and_hash'");
+}
+
+/**
+ * Setup index of SST files and data blocks according to JSON config
+ */
+static void setup_table_index(const nlohmann::json& config,
+                              rocksdb::BlockBasedTableOptions& options) {
+    // configurations written by previous versions provide both index types
+    // in a single list: [index_type, data_block_index_type]
+    const auto legacy = config.find("index");
+    if (legacy != config.end()) {
+        const auto& types = legacy.value();
+        if (!types.is_array() || types.size() != 2) {
+            throw std::runtime_error(
+                "Expecting a list [index_type, data_block_index_type] for table 'index'");
+        }
+        options.index_type = index_type(types[0].get<std::string>());
+        options.data_block_index_type = data_block_index_type(types[1].get<std::string>());
+    }
+    const auto index = config.find("index_type");
+    if (index != config.end()) {
+        options.index_type = index_type(index.value().get<std::string>());
+    }
+    const auto data_block_index = config.find("data_block_index_type");
+    if (data_block_index != config.end()) {
+        options.data_block_index_type =
+            data_block_index_type(data_block_index.value().get<std::string>());
+    }
+    get_if_present(config,
+                   "data_block_hash_table_util_ratio",
+                   options.data_block_hash_table_util_ratio);
+}
+
 /**
  * Get the rocksdb block-based table factory (the only table factory supported actually)
  * from a JSON config
@@ -239,12 +354,55 @@ static std::shared_ptr<const rocksdb::FilterPolicy> filter_policy(const nlohmann
 static std::shared_ptr<rocksdb::TableFactory> block_based_table_factory(
     const nlohmann::json& config,
     std::shared_ptr<rocksdb::Cache> global_block_cache) {
+    check_keys(config,
+               {"block_cache",
+                "filter_policy",
+                "filter-policy",
+                "whole_key_filtering",
+                "partition_filters",
+                "index",
+                "index_type",
+                "data_block_index_type",
+                "data_block_hash_table_util_ratio",
+                "cache_index_and_filter_blocks",
+                "cache_index_and_filter_blocks_with_high_priority",
+                "pin_l0_filter_and_index_blocks_in_cache",
+                "pin_top_level_index_and_filter",
+                "block_size",
+                "block_restart_interval",
+                "metadata_block_size",
+                "format_version"},
+               "block-based table config");
     rocksdb::BlockBasedTableOptions options;
     options.block_cache = block_cache_if_present(config, global_block_cache);
-    auto const& fpc = config.find("filter_policy");
-    if (fpc != config.end()) {
-        options.filter_policy = filter_policy(fpc.value());
+    // "filter-policy" is the spelling used by configurations written by previous versions
+    for (const auto key: {"filter_policy", "filter-policy"}) {
+        auto const& fpc = config.find(key);
+        if (fpc != config.end()) {
+            options.filter_policy = filter_policy(fpc.value());
+        }
     }
+    get_if_present(config, "whole_key_filtering", options.whole_key_filtering);
+    get_if_present(config, "partition_filters", options.partition_filters);
+    setup_table_index(config, options);
+    if (options.partition_filters &&
+        options.index_type != rocksdb::BlockBasedTableOptions::kTwoLevelIndexSearch) {
+        throw std::runtime_error("Partitioned filters require 'two_level_index_search' index type");
+    }
+    get_if_present(config, "cache_index_and_filter_blocks", options.cache_index_and_filter_blocks);
+    get_if_present(config,
+                   "cache_index_and_filter_blocks_with_high_priority",
+                   options.cache_index_and_filter_blocks_with_high_priority);
+    get_if_present(config,
+                   "pin_l0_filter_and_index_blocks_in_cache",
+                   options.pin_l0_filter_and_index_blocks_in_cache);
+    get_if_present(config,
+                   "pin_top_level_index_and_filter",
+                   options.pin_top_level_index_and_filter);
+    get_if_present(config, "block_size", options.block_size);
+    get_if_present(config, "block_restart_interval", options.block_restart_interval);
+    get_if_present(config, "metadata_block_size", options.metadata_block_size);
+    get_if_present(config, "format_version", options.format_version);
     return std::shared_ptr<rocksdb::TableFactory>(rocksdb::NewBlockBasedTableFactory(options));
 }
 
@@ -310,6 +468,45 @@ static void setup_max_open_files(const nlohmann::json& config, rocksdb::Options&
     }
 }
 
+/**
+ * Setup the manager accounting for the memory of all memtables according to JSON config
+ * \param config JSON config
+ * \param global_block_cache the block cache declared at top-level of the JSON config
+ * \param options RocksDB configuration to update
+ */
+static void setup_write_buffer_manager(const nlohmann::json& config,
+                                       const std::shared_ptr<rocksdb::Cache>& global_block_cache,
+                                       rocksdb::Options& options) {
+    auto const& wbm = config.find("write_buffer_manager");
+    if (wbm == config.end()) {
+        return;
+    }
+    const auto& wbm_config = wbm.value();
+    check_keys(wbm_config,
+               {"name", "buffer_size", "charge_block_cache"},
+               "write buffer manager config");
+    const auto buffer_size = capacity_from_json(wbm_config["buffer_size"]);
+    bool charge_block_cache = true;
+    get_if_present(wbm_config, "charge_block_cache", charge_block_cache);
+    std::shared_ptr<rocksdb::Cache> cache;
+    if (charge_block_cache) {
+        if (global_block_cache == nullptr) {
+            throw std::runtime_error("Global block cache is undefined");
+        }
+        cache = global_block_cache;
+    }
+    const auto name = wbm_config.find("name");
+    if (name != wbm_config.end()) {
+        options.write_buffer_manager =
+            MemoryRegistry::write_buffer_manager(name.value().get<std::string>(),
+                                                 buffer_size,
+                                                 cache);
+    } else {
+        options.write_buffer_manager =
+            std::make_shared<rocksdb::WriteBufferManager>(buffer_size, cache);
+    }
+}
+
 static void setup_create_if_missing(const nlohmann::json& config, rocksdb::Options& options) {
     {
         auto const& value = config.find("create_if_missing");
@@ -344,14 +541,23 @@ static nlohmann::json default_json() {
     config["max_open_files"] = -1;
     config["create_if_missing"] = true;
     config["create_missing_column_families"] = true;
+    config["key_format"] = static_cast<int>(GraphKV::key_format_version);
+    config["edge_storage"] = "keys";
+    config["edge_payloads"] = "canonical";
     // clang-format off
     config["block_cache"] = {
         {"type", "lru"},
+        {"name", "basalt"},
         {"config", {
             {"capacity", 1u << 30u /* 1GB */},
             {"num_shard_bits", 4}
         }}
     };
+    config["write_buffer_manager"] = {
+        {"name", "basalt"},
+        {"buffer_size", 512u << 20u /* 512MB */},
+        {"charge_block_cache", true}
+    };
     config["compression"] = {
         {"type", "snappy"}
     };
@@ -394,19 +600,20 @@ static nlohmann::json default_json() {
                     {"type", "block-based"},
                     {"config", {
                         {"block_cache", {
-                            {"type", "lru"},
-                            {"config", {
-                                {"capacity", "10%"}
-                            }}
+                            {"type", "global"}
                         }},
-                        {"filter-policy", {
+                        {"filter_policy", {
                             {"type", "bloom"},
                             {"config", {
                                 {"bits_per_key", 10},
                                 {"use_block_based_builder", true},
                             }}
                         }},
-                        {"index", {"binary", "hash"}},
+                        {"whole_key_filtering", true},
+                        {"index_type", "binary_search"},
+                        {"data_block_index_type", "binary_and_hash"},
+                        {"cache_index_and_filter_blocks", true},
+                        {"pin_l0_filter_and_index_blocks_in_cache", true},
                         {"block_size", 4096}
                     }}
                 }}
@@ -427,6 +634,19 @@ static nlohmann::json from_stream(std::ifstream& istr) {
     return config;
 }
 
+/**
+ * Set the key format of a JSON config if not specified
+ * \param config JSON config to update
+ * \param key_format version of the key encoding to use if not specified
+ * \return the updated JSON config
+ */
+static nlohmann::json with_key_format(nlohmann::json config, int key_format) {
+    if (config.find("key_format") == config.end()) {
+        config["key_format"] = key_format;
+    }
+    return config;
+}
+
 /**
  * Read configuration file if present in database path, provides
  * default configuration otherwise.
@@ -438,7 +658,9 @@ static nlohmann::json from_db_path(const std::string& db_path) {
     std::ifstream istr;
     istr.open(json_file);
     if (istr.is_open()) {
-        return from_stream(istr);
+        // databases written before the key format was versioned
+        // do not have this entry
+        return with_key_format(from_stream(istr), GraphKV::legacy_key_format);
     }
     return default_json();
 }
@@ -450,16 +672,22 @@ Config::Config()
     : config_(default_json()) {}
 
 Config::Config(std::ifstream& istr)
-    : config_(from_stream(istr)) {}
+    : config_(with_key_format(from_stream(istr), GraphKV::key_format_version)) {}
 
 void Config::configure(rocksdb::Options& options) const {
     setup_statistics(config_, options);
     setup_max_open_files(config_, options);
     setup_create_if_missing(config_, options);
     setup_compression(config_, options);
+    setup_write_buffer_manager(config_, global_block_cache(), options);
+}
 
-    std::shared_ptr<rocksdb::Cache> empty;
-    auto global_block_cache = block_cache_if_present(config_, empty);
+std::shared_ptr<rocksdb::Cache> Config::global_block_cache() const {
+    if (global_block_cache_ == nullptr) {
+        std::shared_ptr<rocksdb::Cache> empty;
+        global_block_cache_ = block_cache_if_present(config_, empty);
+    }
+    return global_block_cache_;
 }
 
 std::ostream& Config::write(std::ostream& ostr, std::streamsize indent) const {
@@ -467,15 +695,47 @@ std::ostream& Config::write(std::ostream& ostr, std::streamsize indent) const {
     return ostr << std::setw(static_cast<int>(indent)) << config_ << std::setw(width);
 }
 
+/**
+ * Find a column family descriptor by name
+ */
+static std::vector<rocksdb::ColumnFamilyDescriptor>::iterator find_column_family(
+    std::vector<rocksdb::ColumnFamilyDescriptor>& cfd,
+    const std::string& name) {
+    return std::find_if(cfd.begin(),
+                        cfd.end(),
+                        [&name](const rocksdb::ColumnFamilyDescriptor& descriptor) {
+                            return descriptor.name == name;
+                        });
+}
+
 std::vector<rocksdb::ColumnFamilyDescriptor> Config::column_families() const {
     std::vector<rocksdb::ColumnFamilyDescriptor> cfd;
-    std::shared_ptr<rocksdb::Cache> empty;
-    auto global_block_cache = block_cache_if_present(config_, empty);
+    auto global_block_cache = this->global_block_cache();
     for (auto const& cf_config: config_["column_families"]) {
         auto const& name = column_family_name(cf_config["name"]);
         auto const& cf_options = column_families_options(cf_config["config"], global_block_cache);
         cfd.emplace_back(name, cf_options);
     }
+    if (packed_edges()) {
+        auto adjacency = find_column_family(cfd, "adjacency");
+        if (adjacency == cfd.end()) {
+            // adjacency keys share the prefix length of edges keys
+            const auto edges = find_column_family(cfd, "edges");
+            if (edges == cfd.end()) {
+                throw std::runtime_error("Missing 'edges' column family in configuration");
+            }
+            const auto options = edges->options;
+            cfd.emplace_back("adjacency", options);
+            adjacency = std::prev(cfd.end());
+        }
+        adjacency->options.merge_operator = std::make_shared<AdjacencyMergeOperator>();
+    }
+    auto meta = find_column_family(cfd, "meta");
+    if (meta == cfd.end()) {
+        cfd.emplace_back("meta", rocksdb::ColumnFamilyOptions());
+        meta = std::prev(cfd.end());
+    }
+    meta->options.merge_operator = std::make_shared<CounterMergeOperator>();
     return cfd;
 }
 
@@ -488,6 +748,43 @@ bool Config::read_only() const {
     return read_only;
 }
 
+bool Config::packed_edges() const {
+    auto config = config_.find("edge_storage");
+    if (config == config_.end()) {
+        return false;
+    }
+    const auto storage = config.value().get<std::string>();
+    if (storage == "packed") {
+        return true;
+    }
+    if (storage != "keys") {
+        throw std::runtime_error("Unknown edge storage: '" + storage +
+                                 "'. Expected either 'keys' or 'packed'");
+    }
+    return false;
+}
+
+bool Config::canonical_edge_payloads() const {
+    auto config = config_.find("edge_payloads");
+    if (config == config_.end()) {
+        // databases created before this option write payloads under both keys
+        return false;
+    }
+    const auto payloads = config.value().get<std::string>();
+    if (payloads == "canonical") {
+        return true;
+    }
+    if (payloads != "both") {
+        throw std::runtime_error("Unknown edge payloads storage: '" + payloads +
+                                 "'. Expected either 'both' or 'canonical'");
+    }
+    return false;
+}
+
+int Config::key_format() const {
+    return config_["key_format"].get<int>();
+}
+
 bool Config::operator==(const Config& other) const {
     return config_ == other.config_;
 }
@@ -6,6 +6,8 @@
  *************************************************************************/
 #pragma once
 
+#include <memory>
+
 #include <nlohmann/json.hpp>
 #include <rocksdb/db.h>
 
@@ -73,8 +75,32 @@ class Config {
      */
     bool read_only() const;
 
+    /**
+     * \return true if edges are stored as packed adjacency lists, one value per
+     * vertex and neighbour type, rather than one key per edge.
+     */
+    bool packed_edges() const;
+
+    /**
+     * \return true if the payload of an undirected edge is only stored under
+     * its canonical key, the one starting with the smaller vertex, rather than
+     * under both keys of the edge.
+     */
+    bool canonical_edge_payloads() const;
+
+    /**
+     * \return version of the encoding of the keys in the database
+     */
+    int key_format() const;
+
   private:
+    /**
+     * \return the block cache declared at top-level of the JSON config, created once
+     */
+    std::shared_ptr<rocksdb::Cache> global_block_cache() const;
+
     const nlohmann::json config_;
+    mutable std::shared_ptr<rocksdb::Cache> global_block_cache_;
 };
 
 std::ostream& operator<<(std::ostream& ostr, const Config& config);
@@ -0,0 +1,134 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <climits>
+
+#include <rocksdb/write_batch.h>
+
+#include "counters.hpp"
+#include "graph_kv.hpp"
+
+namespace basalt {
+
+void Counters::add(const Counters& other) {
+    for (const auto& counter: other.vertices_) {
+        vertices_[counter.first] += counter.second;
+    }
+    for (const auto& counter: other.edges_) {
+        edges_[counter.first] += counter.second;
+    }
+}
+
+std::int64_t Counters::vertices(vertex_t type) const {
+    const auto counter = vertices_.find(type);
+    return counter == vertices_.end() ? 0 : counter->second;
+}
+
+std::int64_t Counters::vertices() const {
+    std::int64_t result = 0;
+    for (const auto& counter: vertices_) {
+        result += counter.second;
+    }
+    return result;
+}
+
+std::int64_t Counters::edges(vertex_t head, vertex_t tail) const {
+    const auto counter = edges_.find(std::make_pair(head, tail));
+    return counter == edges_.end() ? 0 : counter->second;
+}
+
+std::int64_t Counters::edges() const {
+    std::int64_t result = 0;
+    for (const auto& counter: edges_) {
+        result += counter.second;
+    }
+    return result;
+}
+
+void Counters::merge(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* column) const {
+    std::string value;
+    GraphKV::vertex_counter_key_t vertex_key;
+    for (const auto& counter: vertices_) {
+        if (counter.second != 0) {
+            GraphKV::encode_vertex_counter(counter.first, vertex_key);
+            encode_value(counter.second, value);
+            batch.Merge(column, rocksdb::Slice(vertex_key.data(), vertex_key.size()), value);
+        }
+    }
+    GraphKV::edge_counter_key_t edge_key;
+    for (const auto& counter: edges_) {
+        if (counter.second != 0) {
+            GraphKV::encode_edge_counter(counter.first.first, counter.first.second, edge_key);
+            encode_value(counter.second, value);
+            batch.Merge(column, rocksdb::Slice(edge_key.data(), edge_key.size()), value);
+        }
+    }
+}
+
+void Counters::put(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* column) const {
+    std::string value;
+    GraphKV::vertex_counter_key_t vertex_key;
+    for (const auto& counter: vertices_) {
+        GraphKV::encode_vertex_counter(counter.first, vertex_key);
+        encode_value(counter.second, value);
+        batch.Put(column, rocksdb::Slice(vertex_key.data(), vertex_key.size()), value);
+    }
+    GraphKV::edge_counter_key_t edge_key;
+    for (const auto& counter: edges_) {
+        GraphKV::encode_edge_counter(counter.first.first, counter.first.second, edge_key);
+        encode_value(counter.second, value);
+        batch.Put(column, rocksdb::Slice(edge_key.data(), edge_key.size()), value);
+    }
+}
+
+void Counters::encode_value(std::int64_t value, std::string& data) {
+    auto bits = static_cast<std::uint64_t>(value);
+    data.resize(sizeof(bits));
+    for (auto i = 0ul; i < sizeof(bits); ++i) {
+        data[i] = static_cast<char>(bits & 0xffu);
+        bits >>= CHAR_BIT;
+    }
+}
+
+bool Counters::decode_value(const char* data, std::size_t size, std::int64_t& value) {
+    std::uint64_t bits = 0;
+    if (size != sizeof(bits)) {
+        return false;
+    }
+    for (auto i = sizeof(bits); i > 0; --i) {
+        bits = (bits << CHAR_BIT) | static_cast<unsigned char>(data[i - 1]);
+    }
+    value = static_cast<std::int64_t>(bits);
+    return true;
+}
+
+rocksdb::Slice Counters::initialized_key() {
+    return "counters";
+}
+
+bool CounterMergeOperator::Merge(const rocksdb::Slice& /*key*/,
+                                 const rocksdb::Slice* existing_value,
+                                 const rocksdb::Slice& value,
+                                 std::string* new_value,
+                                 rocksdb::Logger* /*logger*/) const {
+    std::int64_t existing = 0;
+    if (existing_value != nullptr &&
+        !Counters::decode_value(existing_value->data(), existing_value->size(), existing)) {
+        return false;
+    }
+    std::int64_t delta;
+    if (!Counters::decode_value(value.data(), value.size(), delta)) {
+        return false;
+    }
+    Counters::encode_value(existing + delta, *new_value);
+    return true;
+}
+
+const char* CounterMergeOperator::Name() const {
+    return "basalt.CounterMergeOperator";
+}
+
+}  // namespace basalt
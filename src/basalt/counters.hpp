@@ -0,0 +1,96 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+#include <rocksdb/merge_operator.h>
+
+#include <basalt/fwd.hpp>
+
+#include "fwd.hpp"
+
+namespace basalt {
+
+/**
+ * Number of vertices per type and number of edges per pair of vertex types.
+ *
+ * Counters are stored in the "meta" column family as 64-bit signed integers.
+ * An instance of this class accumulates the variations caused by a set of
+ * insertions and removals so that they can be written as merge operands in
+ * the same \a rocksdb::WriteBatch than the modified vertices and edges.
+ */
+class Counters {
+  public:
+    /// \brief record the insertion (positive delta) or removal of vertices
+    inline void add_vertices(vertex_t type, std::int64_t delta) {
+        vertices_[type] += delta;
+    }
+
+    /// \brief record the insertion (positive delta) or removal of edges
+    inline void add_edges(vertex_t head, vertex_t tail, std::int64_t delta) {
+        edges_[std::make_pair(head, tail)] += delta;
+    }
+
+    /// \brief accumulate the variations recorded by another instance
+    void add(const Counters& other);
+
+    /// \return number of vertices of the given type
+    std::int64_t vertices(vertex_t type) const;
+    /// \return number of vertices
+    std::int64_t vertices() const;
+    /// \return number of edges between vertices of the given types
+    std::int64_t edges(vertex_t head, vertex_t tail) const;
+    /// \return number of edges
+    std::int64_t edges() const;
+
+    /**
+     * \brief write the recorded variations as merge operands
+     * \param batch where operands are written
+     * \param column handle of the "meta" column family
+     */
+    void merge(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* column) const;
+
+    /**
+     * \brief overwrite counters with the recorded values
+     * \param batch where values are written
+     * \param column handle of the "meta" column family
+     */
+    void put(rocksdb::WriteBatch& batch, rocksdb::ColumnFamilyHandle* column) const;
+
+    static void encode_value(std::int64_t value, std::string& data);
+    static bool decode_value(const char* data, std::size_t size, std::int64_t& value);
+
+    /**
+     * \return key of the "meta" column family written when counters are
+     * in sync with the vertices and edges of the database
+     */
+    static rocksdb::Slice initialized_key();
+
+  private:
+    std::map<vertex_t, std::int64_t> vertices_;
+    std::map<std::pair<vertex_t, vertex_t>, std::int64_t> edges_;
+};
+
+/**
+ * RocksDB merge operator adding signed 64-bit integers
+ */
+class CounterMergeOperator: public rocksdb::AssociativeMergeOperator {
+  public:
+    bool Merge(const rocksdb::Slice& key,
+               const rocksdb::Slice* existing_value,
+               const rocksdb::Slice& value,
+               std::string* new_value,
+               rocksdb::Logger* logger) const override;
+
+    const char* Name() const override;
+};
+
+}  // namespace basalt
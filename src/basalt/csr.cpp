@@ -0,0 +1,202 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+#include <basalt/csr.hpp>
+
+#include "thread_pool.hpp"
+
+namespace basalt {
+
+/// number of ranges of vertices per thread, to balance vertices of high degree
+static constexpr std::size_t ranges_per_thread = 8;
+
+/**
+ * \brief call a function on consecutive ranges of [0, count) on the workers of a pool
+ * \param function called with the index of the range, its first and last positions
+ * \return number of ranges
+ */
+static std::size_t parallel_ranges(
+    ThreadPool& pool,
+    std::size_t count,
+    const std::function<void(std::size_t, std::size_t, std::size_t)>& function) {
+    const auto num_ranges = std::max(1ul, std::min(count, pool.size() * ranges_per_thread));
+    const auto range_size = (count + num_ranges - 1) / num_ranges;
+    pool.parallel_for(num_ranges, [&](std::size_t range) {
+        const auto first = std::min(count, range * range_size);
+        function(range, first, std::min(count, first + range_size));
+    });
+    return num_ranges;
+}
+
+std::int64_t CSR::index(const vertex_uid_t& vertex) const {
+    const auto type_range = std::equal_range(types.begin(), types.end(), vertex.first);
+    const auto first = ids.begin() + (type_range.first - types.begin());
+    const auto last = ids.begin() + (type_range.second - types.begin());
+    const auto id = std::lower_bound(first, last, vertex.second);
+    if (id == last || *id != vertex.second) {
+        return -1;
+    }
+    return static_cast<std::int64_t>(id - ids.begin());
+}
+
+void CSR::connected_components(std::vector<std::int64_t>& components,
+                               std::size_t num_threads) const {
+    const auto count = num_vertices();
+    // a parent always has a smaller index than its children, so that roots
+    // are the smallest index of their component and links never form cycles
+    std::vector<std::atomic<std::int64_t>> parents(count);
+    const auto find = [&parents](std::int64_t vertex) {
+        while (true) {
+            auto parent = parents[static_cast<std::size_t>(vertex)].load();
+            if (parent == vertex) {
+                return vertex;
+            }
+            const auto grand_parent = parents[static_cast<std::size_t>(parent)].load();
+            if (grand_parent != parent) {
+                // path halving, another thread may have already shortened it
+                parents[static_cast<std::size_t>(vertex)].compare_exchange_weak(parent,
+                                                                                grand_parent);
+            }
+            vertex = grand_parent;
+        }
+    };
+    const auto unite = [&parents, &find](std::int64_t lhs, std::int64_t rhs) {
+        while (true) {
+            lhs = find(lhs);
+            rhs = find(rhs);
+            if (lhs == rhs) {
+                return;
+            }
+            if (lhs < rhs) {
+                std::swap(lhs, rhs);
+            }
+            auto expected = lhs;
+            if (parents[static_cast<std::size_t>(lhs)].compare_exchange_strong(expected, rhs)) {
+                return;
+            }
+        }
+    };
+
+    ThreadPool pool(num_threads);
+    parallel_ranges(pool, count, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (auto vertex = first; vertex < last; ++vertex) {
+            parents[vertex].store(static_cast<std::int64_t>(vertex));
+        }
+    });
+    parallel_ranges(pool, count, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (auto vertex = first; vertex < last; ++vertex) {
+            const auto source = static_cast<std::int64_t>(vertex);
+            for (auto edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge) {
+                unite(source, indices[static_cast<std::size_t>(edge)]);
+            }
+        }
+    });
+    components.resize(count);
+    parallel_ranges(pool, count, [&](std::size_t, std::size_t first, std::size_t last) {
+        for (auto vertex = first; vertex < last; ++vertex) {
+            components[vertex] = find(static_cast<std::int64_t>(vertex));
+        }
+    });
+}
+
+std::size_t CSR::pagerank(std::vector<double>& ranks,
+                          double damping,
+                          double tolerance,
+                          std::size_t max_iterations,
+                          std::size_t num_threads) const {
+    const auto count = num_vertices();
+    if (count == 0) {
+        ranks.clear();
+        return 0;
+    }
+    const auto uniform = 1. / static_cast<double>(count);
+    ranks.assign(count, uniform);
+
+    // ranks are pulled from the sources of the incoming edges
+    std::vector<std::int64_t> in_offsets(count + 1);
+    for (const auto target: indices) {
+        ++in_offsets[static_cast<std::size_t>(target) + 1];
+    }
+    std::partial_sum(in_offsets.begin(), in_offsets.end(), in_offsets.begin());
+    std::vector<std::int64_t> in_indices(indices.size());
+    {
+        std::vector<std::int64_t> positions(in_offsets.begin(), in_offsets.end() - 1);
+        for (auto vertex = 0ul; vertex < count; ++vertex) {
+            for (auto edge = offsets[vertex]; edge < offsets[vertex + 1]; ++edge) {
+                const auto target = indices[static_cast<std::size_t>(edge)];
+                auto& position = positions[static_cast<std::size_t>(target)];
+                in_indices[static_cast<std::size_t>(position++)] =
+                    static_cast<std::int64_t>(vertex);
+            }
+        }
+    }
+
+    ThreadPool pool(num_threads);
+    std::vector<double> contributions(count);
+    std::vector<double> next(count);
+    // partial sums of every range, reduced in order so that results are reproducible
+    std::vector<double> partials(pool.size() * ranges_per_thread);
+    const auto reduce = [&partials](std::size_t num_ranges) {
+        return std::accumulate(partials.begin(),
+                               partials.begin() + static_cast<std::ptrdiff_t>(num_ranges),
+                               0.);
+    };
+    std::size_t iteration = 0;
+    while (iteration < max_iterations) {
+        ++iteration;
+        auto num_ranges = parallel_ranges(pool, count, [&](std::size_t range,
+                                                           std::size_t first,
+                                                           std::size_t last) {
+            double dangling = 0;
+            for (auto vertex = first; vertex < last; ++vertex) {
+                const auto degree = offsets[vertex + 1] - offsets[vertex];
+                if (degree == 0) {
+                    contributions[vertex] = 0;
+                    dangling += ranks[vertex];
+                } else {
+                    contributions[vertex] = ranks[vertex] / static_cast<double>(degree);
+                }
+            }
+            partials[range] = dangling;
+        });
+        const auto base = (1. - damping) * uniform + damping * reduce(num_ranges) * uniform;
+        num_ranges = parallel_ranges(pool, count, [&](std::size_t range,
+                                                      std::size_t first,
+                                                      std::size_t last) {
+            double change = 0;
+            for (auto vertex = first; vertex < last; ++vertex) {
+                double sum = 0;
+                for (auto edge = in_offsets[vertex]; edge < in_offsets[vertex + 1]; ++edge) {
+                    sum += contributions[static_cast<std::size_t>(
+                        in_indices[static_cast<std::size_t>(edge)])];
+                }
+                next[vertex] = base + damping * sum;
+                change += std::fabs(next[vertex] - ranks[vertex]);
+            }
+            partials[range] = change;
+        });
+        ranks.swap(next);
+        if (reduce(num_ranges) < tolerance) {
+            break;
+        }
+    }
+    return iteration;
+}
+
+void CSR::clear() {
+    std::vector<vertex_t>().swap(types);
+    std::vector<vertex_id_t>().swap(ids);
+    std::vector<std::int64_t>().swap(offsets);
+    std::vector<std::int64_t>().swap(indices);
+}
+
+}  // namespace basalt
@@ -22,11 +22,22 @@ EdgeIterator::EdgeIterator(const basalt::GraphImpl<Orientation>& pimpl, size_t f
     }
 }
 
+template <EdgeOrientation Orientation>
+EdgeIterator::EdgeIterator(const basalt::GraphImpl<Orientation>& pimpl, const edge_uid_t& from)
+    : pimpl_(pimpl.edge_iterator(from)) {}
+
 // Explicit instantiation
 template EdgeIterator::EdgeIterator(const basalt::GraphImpl<EdgeOrientation::directed>& pimpl,
                                     size_t from);
 template EdgeIterator::EdgeIterator(const basalt::GraphImpl<EdgeOrientation::undirected>& pimpl,
                                     size_t from);
+template EdgeIterator::EdgeIterator(const basalt::GraphImpl<EdgeOrientation::directed>& pimpl,
+                                    const edge_uid_t& from);
+template EdgeIterator::EdgeIterator(const basalt::GraphImpl<EdgeOrientation::undirected>& pimpl,
+                                    const edge_uid_t& from);
+
+EdgeIterator::EdgeIterator(std::shared_ptr<EdgeIteratorImpl> pimpl)
+    : pimpl_(std::move(pimpl)) {}
 
 EdgeIterator::EdgeIterator(const basalt::EdgeIterator& other)
     : pimpl_(other.pimpl_) {}
@@ -62,4 +73,11 @@ const EdgeIterator::value_type& EdgeIterator::operator*() {
     return **pimpl_;
 }
 
+std::string EdgeIterator::token() const {
+    if (!pimpl_) {
+        return {};
+    }
+    return pimpl_->token();
+}
+
 }  // namespace basalt
@@ -6,21 +6,66 @@
  *************************************************************************/
 #include "edge_iterator_impl.hpp"
 
+#include <algorithm>
+
 #include <rocksdb/db.h>
 #include <rocksdb/slice_transform.h>
 
+#include "adjacency.hpp"
 #include "graph_impl.hpp"
 #include "graph_kv.hpp"
 
 namespace basalt {
 
-EdgeIteratorImpl::EdgeIteratorImpl(const basalt::db_t& db,
-                                   rocksdb::ColumnFamilyHandle* edges,
-                                   const std::string& /*prefix*/,
-                                   std::size_t position)
-    : position_(position) {
-    iter_ = db->NewIterator(rocksdb::ReadOptions(), edges);
+EdgeIteratorImpl::EdgeIteratorImpl(ManagedIterator iterator,
+                                   std::size_t position,
+                                   bool packed,
+                                   bool canonical)
+    : iter_(std::move(iterator))
+    , position_(position)
+    , packed_(packed)
+    , canonical_(canonical)
+    , type_()
+    , index_() {
     iter_->SeekToFirst();
+    if (packed_) {
+        load_adjacency();
+    }
+    skip_reverse();
+    check_valid();
+}
+
+EdgeIteratorImpl::EdgeIteratorImpl(ManagedIterator iterator, const edge_uid_t& from, bool packed)
+    : iter_(std::move(iterator))
+    , position_()
+    , packed_(packed)
+    , canonical_(false)
+    , type_()
+    , index_() {
+    if (packed_) {
+        GraphKV::adjacency_key_t key;
+        GraphKV::encode_adjacency(from.first, from.second.first, key);
+        const rocksdb::Slice slice(key.data(), key.size());
+        iter_->Seek(slice);
+        load_adjacency();
+        // skip the neighbours before the requested one in its adjacency list
+        if (iter_->Valid() && iter_->key() == slice) {
+            index_ = static_cast<std::size_t>(
+                std::lower_bound(ids_.begin(), ids_.end(), from.second.second) - ids_.begin());
+            if (index_ == ids_.size()) {
+                iter_->Next();
+                load_adjacency();
+            }
+        }
+    } else {
+        GraphKV::edge_key_t key;
+        GraphKV::encode(from.first, from.second, key);
+        iter_->Seek(rocksdb::Slice(key.data(), key.size()));
+    }
+    check_valid();
+}
+
+void EdgeIteratorImpl::check_valid() {
     if (!iter_->Valid()) {
         position_ = std::numeric_limits<std::size_t>::max();
     }
@@ -28,12 +73,79 @@ EdgeIteratorImpl::EdgeIteratorImpl(const basalt::db_t& db,
 }
 
 bool EdgeIteratorImpl::operator==(const basalt::EdgeIteratorImpl& other) const {
-    return this->iter_ == other.iter_ and this->position_ == other.position_;
+    return this->iter_.get() == other.iter_.get() and this->position_ == other.position_;
 }
 
 
+void EdgeIteratorImpl::load_adjacency() {
+    index_ = 0;
+    ids_.clear();
+    while (iter_->Valid()) {
+        const auto& value = iter_->value();
+        AdjacencyList::decode(value.data(), value.size(), ids_);
+        if (!ids_.empty()) {
+            const auto& key = iter_->key();
+            GraphKV::decode_adjacency(key.data(), key.size(), vertex_, type_);
+            return;
+        }
+        iter_->Next();
+    }
+}
+
+void EdgeIteratorImpl::skip_reverse() {
+    if (!canonical_) {
+        return;
+    }
+    // neighbours are sorted, so the reverse edges of a vertex come first and
+    // can be skipped with a single seek
+    if (packed_) {
+        while (iter_->Valid()) {
+            if (type_ > vertex_.first) {
+                return;
+            }
+            if (type_ == vertex_.first) {
+                index_ = static_cast<std::size_t>(
+                    std::lower_bound(ids_.begin() + static_cast<std::ptrdiff_t>(index_),
+                                     ids_.end(),
+                                     vertex_.second) -
+                    ids_.begin());
+                if (index_ < ids_.size()) {
+                    return;
+                }
+                iter_->Next();
+            } else {
+                GraphKV::adjacency_key_t key;
+                GraphKV::encode_adjacency(vertex_, vertex_.first, key);
+                iter_->Seek(rocksdb::Slice(key.data(), key.size()));
+            }
+            load_adjacency();
+        }
+    } else {
+        while (iter_->Valid()) {
+            const auto& slice = iter_->key();
+            GraphKV::decode_edge(slice.data(), slice.size(), value);
+            if (!(value.second < value.first)) {
+                return;
+            }
+            GraphKV::edge_key_t key;
+            GraphKV::encode(value.first, value.first, key);
+            iter_->Seek(rocksdb::Slice(key.data(), key.size()));
+        }
+    }
+}
+
 EdgeIteratorImpl& EdgeIteratorImpl::operator++() {
-    iter_->Next();
+    if (packed_) {
+        if (++index_ < ids_.size()) {
+            ++position_;
+            return *this;
+        }
+        iter_->Next();
+        load_adjacency();
+    } else {
+        iter_->Next();
+    }
+    skip_reverse();
     if (!iter_->Valid()) {
         position_ = std::numeric_limits<std::size_t>::max();
     } else {
@@ -47,6 +159,11 @@ bool EdgeIteratorImpl::operator!=(const EdgeIteratorImpl& other) const {
 }
 
 const EdgeIteratorImpl::value_type& EdgeIteratorImpl::operator*() {
+    if (packed_) {
+        value.first = vertex_;
+        value.second = make_id(type_, ids_[index_]);
+        return value;
+    }
     auto const& slice = iter_->key();
     GraphKV::decode_edge(slice.data(), slice.size(), value);
     return value;
@@ -56,4 +173,16 @@ bool EdgeIteratorImpl::end_reached() const {
     return position_ == std::numeric_limits<std::size_t>::max();
 }
 
+std::string EdgeIteratorImpl::token() const {
+    if (end_reached()) {
+        return {};
+    }
+    if (packed_) {
+        GraphKV::edge_key_t key;
+        GraphKV::encode(vertex_, make_id(type_, ids_[index_]), key);
+        return {key.data(), key.size()};
+    }
+    return iter_->key().ToString();
+}
+
 }  // namespace basalt
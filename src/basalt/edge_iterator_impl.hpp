@@ -7,20 +7,35 @@
 #pragma once
 
 #include <type_traits>
+#include <vector>
 
 #include <basalt/edge_iterator.hpp>
 
 #include "fwd.hpp"
+#include "iterator_pool.hpp"
 
 namespace basalt {
 
 class EdgeIteratorImpl {
   public:
     using value_type = EdgeIterator::value_type;
-    explicit EdgeIteratorImpl(const db_t& db,
-                              rocksdb::ColumnFamilyHandle* edges,
-                              const std::string& prefix,
-                              std::size_t position);
+    /**
+     * \param iterator iterator over the edges or adjacency column family
+     * \param position index of the first edge
+     * \param packed true if \a iterator visits the column family of adjacency lists
+     * \param canonical true to skip the edges whose target is lower than their source,
+     * so that every edge of an undirected graph is visited once
+     */
+    EdgeIteratorImpl(ManagedIterator iterator,
+                     std::size_t position,
+                     bool packed,
+                     bool canonical = false);
+    /**
+     * \param iterator iterator over the edges or adjacency column family
+     * \param from first edge to visit, or the next one if missing
+     * \param packed true if \a iterator visits the column family of adjacency lists
+     */
+    EdgeIteratorImpl(ManagedIterator iterator, const edge_uid_t& from, bool packed);
 
     inline std::size_t position_get() const {
         return position_;
@@ -33,10 +48,28 @@ class EdgeIteratorImpl {
 
     bool end_reached() const;
 
+    /// \return the key of the current edge
+    std::string token() const;
+
   private:
-    rocksdb::Iterator* iter_;
+    /// \brief mark the end of the iteration if the underlying iterator is exhausted
+    void check_valid();
+
+    /// skip empty adjacency lists and decode the current one
+    void load_adjacency();
+
+    /// \brief in canonical mode, seek past the edges whose target is lower than their source
+    void skip_reverse();
+
+    ManagedIterator iter_;
     std::size_t position_;
     std::remove_const<value_type>::type value;
+    const bool packed_;
+    const bool canonical_;
+    vertex_uid_t vertex_;
+    vertex_t type_;
+    std::vector<vertex_id_t> ids_;
+    std::size_t index_;
 };
 
 }  // namespace basalt
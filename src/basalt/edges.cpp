@@ -4,11 +4,14 @@
  * This file is part of Basalt distributed under the terms of the GNU
  * Lesser General Public License. See top-level LICENSE file for details.
  *************************************************************************/
+#include <stdexcept>
+
 #include <basalt/edges.hpp>
 
 #include <basalt/edge_iterator.hpp>
 
 #include "graph_impl.hpp"
+#include "graph_kv.hpp"
 
 
 namespace basalt {
@@ -87,6 +90,11 @@ Status Edges<Orientation>::get(const edge_uid_t& edge, std::string* value) const
     return pimpl_.edges_get(edge, value);
 }
 
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::get(const edge_uid_t& edge, PayloadView& value) const {
+    return pimpl_.edges_get(edge, value);
+}
+
 template <EdgeOrientation Orientation>
 Status Edges<Orientation>::get(const vertex_uid_t& vertex,
                                vertex_t filter,
@@ -94,6 +102,81 @@ Status Edges<Orientation>::get(const vertex_uid_t& vertex,
     return pimpl_.edges_get(vertex, filter, edges);
 }
 
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::get(const vertex_uid_t& vertex,
+                               vertex_t filter,
+                               vertex_id_t first,
+                               vertex_id_t last,
+                               vertex_uids_t& edges) const {
+    return pimpl_.edges_get(vertex, filter, first, last, edges);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::get(const vertex_uid_t& vertex,
+                               vertex_t filter,
+                               std::vector<vertex_id_t>& ids) const {
+    return pimpl_.edges_get(vertex, filter, ids);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::get(const vertex_uid_t& vertex,
+                               std::vector<vertex_t>& types,
+                               std::vector<vertex_id_t>& ids) const {
+    return pimpl_.edges_get(vertex, types, ids);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::common(const vertex_uid_t& vertex1,
+                                  const vertex_uid_t& vertex2,
+                                  vertex_uids_t& vertices) const {
+    return pimpl_.edges_common(vertex1, vertex2, vertices);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::common(const vertex_uid_t& vertex1,
+                                  const vertex_uid_t& vertex2,
+                                  vertex_t filter,
+                                  std::vector<vertex_id_t>& ids) const {
+    return pimpl_.edges_combine(SetOperation::set_intersection, {vertex1, vertex2}, filter, ids);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::combine(SetOperation operation,
+                                   const vertex_uids_t& vertices,
+                                   vertex_t filter,
+                                   std::vector<vertex_id_t>& ids) const {
+    return pimpl_.edges_combine(operation, vertices, filter, ids);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::get_with_payloads(const vertex_uid_t& vertex,
+                                             vertex_uids_t& edges,
+                                             std::string& payloads,
+                                             std::vector<std::size_t>& offsets) const {
+    return pimpl_.edges_get_with_payloads(vertex, edges, payloads, offsets);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::get_with_payloads(const vertex_uid_t& vertex,
+                                             vertex_t filter,
+                                             std::vector<vertex_id_t>& ids,
+                                             std::string& payloads,
+                                             std::vector<std::size_t>& offsets) const {
+    return pimpl_.edges_get_with_payloads(vertex, filter, ids, payloads, offsets);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::get_many(const vertex_t* types,
+                                    const vertex_id_t* ids,
+                                    std::size_t num_vertices,
+                                    vertex_t filter,
+                                    std::vector<std::size_t>& offsets,
+                                    std::vector<vertex_id_t>& neighbours,
+                                    std::size_t num_threads) const {
+    return pimpl_.edges_get_many(
+        {types, num_vertices}, {ids, num_vertices}, filter, offsets, neighbours, num_threads);
+}
+
 template <EdgeOrientation Orientation>
 Status Edges<Orientation>::erase(const vertex_uid_t& vertex1,
                                  const vertex_uid_t& vertex2,
@@ -119,16 +202,78 @@ Status Edges<Orientation>::clear(bool commit) {
     return pimpl_.edges_clear(commit);
 }
 
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::degree(const vertex_uid_t& vertex, std::size_t& degree) const {
+    return pimpl_.edges_degree(vertex, degree);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::degree(const vertex_uid_t& vertex,
+                                  vertex_t filter,
+                                  std::size_t& degree) const {
+    return pimpl_.edges_degree(vertex, filter, degree);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::degree(const vertex_t* types,
+                                  const vertex_id_t* ids,
+                                  std::size_t num_vertices,
+                                  std::size_t* degrees) const {
+    return pimpl_.edges_degree({types, num_vertices},
+                               {ids, num_vertices},
+                               {degrees, num_vertices});
+}
+
 template <EdgeOrientation Orientation>
 Status Edges<Orientation>::count(std::size_t& count) const {
     return pimpl_.edges_count(count);
 }
 
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::parallel_for_each(
+    const std::function<void(std::size_t, const edge_uid_t&)>& visitor,
+    std::size_t num_partitions) const {
+    return pimpl_.edges_parallel_for_each(num_partitions, visitor);
+}
+
+template <EdgeOrientation Orientation>
+Status Edges<Orientation>::count(vertex_t head, vertex_t tail, std::size_t& count) const {
+    return pimpl_.edges_count(head, tail, count);
+}
+
 template <EdgeOrientation Orientation>
 EdgeIterator Edges<Orientation>::begin(size_t position) const {
     return {pimpl_, position};
 }
 
+template <EdgeOrientation Orientation>
+EdgeIterator Edges<Orientation>::begin(const edge_uid_t& from) const {
+    return {pimpl_, from};
+}
+
+template <EdgeOrientation Orientation>
+EdgeIterator Edges<Orientation>::resume(const std::string& token) const {
+    if (token.empty()) {
+        return end();
+    }
+    if (token.size() != std::tuple_size<GraphKV::edge_key_t>::value || token[0] != 'E') {
+        throw std::runtime_error("Invalid edge iterator token");
+    }
+    edge_uid_t from;
+    GraphKV::decode_edge(token.data(), token.size(), from);
+    return begin(from);
+}
+
+template <EdgeOrientation Orientation>
+EdgeIterator Edges<Orientation>::begin_unique() const {
+    return EdgeIterator(pimpl_.canonical_edge_iterator());
+}
+
+template <EdgeOrientation Orientation>
+EdgeIterator Edges<Orientation>::end_unique() const {
+    return end();
+}
+
 template <EdgeOrientation Orientation>
 EdgeIterator Edges<Orientation>::end() const {
     return {pimpl_, std::numeric_limits<std::size_t>::max()};
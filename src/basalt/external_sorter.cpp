@@ -0,0 +1,317 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <queue>
+
+#include "external_sorter.hpp"
+
+namespace basalt {
+
+constexpr std::size_t ExternalSorter::sample_interval;
+constexpr std::size_t ExternalSorter::index_interval;
+
+/**
+ * \name Run files helpers
+ * A run is a sequence of records, each one made of the length of the key
+ * and the length of the value as 32-bit integers, the sequence number as a
+ * 64-bit integer, followed by the key and the value.
+ * \{
+ */
+
+static void write_record(std::ofstream& ostr,
+                         const std::string& key,
+                         const std::string& value,
+                         std::uint64_t sequence) {
+    const std::uint32_t sizes[2] = {static_cast<std::uint32_t>(key.size()),
+                                    static_cast<std::uint32_t>(value.size())};
+    ostr.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    ostr.write(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+    ostr.write(key.data(), static_cast<std::streamsize>(key.size()));
+    ostr.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+/**
+ * \param found set to false if the end of the run is reached
+ * \return an error if the run cannot be read or ends with a partial record
+ */
+static rocksdb::Status read_record(std::ifstream& istr,
+                                   const std::string& path,
+                                   std::string& key,
+                                   std::string& value,
+                                   std::uint64_t& sequence,
+                                   bool& found) {
+    found = false;
+    std::uint32_t sizes[2];
+    if (!istr.read(reinterpret_cast<char*>(sizes), sizeof(sizes))) {
+        if (istr.eof() && istr.gcount() == 0) {
+            return rocksdb::Status::OK();
+        }
+        return rocksdb::Status::IOError("Truncated record in sorted run", path);
+    }
+    istr.read(reinterpret_cast<char*>(&sequence), sizeof(sequence));
+    key.resize(sizes[0]);
+    value.resize(sizes[1]);
+    istr.read(&key[0], static_cast<std::streamsize>(sizes[0]));
+    istr.read(&value[0], static_cast<std::streamsize>(sizes[1]));
+    if (!istr) {
+        return rocksdb::Status::IOError("Truncated record in sorted run", path);
+    }
+    found = true;
+    return rocksdb::Status::OK();
+}
+
+/** \} */
+
+/**
+ * Head record of a sorted sequence: a run on disk or the buffer in memory,
+ * restricted to a range of keys
+ */
+class ExternalSorter::Cursor {
+  public:
+    /// cursor over a run
+    Cursor(const Run& run, const std::string& lower, const std::string& upper)
+        : upper_(upper)
+        , run_(&run)
+        , istr_(new std::ifstream(run.path, std::ios::binary))
+        , valid_(false) {
+        if (!istr_->is_open()) {
+            status_ = rocksdb::Status::IOError("Could not open sorted run", run.path);
+            return;
+        }
+        // start from the last indexed record before the lower bound
+        const auto indexed =
+            std::lower_bound(run.index.begin(),
+                             run.index.end(),
+                             lower,
+                             [](const std::pair<std::string, std::streamoff>& entry,
+                                const std::string& key) { return entry.first < key; });
+        if (indexed != run.index.begin()) {
+            istr_->seekg(std::prev(indexed)->second);
+        }
+        skip(lower);
+    }
+
+    /// cursor over the buffer of records in memory
+    Cursor(const std::vector<Record>& records, const std::string& lower, const std::string& upper)
+        : upper_(upper)
+        , run_(nullptr)
+        , record_(std::lower_bound(records.begin(),
+                                   records.end(),
+                                   lower,
+                                   [](const Record& record, const std::string& key) {
+                                       return record.key < key;
+                                   }))
+        , end_(records.end())
+        , valid_(load()) {}
+
+    inline bool valid() const noexcept {
+        return valid_;
+    }
+
+    /// \return an error if the underlying run could not be read, the cursor is then invalid
+    inline const rocksdb::Status& status() const noexcept {
+        return status_;
+    }
+
+    void next() {
+        if (istr_) {
+            bool found;
+            status_ = read_record(
+                *istr_, run_->path, key_storage_, value_storage_, sequence, found);
+            valid_ = found && in_range();
+            if (valid_) {
+                key = key_storage_;
+                value = value_storage_;
+            }
+        } else {
+            ++record_;
+            valid_ = load();
+        }
+    }
+
+    rocksdb::Slice key;
+    rocksdb::Slice value;
+    std::uint64_t sequence = 0;
+
+  private:
+    void skip(const std::string& lower) {
+        next();
+        while (valid_ && key.compare(lower) < 0) {
+            next();
+        }
+    }
+
+    bool in_range() const {
+        return upper_.empty() || key_storage_ < upper_;
+    }
+
+    bool load() {
+        if (record_ == end_ || (!upper_.empty() && record_->key >= upper_)) {
+            return false;
+        }
+        key = record_->key;
+        value = record_->value;
+        sequence = record_->sequence;
+        return true;
+    }
+
+    const std::string& upper_;
+    const Run* run_;
+    std::unique_ptr<std::ifstream> istr_;
+    rocksdb::Status status_;
+    std::string key_storage_;
+    std::string value_storage_;
+    std::vector<Record>::const_iterator record_;
+    std::vector<Record>::const_iterator end_;
+    bool valid_;
+};
+
+ExternalSorter::ExternalSorter(std::string directory, std::string name, std::size_t max_memory)
+    : directory_(std::move(directory))
+    , name_(std::move(name))
+    , max_memory_(max_memory)
+    , memory_()
+    , added_() {}
+
+ExternalSorter::~ExternalSorter() {
+    clear();
+}
+
+rocksdb::Status ExternalSorter::add(const rocksdb::Slice& key,
+                                    const rocksdb::Slice& value,
+                                    std::uint64_t sequence) {
+    if (added_++ % sample_interval == 0) {
+        samples_.push_back(key.ToString());
+    }
+    records_.push_back({key.ToString(), value.ToString(), sequence});
+    memory_ += sizeof(Record) + key.size() + value.size();
+    if (memory_ >= max_memory_) {
+        return spill();
+    }
+    return rocksdb::Status::OK();
+}
+
+void ExternalSorter::prepare() {
+    std::sort(records_.begin(), records_.end(), [](const Record& lhs, const Record& rhs) {
+        return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.sequence < rhs.sequence);
+    });
+    if (records_.empty()) {
+        return;
+    }
+    // keep the record with the highest sequence number of every key
+    std::size_t last = 0;
+    for (auto i = 1ul; i < records_.size(); ++i) {
+        if (records_[i].key != records_[last].key) {
+            ++last;
+        }
+        if (last != i) {
+            records_[last] = std::move(records_[i]);
+        }
+    }
+    records_.resize(last + 1);
+}
+
+rocksdb::Status ExternalSorter::spill() {
+    prepare();
+    Run run;
+    run.path = directory_ + '/' + name_ + '-' + std::to_string(runs_.size()) + ".run";
+    std::ofstream ostr(run.path, std::ios::binary);
+    for (auto i = 0ul; i < records_.size(); ++i) {
+        if (i % index_interval == 0) {
+            run.index.emplace_back(records_[i].key, ostr.tellp());
+        }
+        write_record(ostr, records_[i].key, records_[i].value, records_[i].sequence);
+    }
+    ostr.close();
+    runs_.push_back(std::move(run));
+    records_.clear();
+    memory_ = 0;
+    if (!ostr) {
+        return rocksdb::Status::IOError("Could not write sorted run", runs_.back().path);
+    }
+    return rocksdb::Status::OK();
+}
+
+rocksdb::Status ExternalSorter::merge(const std::vector<const ExternalSorter*>& sorters,
+                                      const std::string& lower,
+                                      const std::string& upper,
+                                      const callback_t& callback) {
+    std::vector<std::unique_ptr<Cursor>> cursors;
+    for (const auto sorter: sorters) {
+        for (const auto& run: sorter->runs_) {
+            cursors.emplace_back(new Cursor(run, lower, upper));
+            if (!cursors.back()->status().ok()) {
+                return cursors.back()->status();
+            }
+        }
+        cursors.emplace_back(new Cursor(sorter->records_, lower, upper));
+    }
+    // smallest key first, then the highest sequence number to drop duplicates
+    const auto greater = [](const Cursor* lhs, const Cursor* rhs) {
+        const auto order = lhs->key.compare(rhs->key);
+        if (order != 0) {
+            return order > 0;
+        }
+        return lhs->sequence < rhs->sequence;
+    };
+    std::priority_queue<Cursor*, std::vector<Cursor*>, decltype(greater)> heap(greater);
+    for (const auto& cursor: cursors) {
+        if (cursor->valid()) {
+            heap.push(cursor.get());
+        }
+    }
+    // move a cursor to its next record, stop the merge if its run cannot be read
+    const auto advance = [&heap](Cursor* cursor) {
+        cursor->next();
+        if (cursor->valid()) {
+            heap.push(cursor);
+        }
+        return cursor->status();
+    };
+
+    auto status = rocksdb::Status::OK();
+    while (!heap.empty() && status.ok()) {
+        auto cursor = heap.top();
+        heap.pop();
+        // skip older records with the same key
+        while (status.ok() && !heap.empty() && heap.top()->key == cursor->key) {
+            auto older = heap.top();
+            heap.pop();
+            status = advance(older);
+        }
+        if (status.ok()) {
+            status = callback(cursor->key, cursor->value);
+        }
+        if (status.ok()) {
+            status = advance(cursor);
+        }
+    }
+    return status;
+}
+
+rocksdb::Status ExternalSorter::sort(const callback_t& callback) {
+    prepare();
+    const auto status = merge({this}, std::string(), std::string(), callback);
+    clear();
+    return status;
+}
+
+void ExternalSorter::clear() {
+    for (const auto& run: runs_) {
+        std::remove(run.path.c_str());
+    }
+    runs_.clear();
+    records_.clear();
+    samples_.clear();
+    memory_ = 0;
+    added_ = 0;
+}
+
+}  // namespace basalt
@@ -0,0 +1,128 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rocksdb/slice.h>
+#include <rocksdb/status.h>
+
+namespace basalt {
+
+/**
+ * Sort key-value records with a bounded amount of memory.
+ *
+ * Records are buffered in memory until the buffer exceeds the given budget.
+ * The buffer is then sorted and written to a temporary file, called a run.
+ * Runs are eventually merged together to visit all records in the bytewise
+ * order of their keys. When the same key is added several times, only the
+ * value with the highest sequence number is visited.
+ *
+ * Several sorters filled concurrently can be merged together, and distinct
+ * key ranges can be merged concurrently.
+ */
+class ExternalSorter {
+  public:
+    using callback_t =
+        std::function<rocksdb::Status(const rocksdb::Slice& key, const rocksdb::Slice& value)>;
+
+    /// one key every \a sample_interval added records is kept in \a samples
+    constexpr static std::size_t sample_interval = 1024;
+    /// runs are indexed every \a index_interval records to seek within them
+    constexpr static std::size_t index_interval = 1024;
+
+    /**
+     * \param directory where runs are written
+     * \param name prefix of the runs file names
+     * \param max_memory approximative number of bytes buffered in memory
+     */
+    ExternalSorter(std::string directory, std::string name, std::size_t max_memory);
+
+    /// remove the runs written on disk
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    /**
+     * \brief add a record
+     * \param sequence order of the record among the ones with the same key
+     * \return information whether operation succeeded or not
+     */
+    rocksdb::Status add(const rocksdb::Slice& key,
+                        const rocksdb::Slice& value,
+                        std::uint64_t sequence);
+
+    /// \brief sort the records buffered in memory, required before \a merge
+    void prepare();
+
+    /// \return keys sampled among the added records to estimate their distribution
+    inline const std::vector<std::string>& samples() const noexcept {
+        return samples_;
+    }
+
+    /**
+     * \brief visit the records of prepared sorters sorted by key
+     * \param sorters the sorters to merge, left untouched
+     * \param lower visit records whose key is greater or equal
+     * \param upper visit records whose key is strictly less, unbounded if empty
+     * \param callback function called for every record, visit stops at the first error
+     * \return information whether operation succeeded or not
+     */
+    static rocksdb::Status merge(const std::vector<const ExternalSorter*>& sorters,
+                                 const std::string& lower,
+                                 const std::string& upper,
+                                 const callback_t& callback);
+
+    /**
+     * \brief visit all records sorted by key, then clear the sorter
+     * \param callback function called for every record, visit stops at the first error
+     * \return information whether operation succeeded or not
+     */
+    rocksdb::Status sort(const callback_t& callback);
+
+    /// \brief drop all records and remove the runs written on disk
+    void clear();
+
+    /// \return true if no record has been added
+    inline bool empty() const noexcept {
+        return records_.empty() && runs_.empty();
+    }
+
+  private:
+    struct Record {
+        std::string key;
+        std::string value;
+        std::uint64_t sequence;
+    };
+
+    /// sorted records written on disk
+    struct Run {
+        std::string path;
+        /// key and file offset of one record every \a index_interval records
+        std::vector<std::pair<std::string, std::streamoff>> index;
+    };
+
+    class Cursor;
+
+    rocksdb::Status spill();
+
+    const std::string directory_;
+    const std::string name_;
+    const std::size_t max_memory_;
+    std::size_t memory_;
+    std::size_t added_;
+    std::vector<Record> records_;
+    std::vector<Run> runs_;
+    std::vector<std::string> samples_;
+};
+
+}  // namespace basalt
@@ -13,8 +13,10 @@ namespace rocksdb {
 /// forward declaration
 class ColumnFamilyHandle;
 class DB;
+struct IngestExternalFileArg;
 class Iterator;
 struct Options;
+class Slice;
 class Statistics;
 class Status;
 class WriteBatch;
@@ -29,5 +31,5 @@ class logger;
 
 namespace basalt {
 
-using db_t = std::unique_ptr<rocksdb::DB>;
+using db_t = std::shared_ptr<rocksdb::DB>;
 }
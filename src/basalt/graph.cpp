@@ -9,6 +9,7 @@
 #include <rocksdb/db.h>
 #include <rocksdb/slice_transform.h>
 
+#include <basalt/bulk_loader.hpp>
 #include <basalt/graph.hpp>
 
 #include "graph_impl.hpp"
@@ -48,6 +49,43 @@ Status Graph<Orientation>::commit() {
     return pimpl_->commit();
 }
 
+template <EdgeOrientation Orientation>
+Status Graph<Orientation>::recount() {
+    return pimpl_->recount();
+}
+
+template <EdgeOrientation Orientation>
+BulkLoader<Orientation> Graph<Orientation>::bulk_loader(std::size_t max_memory,
+                                                        std::size_t num_threads) {
+    return BulkLoader<Orientation>(*pimpl_, max_memory, num_threads);
+}
+
+template <EdgeOrientation Orientation>
+Status Graph<Orientation>::snapshot_csr(CSR& csr, std::size_t num_partitions) const {
+    return pimpl_->snapshot_csr(csr, num_partitions);
+}
+
+template <EdgeOrientation Orientation>
+Status Graph<Orientation>::export_csr(std::size_t num_partitions) const {
+    return pimpl_->export_csr(num_partitions);
+}
+
+template <EdgeOrientation Orientation>
+Status Graph<Orientation>::k_hop(const vertex_uids_t& seeds,
+                                 std::size_t num_hops,
+                                 const std::vector<vertex_t>& type_filters,
+                                 Hops& hops) const {
+    return pimpl_->k_hop(seeds, num_hops, type_filters, hops);
+}
+
+template <EdgeOrientation Orientation>
+Status Graph<Orientation>::traverse(const vertex_uids_t& seeds,
+                                    const Traversal& traversal,
+                                    std::vector<vertex_t>& types,
+                                    std::vector<vertex_id_t>& ids) const {
+    return pimpl_->traverse(seeds, traversal, types, ids);
+}
+
 template <EdgeOrientation Orientation>
 std::string Graph<Orientation>::statistics() const {
     return pimpl_->statistics();
@@ -4,10 +4,20 @@
  * This file is part of Basalt distributed under the terms of the GNU
  * Lesser General Public License. See top-level LICENSE file for details.
  *************************************************************************/
+#include <algorithm>
 #include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#include <basalt/csr.hpp>
 
 #include "edge_iterator_impl.hpp"
 #include "graph_impl.hpp"
+#include "thread_pool.hpp"
 #include "vertex_iterator_impl.hpp"
 
 #include <gsl>
@@ -32,6 +42,12 @@ inline static const rocksdb::ReadOptions& default_read_options() {
     return default_read_options;
 }
 
+/// \return number of ranges of a parallel scan, one per hardware thread if 0
+inline static std::size_t scan_partitions(std::size_t num_partitions) {
+    return num_partitions != 0 ? num_partitions
+                               : std::max(1u, std::thread::hardware_concurrency());
+}
+
 inline static const rocksdb::WriteOptions& write_options(bool commit) {
     if (commit) {
         static const rocksdb::WriteOptions sync_write = []() {
@@ -45,6 +61,38 @@ inline static const rocksdb::WriteOptions& write_options(bool commit) {
     return async_write;
 }
 
+/**
+ * \return length of the prefixes extracted from the keys of a column family, 0 if none
+ */
+static std::size_t prefix_extractor_length(const rocksdb::ColumnFamilyOptions& options) {
+    if (!options.prefix_extractor) {
+        return 0;
+    }
+    // longer than any key of the database
+    const std::string probe(64, '\0');
+    if (!options.prefix_extractor->InDomain(probe)) {
+        return 0;
+    }
+    return options.prefix_extractor->Transform(probe).size();
+}
+
+/**
+ * \return key format declared in the JSON config of a database, the legacy one
+ * if the config does not exist or does not declare it
+ */
+static int json_key_format(const std::string& path) {
+    if (!std::ifstream(path + "/config.json").is_open()) {
+        return GraphKV::legacy_key_format;
+    }
+    return Config(path).key_format();
+}
+
+template <EdgeOrientation Orientation>
+constexpr std::size_t GraphImpl<Orientation>::multiget_batch_size;
+
+template <EdgeOrientation Orientation>
+constexpr std::size_t GraphImpl<Orientation>::get_many_chunk_size;
+
 template <EdgeOrientation Orientation>
 GraphImpl<Orientation>::GraphImpl(const std::string& path)
     : GraphImpl(path, Config(path), false) {}
@@ -56,36 +104,81 @@ GraphImpl<Orientation>::GraphImpl(const std::string& path, Config config, bool t
     , vertices_(*this)
     , edges_(*this)
     , statistics_(rocksdb::CreateDBStatistics())
-    , options_(new rocksdb::Options) {
+    , options_(new rocksdb::Options)
+    , counted_(false)
+    , canonical_payloads_(Orientation == EdgeOrientation::undirected &&
+                          config_.canonical_edge_payloads()) {
     if (throw_if_exists) {
         struct stat info {};
-        auto status = stat(path.c_str(), &info);
-        if (status != ENOENT) {
-            if (status != 0) {
-                // something went wont
-                throw std::runtime_error(strerror(errno));
-            }
+        if (stat(path.c_str(), &info) == 0) {
             throw std::runtime_error("Database directory is not supposed to exist");
         }
+        if (errno != ENOENT) {
+            // something went wrong
+            throw std::runtime_error(strerror(errno));
+        }
     }
 
+    if (config_.key_format() != GraphKV::key_format_version) {
+        std::ostringstream oss;
+        oss << "Unsupported key format " << config_.key_format() << " of database " << path
+            << ". Expected " << GraphKV::key_format_version;
+        throw std::runtime_error(oss.str());
+    }
+
+    // every RocksDB database has a CURRENT file
+    struct stat current {};
+    const bool existed = stat((path + "/CURRENT").c_str(), &current) == 0;
+
     rocksdb::DB* db;
 
     this->config_.configure(*options_);
-    const auto& column_families = this->config_.column_families();
+    auto column_families = this->config_.column_families();
     std::vector<rocksdb::ColumnFamilyHandle*> handles;
     handles.reserve(column_families.size());
     if (config_.read_only()) {
+        // databases created before the introduction of counters do not have
+        // the "meta" column family, which cannot be created in read-only mode.
+        std::vector<std::string> names;
+        to_status(rocksdb::DB::ListColumnFamilies(*options_, path, &names)).raise_on_error();
+        if (std::find(names.begin(), names.end(), "meta") == names.end()) {
+            column_families.erase(
+                std::remove_if(column_families.begin(),
+                               column_families.end(),
+                               [](const rocksdb::ColumnFamilyDescriptor& descriptor) {
+                                   return descriptor.name == "meta";
+                               }),
+                column_families.end());
+        }
         to_status(rocksdb::DB::OpenForReadOnly(*options_, path, column_families, &handles, &db))
             .raise_on_error();
     } else {
         to_status(rocksdb::DB::Open(*options_, path, column_families, &handles, &db))
             .raise_on_error();
     }
-    vertices_column_.reset(handles[0]);
-    edges_column_.reset(handles[1]);
-
     db_.reset(db);
+    iterators_ = std::make_shared<IteratorPool>(db_);
+    std::vector<std::shared_ptr<rocksdb::ColumnFamilyHandle>> columns;
+    columns.reserve(handles.size());
+    for (auto i = 0ul; i < handles.size(); ++i) {
+        // column families keep the database open until their last iterator is deleted
+        const auto database = db_;
+        columns.emplace_back(handles[i],
+                             [database](rocksdb::ColumnFamilyHandle* handle) { delete handle; });
+        iterators_->add_column(columns.back(),
+                               prefix_extractor_length(column_families[i].options));
+    }
+    vertices_column_ = columns[0];
+    edges_column_ = columns[1];
+    for (auto i = 2ul; i < columns.size(); ++i) {
+        const auto& name = column_families[i].name;
+        if (name == "adjacency" && config_.packed_edges()) {
+            adjacency_column_ = columns[i];
+        } else if (name == "meta") {
+            meta_column_ = columns[i];
+        }
+    }
+    key_format_check(existed);
     mkdir((path + "/logs").c_str(), 0777);
     const std::string logger_name = "basalt[" + path + "]";
     logger_ = spdlog::get(logger_name);
@@ -106,6 +199,72 @@ GraphImpl<Orientation>::GraphImpl(const std::string& path, Config config, bool t
             }
         }
     }
+    if (meta_column_) {
+        std::string value;
+        const auto status = db_->Get(default_read_options(),
+                                     meta_column_.get(),
+                                     Counters::initialized_key(),
+                                     &value);
+        if (status.ok()) {
+            counted_ = true;
+        } else if (!status.IsNotFound()) {
+            to_status(status).raise_on_error();
+        } else if (!config_.read_only()) {
+            logger_->info("initializing counters of vertices and edges");
+            recount().raise_on_error();
+        }
+    }
+    if (config_.read_only()) {
+        // the database cannot change, neighbour queries can be answered by an
+        // exported CSR file as long as no write happened since its export
+        const auto csr_path = path + '/' + MappedCSR::filename;
+        const auto status = MappedCSR::open(csr_path, mapped_csr_);
+        if (status.ok()) {
+            const auto sequence = db_->GetLatestSequenceNumber();
+            if (mapped_csr_->orientation() != Orientation || mapped_csr_->sequence() != sequence) {
+                logger_->info("ignoring outdated CSR file {}", csr_path);
+                mapped_csr_.reset();
+            } else {
+                logger_->info("serving edges from CSR file {}", csr_path);
+            }
+        } else if (!status.IsNotFound()) {
+            logger_->warn("ignoring CSR file: {}", status.ToString());
+        }
+    }
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::key_format_check(bool existed) {
+    std::string value;
+    if (meta_column_) {
+        const auto status =
+            db_->Get(default_read_options(), meta_column_.get(), GraphKV::key_format_key(), &value);
+        if (!status.ok() && !status.IsNotFound()) {
+            to_status(status).raise_on_error();
+        }
+    }
+    // databases written before the format was recorded in the "meta" column
+    // family may declare it in their JSON config, whatever config is given
+    const auto recorded = !value.empty();
+    int key_format = GraphKV::key_format_version;
+    if (recorded) {
+        key_format = std::stoi(value);
+    } else if (existed) {
+        key_format = json_key_format(path_);
+    }
+    if (key_format != GraphKV::key_format_version) {
+        std::ostringstream oss;
+        oss << "Unsupported key format " << key_format << " of database " << path_
+            << ". Expected " << GraphKV::key_format_version;
+        throw std::runtime_error(oss.str());
+    }
+    if (!recorded && meta_column_ && !config_.read_only()) {
+        to_status(db_->Put(write_options(true),
+                           meta_column_.get(),
+                           GraphKV::key_format_key(),
+                           std::to_string(key_format)))
+            .raise_on_error();
+    }
 }
 
 template <EdgeOrientation Orientation>
@@ -120,10 +279,14 @@ Status GraphImpl<Orientation>::vertices_insert(const vertex_uid_t& vertex, bool
     logger_get()->debug("vertices_insert(vertex={}, commit={})", vertex, commit);
     GraphKV::vertex_key_t key;
     GraphKV::encode(vertex, key);
-    return to_status(db_get()->Put(write_options(commit),
-                                   vertices_column_.get(),
-                                   rocksdb::Slice(key.data(), key.size()),
-                                   rocksdb::Slice()));
+    Counters counters;
+    const auto status = count_vertex_insertions(counters, {vertex});
+    if (!status) {
+        return status;
+    }
+    rocksdb::WriteBatch batch;
+    batch.Put(vertices_column_.get(), rocksdb::Slice(key.data(), key.size()), rocksdb::Slice());
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
@@ -136,10 +299,16 @@ Status GraphImpl<Orientation>::vertices_insert(const vertex_uid_t& vertex,
                         commit);
     GraphKV::vertex_key_t key;
     GraphKV::encode(vertex, key);
-    return to_status(db_get()->Put(write_options(commit),
-                                   vertices_column_.get(),
-                                   rocksdb::Slice(key.data(), key.size()),
-                                   rocksdb::Slice(payload.data(), payload.size())));
+    Counters counters;
+    const auto status = count_vertex_insertions(counters, {vertex});
+    if (!status) {
+        return status;
+    }
+    rocksdb::WriteBatch batch;
+    batch.Put(vertices_column_.get(),
+              rocksdb::Slice(key.data(), key.size()),
+              rocksdb::Slice(payload.data(), payload.size()));
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
@@ -154,6 +323,17 @@ Status GraphImpl<Orientation>::vertices_insert(const gsl::span<const vertex_t> t
                         commit);
     GraphKV::vertex_key_t key;
     rocksdb::WriteBatch batch;
+    Counters counters;
+    if (counted_) {
+        vertex_uids_t inserted(types.length());
+        for (auto i = 0ul; i < inserted.size(); ++i) {
+            inserted[i] = make_id(types[i], ids[i]);
+        }
+        const auto status = count_vertex_insertions(counters, std::move(inserted));
+        if (!status) {
+            return status;
+        }
+    }
 
     if (payloads.empty()) {
         const rocksdb::Slice empty_payload;
@@ -171,7 +351,7 @@ Status GraphImpl<Orientation>::vertices_insert(const gsl::span<const vertex_t> t
                       rocksdb::Slice(payloads[i], payloads_sizes[i]));
         }
     }
-    return to_status(db_get()->Write(write_options(commit), &batch));
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
@@ -179,17 +359,64 @@ Status GraphImpl<Orientation>::vertices_has(const vertex_uid_t& vertex, bool& re
     logger_get()->debug("vertices_has(vertex={})", vertex);
     GraphKV::vertex_key_t key;
     GraphKV::encode(vertex, key);
-    const rocksdb::Slice slice(key.data(), key.size());
+    return key_exists(vertices_column_.get(), rocksdb::Slice(key.data(), key.size()), result);
+}
 
-    std::string value;
-    const auto& status =
-        db_get()->Get(default_read_options(), vertices_column_.get(), slice, &value);
-    if (status.IsNotFound()) {
-        result = false;
-        return Status::ok();
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::vertices_has(const gsl::span<const vertex_uid_t> vertices,
+                                            const gsl::span<bool> results) const {
+    logger_get()->debug("vertices_has(count={})", vertices.size());
+    // look up keys in their bytewise order, which is the order of the vertices,
+    // so that MultiGet can visit the memtables and SST files sequentially.
+    std::vector<std::size_t> order(vertices.size());
+    for (auto i = 0ul; i < order.size(); ++i) {
+        order[i] = i;
     }
-    result = status.ok();
-    return to_status(status);
+    std::sort(order.begin(), order.end(), [&vertices](std::size_t lhs, std::size_t rhs) {
+        return vertices[lhs] < vertices[rhs];
+    });
+    const auto batch_size = std::min(order.size(), multiget_batch_size);
+    std::vector<GraphKV::vertex_key_t> keys(batch_size);
+    std::vector<rocksdb::Slice> slices(batch_size);
+    std::vector<rocksdb::PinnableSlice> values(batch_size);
+    std::vector<rocksdb::Status> statuses(batch_size);
+    for (auto first = 0ul; first < order.size(); first += batch_size) {
+        const auto count = std::min(batch_size, order.size() - first);
+        for (auto i = 0ul; i < count; ++i) {
+            GraphKV::encode(vertices[order[first + i]], keys[i]);
+            slices[i] = rocksdb::Slice(keys[i].data(), keys[i].size());
+            values[i].Reset();
+        }
+        db_get()->MultiGet(default_read_options(),
+                           vertices_column_.get(),
+                           count,
+                           slices.data(),
+                           values.data(),
+                           statuses.data(),
+                           true);
+        for (auto i = 0ul; i < count; ++i) {
+            if (!statuses[i].ok() && !statuses[i].IsNotFound()) {
+                return to_status(statuses[i]);
+            }
+            results[order[first + i]] = statuses[i].ok();
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::vertices_require(const vertex_uids_t& vertices) const {
+    std::unique_ptr<bool[]> present(new bool[vertices.size()]);
+    const auto status = vertices_has(vertices, {present.get(), vertices.size()});
+    if (!status) {
+        return status;
+    }
+    for (auto i = 0ul; i < vertices.size(); ++i) {
+        if (!present[i]) {
+            return Status::error_missing_vertex(vertices[i]);
+        }
+    }
+    return Status::ok();
 }
 
 template <EdgeOrientation Orientation>
@@ -207,6 +434,25 @@ Status GraphImpl<Orientation>::vertices_get(const vertex_uid_t& vertex, std::str
     return to_status(status);
 }
 
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::vertices_get(const vertex_uid_t& vertex, PayloadView& value) const {
+    logger_get()->debug("vertices_get(vertex={}, view=true)", vertex);
+    GraphKV::vertex_key_t key;
+    GraphKV::encode(vertex, key);
+    auto& slice = value.slice();
+    slice.Reset();
+    // the column family keeps the database, and so the pinned memory, alive
+    value.keep_alive(vertices_column_);
+    const auto& status = db_get()->Get(default_read_options(),
+                                       vertices_column_.get(),
+                                       rocksdb::Slice(key.data(), key.size()),
+                                       &slice);
+    if (status.IsNotFound()) {
+        return Status::error_missing_vertex(vertex);
+    }
+    return to_status(status);
+}
+
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::vertices_erase(const vertex_uid_t& vertex, bool commit) {
     logger_get()->debug("vertices_erase(vertex={}, commit={})", vertex, commit);
@@ -214,20 +460,39 @@ Status GraphImpl<Orientation>::vertices_erase(const vertex_uid_t& vertex, bool c
     GraphKV::encode(vertex, key);
     rocksdb::WriteBatch batch;
     const rocksdb::Slice slice(key.data(), key.size());
+    Counters counters;
+    if (counted_) {
+        bool present;
+        const auto status = key_exists(vertices_column_.get(), slice, present);
+        if (!status) {
+            return status;
+        }
+        if (present) {
+            counters.add_vertices(vertex.first, -1);
+        }
+    }
     batch.Delete(vertices_column_.get(), slice);
     auto removed = 0ul;
-    const auto status = edges_erase(batch, vertex, removed);
+    const auto status = edges_erase(batch, counters, vertex, removed);
     if (!status) {
         return status;
     }
-    return to_status(db_get()->Write(write_options(commit), &batch));
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::vertices_count(std::size_t& count) const {
+    if (counted_) {
+        std::int64_t value;
+        const auto status = counters_sum('N', value);
+        if (status) {
+            count = static_cast<std::size_t>(value);
+        }
+        return status;
+    }
     std::size_t num_vertices{};
 
-    auto iter = db_get()->NewIterator(default_read_options(), this->vertices_column_.get());
+    auto iter = iterators_->iterate(vertices_column_.get(), 'N');
     iter->SeekToFirst();
     while (iter->Valid()) {
         ++num_vertices;
@@ -239,34 +504,148 @@ Status GraphImpl<Orientation>::vertices_count(std::size_t& count) const {
 
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::vertices_count(vertex_t type, std::size_t& count) const {
+    if (counted_) {
+        GraphKV::vertex_counter_key_t key;
+        GraphKV::encode_vertex_counter(type, key);
+        std::int64_t value;
+        const auto status = counter_get(rocksdb::Slice(key.data(), key.size()), value);
+        if (status) {
+            count = static_cast<std::size_t>(value);
+        }
+        return status;
+    }
     std::size_t num_vertices{};
 
-    auto iter = db_get()->NewIterator(default_read_options(), this->vertices_column_.get());
-    iter->SeekToFirst();
+    GraphKV::vertex_key_t first_key;
+    GraphKV::encode(type, 0, first_key);
+    auto iter = iterators_->iterate(vertices_column_.get(),
+                                    rocksdb::Slice(first_key.data(), 1 + sizeof(vertex_t)));
+    for (iter->Seek(rocksdb::Slice(first_key.data(), first_key.size())); iter->Valid();
+         iter->Next()) {
+        ++num_vertices;
+    }
+    count = num_vertices;
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::vertices_range(vertex_t type,
+                                              vertex_id_t first,
+                                              vertex_id_t last,
+                                              vertex_uids_t& vertices) const {
+    logger_get()->debug("vertices_range(type={}, first={}, last={})", type, first, last);
+    if (first >= last) {
+        return Status::ok();
+    }
+    GraphKV::vertex_key_t lower_key;
+    GraphKV::vertex_key_t upper_key;
+    GraphKV::encode(type, first, lower_key);
+    GraphKV::encode(type, last, upper_key);
+    auto iter = iterators_->iterate_until(vertices_column_.get(),
+                                          rocksdb::Slice(upper_key.data(), upper_key.size()));
     vertex_uid_t vertex;
-    while (iter->Valid()) {
+    for (iter->Seek(rocksdb::Slice(lower_key.data(), lower_key.size())); iter->Valid();
+         iter->Next()) {
         const auto& key = iter->key();
         GraphKV::decode_vertex(key.data(), key.size(), vertex);
-        if (vertex.first == type) {
-            ++num_vertices;
-        }
-        iter->Next();
+        vertices.push_back(vertex);
     }
-    count = num_vertices;
     return to_status(iter->status());
 }
 
 template <EdgeOrientation Orientation>
 std::shared_ptr<VertexIteratorImpl> GraphImpl<Orientation>::vertex_iterator(
-    std::size_t from) const {
-    logger_get()->debug("vertex_iterator(from={})", from);
-    return std::make_shared<VertexIteratorImpl>(db_get(), vertices_column_.get(), "N", from);
+    std::size_t from,
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("vertex_iterator(from={}, snapshot={})", from, snapshot != nullptr);
+    return std::make_shared<VertexIteratorImpl>(
+        iterators_->iterate(vertices_column_.get(), 'N', snapshot), from);
+}
+
+template <EdgeOrientation Orientation>
+std::shared_ptr<EdgeIteratorImpl> GraphImpl<Orientation>::edge_iterator(
+    std::size_t from,
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("edge_iterator(from={}, snapshot={})", from, snapshot != nullptr);
+    if (packed()) {
+        return std::make_shared<EdgeIteratorImpl>(
+            iterators_->iterate(adjacency_column_.get(), 'A', snapshot), from, true);
+    }
+    return std::make_shared<EdgeIteratorImpl>(
+        iterators_->iterate(edges_column_.get(), 'E', snapshot), from, false);
+}
+
+template <EdgeOrientation Orientation>
+std::shared_ptr<VertexIteratorImpl> GraphImpl<Orientation>::vertex_iterator(
+    const vertex_uid_t& from,
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("vertex_iterator(from={}, snapshot={})", from, snapshot != nullptr);
+    return std::make_shared<VertexIteratorImpl>(
+        iterators_->iterate(vertices_column_.get(), 'N', snapshot), from);
+}
+
+template <EdgeOrientation Orientation>
+std::shared_ptr<EdgeIteratorImpl> GraphImpl<Orientation>::edge_iterator(
+    const edge_uid_t& from,
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("edge_iterator(from={}, snapshot={})", from, snapshot != nullptr);
+    if (packed()) {
+        return std::make_shared<EdgeIteratorImpl>(
+            iterators_->iterate(adjacency_column_.get(), 'A', snapshot), from, true);
+    }
+    return std::make_shared<EdgeIteratorImpl>(
+        iterators_->iterate(edges_column_.get(), 'E', snapshot), from, false);
 }
 
 template <EdgeOrientation Orientation>
-std::shared_ptr<EdgeIteratorImpl> GraphImpl<Orientation>::edge_iterator(std::size_t from) const {
-    logger_get()->debug("edge_iterator(from={})", from);
-    return std::make_shared<EdgeIteratorImpl>(db_get(), edges_column_.get(), "E", from);
+std::shared_ptr<VertexIteratorImpl> GraphImpl<Orientation>::vertex_type_iterator(
+    vertex_t type,
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("vertex_type_iterator(type={}, snapshot={})", type, snapshot != nullptr);
+    GraphKV::vertex_key_t prefix;
+    GraphKV::encode(type, 0, prefix);
+    return std::make_shared<VertexIteratorImpl>(
+        iterators_->iterate(vertices_column_.get(),
+                            rocksdb::Slice(prefix.data(), 1 + sizeof(vertex_t)),
+                            snapshot),
+        vertex_uid_t{type, 0});
+}
+
+template <EdgeOrientation Orientation>
+std::shared_ptr<EdgeIteratorImpl> GraphImpl<Orientation>::canonical_edge_iterator(
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("canonical_edge_iterator(snapshot={})", snapshot != nullptr);
+    constexpr bool canonical = Orientation == EdgeOrientation::undirected;
+    if (packed()) {
+        return std::make_shared<EdgeIteratorImpl>(
+            iterators_->iterate(adjacency_column_.get(), 'A', snapshot), 0, true, canonical);
+    }
+    return std::make_shared<EdgeIteratorImpl>(
+        iterators_->iterate(edges_column_.get(), 'E', snapshot), 0, false, canonical);
+}
+
+template <EdgeOrientation Orientation>
+snapshot_ptr_t GraphImpl<Orientation>::snapshot() const {
+    return iterators_->snapshot();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::vertices_parallel_for_each(
+    std::size_t num_partitions,
+    const std::function<void(std::size_t, const vertex_uid_t&)>& visitor,
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("vertices_parallel_for_each(num_partitions={})", num_partitions);
+    return parallel_scan(vertices_column_.get(),
+                         'N',
+                         num_partitions,
+                         [&visitor](std::size_t partition,
+                                    const rocksdb::Slice& key,
+                                    const rocksdb::Slice& /* value */) {
+                             vertex_uid_t vertex;
+                             GraphKV::decode_vertex(key.data(), key.size(), vertex);
+                             visitor(partition, vertex);
+                         },
+                         snapshot);
 }
 
 template <EdgeOrientation Orientation>
@@ -274,6 +653,13 @@ Status GraphImpl<Orientation>::vertices_clear(bool commit) {
     rocksdb::WriteBatch batch;
     clear(batch, vertices_column_);
     clear(batch, edges_column_);
+    if (packed()) {
+        clear(batch, adjacency_column_);
+    }
+    if (counted_) {
+        counters_clear(batch, 'N');
+        counters_clear(batch, 'E');
+    }
     return to_status(db_get()->Write(write_options(commit), &batch));
 }
 
@@ -281,9 +667,33 @@ Status GraphImpl<Orientation>::vertices_clear(bool commit) {
 
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::edges_count(std::size_t& count) const {
+    if (counted_) {
+        std::int64_t value;
+        const auto status = counters_sum('E', value);
+        if (status) {
+            count = static_cast<std::size_t>(value);
+            if (Orientation == EdgeOrientation::undirected) {
+                count /= 2;
+            }
+        }
+        return status;
+    }
     std::size_t num_vertices{};
 
-    auto iter = db_get()->NewIterator(default_read_options(), this->edges_column_.get());
+    if (packed()) {
+        auto iter = iterators_->iterate(adjacency_column_.get(), 'A');
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            const auto& value = iter->value();
+            num_vertices += AdjacencyList::count(value.data(), value.size());
+        }
+        count = num_vertices;
+        if (Orientation == EdgeOrientation::undirected) {
+            count /= 2;
+        }
+        return to_status(iter->status());
+    }
+
+    auto iter = iterators_->iterate(edges_column_.get(), 'E');
     iter->SeekToFirst();
     while (iter->Valid()) {
         ++num_vertices;
@@ -296,10 +706,83 @@ Status GraphImpl<Orientation>::edges_count(std::size_t& count) const {
     return to_status(iter->status());
 }
 
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_count(vertex_t head, vertex_t tail, std::size_t& count) const {
+    std::int64_t value;
+    if (counted_) {
+        GraphKV::edge_counter_key_t key;
+        GraphKV::encode_edge_counter(head, tail, key);
+        const auto status = counter_get(rocksdb::Slice(key.data(), key.size()), value);
+        if (!status) {
+            return status;
+        }
+    } else {
+        Counters counters;
+        const auto status = counters_scan(counters);
+        if (!status) {
+            return status;
+        }
+        value = counters.edges(head, tail);
+    }
+    count = static_cast<std::size_t>(value);
+    if (Orientation == EdgeOrientation::undirected && head == tail) {
+        // such edges are stored in both directions
+        count /= 2;
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_parallel_for_each(
+    std::size_t num_partitions,
+    const std::function<void(std::size_t, const edge_uid_t&)>& visitor,
+    const snapshot_ptr_t& snapshot) const {
+    logger_get()->debug("edges_parallel_for_each(num_partitions={})", num_partitions);
+    if (packed()) {
+        return parallel_scan(adjacency_column_.get(),
+                             'A',
+                             num_partitions,
+                             [&visitor](std::size_t partition,
+                                        const rocksdb::Slice& key,
+                                        const rocksdb::Slice& value) {
+                                 edge_uid_t edge;
+                                 vertex_t type;
+                                 GraphKV::decode_adjacency(key.data(),
+                                                           key.size(),
+                                                           edge.first,
+                                                           type);
+                                 AdjacencyList::ids_t ids;
+                                 AdjacencyList::decode(value.data(), value.size(), ids);
+                                 for (const auto id: ids) {
+                                     edge.second = make_id(type, id);
+                                     visitor(partition, edge);
+                                 }
+                             },
+                             snapshot);
+    }
+    return parallel_scan(edges_column_.get(),
+                         'E',
+                         num_partitions,
+                         [&visitor](std::size_t partition,
+                                    const rocksdb::Slice& key,
+                                    const rocksdb::Slice& /* value */) {
+                             edge_uid_t edge;
+                             GraphKV::decode_edge(key.data(), key.size(), edge);
+                             visitor(partition, edge);
+                         },
+                         snapshot);
+}
+
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::edges_clear(bool commit) {
     rocksdb::WriteBatch batch;
     clear(batch, edges_column_);
+    if (packed()) {
+        clear(batch, adjacency_column_);
+    }
+    if (counted_) {
+        counters_clear(batch, 'E');
+    }
     return to_status(db_get()->Write(write_options(commit), &batch));
 }
 
@@ -314,26 +797,34 @@ Status GraphImpl<Orientation>::edges_insert(const vertex_uid_t& vertex1,
                         !payload.empty(),
                         commit);
     {  // check presence of both vertices
-        bool vertex_present = false;
-        vertices_has(vertex1, vertex_present).raise_on_error();
-        if (!vertex_present) {
-            return Status::error_missing_vertex(vertex1);
-        }
-        vertices_has(vertex2, vertex_present).raise_on_error();
-        if (!vertex_present) {
-            return Status::error_missing_vertex(vertex2);
+        const auto status = vertices_require({vertex1, vertex2});
+        if (!status) {
+            return status;
         }
     }
 
-    edge_keys_t keys;
-    GraphKV::encode(vertex1, vertex2, keys);
     const rocksdb::Slice data_slice(payload.data(), payload.size());
     rocksdb::WriteBatch batch;
+    Counters counters;
+    if (counted_) {
+        bool present;
+        const auto status = edges_has(vertex1, vertex2, present);
+        if (!status) {
+            return status;
+        }
+        if (!present) {
+            count_edge(counters, vertex1, vertex2, 1);
+        }
+    }
 
-    for (const auto& key: keys) {
-        batch.Put(edges_column_.get(), rocksdb::Slice(key.data(), key.size()), data_slice);
+    if (packed()) {
+        adjacency_insert(batch, vertex1, vertex2.first, AdjacencyList::ids_t{vertex2.second});
+        if (payload.empty()) {
+            return write(batch, counters, commit);
+        }
     }
-    return to_status(db_get()->Write(write_options(commit), &batch));
+    edge_put(batch, vertex1, vertex2, data_slice);
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
@@ -355,20 +846,23 @@ Status GraphImpl<Orientation>::edges_insert(
         return Status::ok();
     }
     rocksdb::WriteBatch batch;
+    Counters counters;
+    vertex_uids_t endpoints;
+    endpoints.reserve(vertices.size() + 1);
+    endpoints.push_back(vertex);
+    for (const auto to_vertex_id: vertices) {
+        endpoints.push_back(make_id(type, to_vertex_id));
+    }
     if (!create_vertices) {
-        bool vertex_present;
-        vertices_has(vertex, vertex_present).raise_on_error();
-        if (!vertex_present) {
-            return Status::error_missing_vertex(vertex);
-        }
-        for (auto to_vertex_id: vertices) {
-            const auto to_vertex = make_id(type, to_vertex_id);
-            vertices_has(to_vertex, vertex_present).raise_on_error();
-            if (!vertex_present) {
-                return Status::error_missing_vertex(to_vertex);
-            }
+        const auto status = vertices_require(endpoints);
+        if (!status) {
+            return status;
         }
     } else {
+        const auto status = count_vertex_insertions(counters, std::move(endpoints));
+        if (!status) {
+            return status;
+        }
         GraphKV::vertex_key_t key;
         GraphKV::encode(vertex, key);
         batch.Put(this->vertices_column_.get(),
@@ -386,6 +880,9 @@ Status GraphImpl<Orientation>::edges_insert(
                       rocksdb::Slice(vertex_key.data(), vertex_key.size()),
                       payload);
         }
+        if (packed()) {
+            continue;
+        }
         GraphKV::encode(vertex, target, keys[i]);
         for (const auto& key: keys[i]) {
             batch.Put(edges_column_.get(),
@@ -393,7 +890,21 @@ Status GraphImpl<Orientation>::edges_insert(
                       rocksdb::Slice());
         }
     }
-    return to_status(db_get()->Write(write_options(commit), &batch));
+    if (counted_) {
+        AdjacencyList::ids_t ids(vertices.begin(), vertices.end());
+        AdjacencyList::normalize(ids);
+        const auto status = count_edge_insertions(counters, vertex, type, ids);
+        if (!status) {
+            return status;
+        }
+    }
+    if (packed()) {
+        adjacency_insert(batch,
+                         vertex,
+                         type,
+                         AdjacencyList::ids_t(vertices.begin(), vertices.end()));
+    }
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
@@ -412,20 +923,23 @@ Status GraphImpl<Orientation>::edges_insert(const vertex_uid_t& vertex,
         return Status::ok();
     }
     rocksdb::WriteBatch batch;
+    Counters counters;
+    vertex_uids_t endpoints;
+    endpoints.reserve(vertices.size() + 1);
+    endpoints.push_back(vertex);
+    for (const auto to_vertex_id: vertices) {
+        endpoints.push_back(make_id(type, to_vertex_id));
+    }
     if (!create_vertices) {
-        bool vertex_present;
-        vertices_has(vertex, vertex_present).raise_on_error();
-        if (!vertex_present) {
-            return Status::error_missing_vertex(vertex);
-        }
-        for (auto to_vertex_id: vertices) {
-            const auto to_vertex = make_id(type, to_vertex_id);
-            vertices_has(to_vertex, vertex_present).raise_on_error();
-            if (!vertex_present) {
-                return Status::error_missing_vertex(to_vertex);
-            }
+        const auto status = vertices_require(endpoints);
+        if (!status) {
+            return status;
         }
     } else {
+        const auto status = count_vertex_insertions(counters, std::move(endpoints));
+        if (!status) {
+            return status;
+        }
         GraphKV::vertex_key_t key;
         GraphKV::encode(vertex, key);
         batch.Put(this->vertices_column_.get(),
@@ -442,6 +956,9 @@ Status GraphImpl<Orientation>::edges_insert(const vertex_uid_t& vertex,
                       rocksdb::Slice(vertex_key.data(), vertex_key.size()),
                       rocksdb::Slice());
         }
+        if (packed()) {
+            continue;
+        }
         GraphKV::encode(vertex, target, keys[i]);
         for (const auto& key: keys[i]) {
             batch.Put(edges_column_.get(),
@@ -449,7 +966,21 @@ Status GraphImpl<Orientation>::edges_insert(const vertex_uid_t& vertex,
                       rocksdb::Slice());
         }
     }
-    return to_status(db_get()->Write(write_options(commit), &batch));
+    if (counted_) {
+        AdjacencyList::ids_t ids(vertices.begin(), vertices.end());
+        AdjacencyList::normalize(ids);
+        const auto status = count_edge_insertions(counters, vertex, type, ids);
+        if (!status) {
+            return status;
+        }
+    }
+    if (packed()) {
+        adjacency_insert(batch,
+                         vertex,
+                         type,
+                         AdjacencyList::ids_t(vertices.begin(), vertices.end()));
+    }
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
@@ -462,23 +993,48 @@ Status GraphImpl<Orientation>::edges_insert(const vertex_uid_t& vertex,
                         vertex,
                         vertices,
                         commit);
-    {  // check presence of both vertices
-        bool vertex_present = false;
-        vertices_has(vertex, vertex_present).raise_on_error();
-        if (!vertex_present) {
-            return Status::error_missing_vertex(vertex);
-        }
-        for (auto const& dest_vertex: vertices) {
-            vertices_has(dest_vertex, vertex_present).raise_on_error();
-            if (!vertex_present) {
-                return Status::error_missing_vertex(dest_vertex);
-            }
+    {  // check presence of all vertices
+        vertex_uids_t required;
+        required.reserve(vertices.size() + 1);
+        required.push_back(vertex);
+        required.insert(required.end(), vertices.begin(), vertices.end());
+        const auto status = vertices_require(required);
+        if (!status) {
+            return status;
         }
     }
 
     std::vector<edge_keys_t> keys(vertices.size());
     rocksdb::WriteBatch batch;
-    if (data.empty()) {
+    Counters counters;
+    if (counted_) {
+        std::map<vertex_t, AdjacencyList::ids_t> neighbours;
+        for (const auto& target: vertices) {
+            neighbours[target.first].push_back(target.second);
+        }
+        for (auto& neighbour: neighbours) {
+            AdjacencyList::normalize(neighbour.second);
+            const auto status =
+                count_edge_insertions(counters, vertex, neighbour.first, neighbour.second);
+            if (!status) {
+                return status;
+            }
+        }
+    }
+    if (packed()) {
+        // group neighbours by type to write one merge operand per adjacency list
+        std::map<vertex_t, AdjacencyList::ids_t> neighbours;
+        for (auto i = 0ul; i < vertices.size(); ++i) {
+            neighbours[vertices[i].first].push_back(vertices[i].second);
+            if (data.empty() || sizes[i] == 0) {
+                continue;
+            }
+            edge_put(batch, vertex, vertices[i], rocksdb::Slice(data[i], sizes[i]));
+        }
+        for (auto& neighbour: neighbours) {
+            adjacency_insert(batch, vertex, neighbour.first, std::move(neighbour.second));
+        }
+    } else if (data.empty()) {
         for (auto i = 0ul; i < vertices.size(); ++i) {
             GraphKV::encode(vertex, vertices[i], keys[i]);
             for (const auto& key: keys[i]) {
@@ -489,15 +1045,47 @@ Status GraphImpl<Orientation>::edges_insert(const vertex_uid_t& vertex,
         }
     } else {
         for (auto i = 0ul; i < vertices.size(); ++i) {
-            GraphKV::encode(vertex, vertices[i], keys[i]);
-            for (const auto& key: keys[i]) {
+            edge_put(batch, vertex, vertices[i], rocksdb::Slice(data[i], sizes[i]));
+        }
+    }
+    return write(batch, counters, commit);
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::encode_payload_key(const edge_uid_t& edge,
+                                                GraphKV::edge_key_t& key) const {
+    if (canonical_payloads_ && edge.second < edge.first) {
+        GraphKV::encode(edge.second, edge.first, key);
+    } else {
+        GraphKV::encode(edge.first, edge.second, key);
+    }
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::edge_put(rocksdb::WriteBatch& batch,
+                                      const vertex_uid_t& vertex1,
+                                      const vertex_uid_t& vertex2,
+                                      const rocksdb::Slice& payload) {
+    edge_keys_t keys;
+    GraphKV::encode(vertex1, vertex2, keys);
+    if (!canonical_payloads_) {
+        for (const auto& key: keys) {
+            batch.Put(edges_column_.get(), rocksdb::Slice(key.data(), key.size()), payload);
+        }
+        return;
+    }
+    // keys of an undirected edge are (vertex1, vertex2) then (vertex2, vertex1)
+    const auto& canonical = vertex2 < vertex1 ? keys.back() : keys.front();
+    if (!packed()) {
+        for (const auto& key: keys) {
+            if (key != canonical) {
                 batch.Put(edges_column_.get(),
                           rocksdb::Slice(key.data(), key.size()),
-                          rocksdb::Slice(data[i], sizes[i]));
+                          rocksdb::Slice());
             }
         }
     }
-    return to_status(db_get()->Write(write_options(commit), &batch));
+    batch.Put(edges_column_.get(), rocksdb::Slice(canonical.data(), canonical.size()), payload);
 }
 
 template <EdgeOrientation Orientation>
@@ -505,6 +1093,25 @@ Status GraphImpl<Orientation>::edges_has(const vertex_uid_t& vertex1,
                                          const vertex_uid_t& vertex2,
                                          bool& result) const {
     logger_get()->debug("edges_has(vertex1={}, vertex2={})", vertex1, vertex2);
+    if (mapped_csr_) {
+        result = mapped_csr_->has(vertex1, vertex2);
+        return Status::ok();
+    }
+    if (packed()) {
+        GraphKV::adjacency_key_t key;
+        GraphKV::encode_adjacency(vertex1, vertex2.first, key);
+        std::string value;
+        const auto& status = db_get()->Get(default_read_options(),
+                                           adjacency_column_.get(),
+                                           rocksdb::Slice(key.data(), key.size()),
+                                           &value);
+        if (status.IsNotFound()) {
+            result = false;
+            return Status::ok();
+        }
+        result = status.ok() && AdjacencyList::contains(value.data(), value.size(), vertex2.second);
+        return to_status(status);
+    }
     GraphKV::edge_key_t key;
     GraphKV::encode(vertex1, vertex2, key);
     std::string value;
@@ -524,12 +1131,53 @@ template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::edges_get(const edge_uid_t& edge, std::string* value) const {
     logger_get()->debug("edges_get(edge={})", edge);
     GraphKV::edge_key_t key;
-    GraphKV::encode(edge.first, edge.second, key);
+    encode_payload_key(edge, key);
     const auto& status = db_get()->Get(default_read_options(),
                                        edges_column_.get(),
                                        rocksdb::Slice(key.data(), key.size()),
                                        value);
     if (status.IsNotFound()) {
+        if (packed()) {
+            // edges without payload are only stored in adjacency lists
+            bool present;
+            const auto has_status = edges_has(edge.first, edge.second, present);
+            if (!has_status) {
+                return has_status;
+            }
+            if (present) {
+                value->clear();
+                return Status::ok();
+            }
+        }
+        return Status::error_missing_edge(edge);
+    }
+    return to_status(status);
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_get(const edge_uid_t& edge, PayloadView& value) const {
+    logger_get()->debug("edges_get(edge={}, view=true)", edge);
+    GraphKV::edge_key_t key;
+    encode_payload_key(edge, key);
+    auto& slice = value.slice();
+    slice.Reset();
+    value.keep_alive(edges_column_);
+    const auto& status = db_get()->Get(default_read_options(),
+                                       edges_column_.get(),
+                                       rocksdb::Slice(key.data(), key.size()),
+                                       &slice);
+    if (status.IsNotFound()) {
+        if (packed()) {
+            // edges without payload are only stored in adjacency lists
+            bool present;
+            const auto has_status = edges_has(edge.first, edge.second, present);
+            if (!has_status) {
+                return has_status;
+            }
+            if (present) {
+                return Status::ok();
+            }
+        }
         return Status::error_missing_edge(edge);
     }
     return to_status(status);
@@ -538,10 +1186,36 @@ Status GraphImpl<Orientation>::edges_get(const edge_uid_t& edge, std::string* va
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::edges_get(const vertex_uid_t& vertex, vertex_uids_t& edges) const {
     logger_get()->debug("edges_get(vertex={})", vertex);
+    if (mapped_csr_) {
+        mapped_csr_->get(vertex, edges);
+        return Status::ok();
+    }
+    if (packed()) {
+        GraphKV::adjacency_key_prefix_t key;
+        GraphKV::encode_adjacency_prefix(vertex, key);
+        const rocksdb::Slice prefix(key.data(), key.size());
+        auto iter = iterators_->iterate(adjacency_column_.get(), prefix);
+        AdjacencyList::ids_t ids;
+        vertex_uid_t source;
+        vertex_t type;
+        for (iter->Seek(prefix); iter->Valid(); iter->Next()) {
+            const auto& adjacency_key = iter->key();
+            if (std::memcmp(key.data(), adjacency_key.data(), key.size()) != 0) {
+                break;
+            }
+            GraphKV::decode_adjacency(adjacency_key.data(), adjacency_key.size(), source, type);
+            ids.clear();
+            AdjacencyList::decode(iter->value().data(), iter->value().size(), ids);
+            for (const auto id: ids) {
+                edges.emplace_back(type, id);
+            }
+        }
+        return to_status(iter->status());
+    }
     GraphKV::edge_key_prefix_t key;
     GraphKV::encode_edge_prefix(vertex, key);
     const rocksdb::Slice slice(key.data(), key.size());
-    auto iter = db_get()->NewIterator(default_read_options(), this->edges_column_.get());
+    auto iter = iterators_->iterate(edges_column_.get(), slice);
     iter->Seek(slice);
     while (iter->Valid()) {
         auto const& conn_key = iter->key();
@@ -561,10 +1235,22 @@ Status GraphImpl<Orientation>::edges_get(const vertex_uid_t& vertex,
                                          vertex_t filter,
                                          vertex_uids_t& edges) const {
     logger_get()->debug("edges_get(vertex={}, filter={}, edges_column_={})", vertex, filter, edges);
+    if (mapped_csr_) {
+        mapped_csr_->get(vertex, filter, edges);
+        return Status::ok();
+    }
+    if (packed()) {
+        AdjacencyList::ids_t ids;
+        const auto status = adjacency_get(vertex, filter, ids);
+        for (const auto id: ids) {
+            edges.emplace_back(filter, id);
+        }
+        return status;
+    }
     GraphKV::edge_key_type_prefix_t key;
     GraphKV::encode_edge_prefix(vertex, filter, key);
     const rocksdb::Slice slice(key.data(), key.size());
-    auto iter = db_get()->NewIterator(default_read_options(), this->edges_column_.get());
+    auto iter = iterators_->iterate(edges_column_.get(), slice);
     iter->Seek(slice);
     if (!iter->status().ok()) {
         return to_status(iter->status());
@@ -583,34 +1269,823 @@ Status GraphImpl<Orientation>::edges_get(const vertex_uid_t& vertex,
 }
 
 template <EdgeOrientation Orientation>
-Status GraphImpl<Orientation>::edges_erase(const vertex_uid_t& vertex1,
-                                           const vertex_uid_t& vertex2,
+Status GraphImpl<Orientation>::edges_get(const vertex_uid_t& vertex,
+                                         vertex_t filter,
+                                         vertex_id_t first,
+                                         vertex_id_t last,
+                                         vertex_uids_t& edges) const {
+    logger_get()->debug("edges_get(vertex={}, filter={}, first={}, last={})",
+                        vertex,
+                        filter,
+                        first,
+                        last);
+    if (first >= last) {
+        return Status::ok();
+    }
+    if (mapped_csr_) {
+        mapped_csr_->get(vertex, filter, first, last, edges);
+        return Status::ok();
+    }
+    if (packed()) {
+        AdjacencyList::ids_t ids;
+        const auto status = adjacency_get(vertex, filter, ids);
+        for (auto id = std::lower_bound(ids.begin(), ids.end(), first);
+             id != ids.end() && *id < last;
+             ++id) {
+            edges.emplace_back(filter, *id);
+        }
+        return status;
+    }
+    GraphKV::edge_key_t lower_key;
+    GraphKV::edge_key_t upper_key;
+    GraphKV::encode(vertex, make_id(filter, first), lower_key);
+    GraphKV::encode(vertex, make_id(filter, last), upper_key);
+    auto iter = iterators_->iterate_until(edges_column_.get(),
+                                          rocksdb::Slice(upper_key.data(), upper_key.size()));
+    vertex_uid_t dest;
+    for (iter->Seek(rocksdb::Slice(lower_key.data(), lower_key.size())); iter->Valid();
+         iter->Next()) {
+        const auto& key = iter->key();
+        GraphKV::decode_edge_dest(key.data(), key.size(), dest);
+        edges.push_back(dest);
+    }
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_get(const vertex_uid_t& vertex,
+                                         vertex_t filter,
+                                         std::vector<vertex_id_t>& ids) const {
+    logger_get()->debug("edges_get(vertex={}, filter={}, ids)", vertex, filter);
+    if (mapped_csr_) {
+        mapped_csr_->get(vertex, filter, ids);
+        return Status::ok();
+    }
+    if (packed()) {
+        // adjacency lists already hold the identifiers only
+        return adjacency_get(vertex, filter, ids);
+    }
+    GraphKV::edge_key_type_prefix_t key;
+    GraphKV::encode_edge_prefix(vertex, filter, key);
+    const rocksdb::Slice slice(key.data(), key.size());
+    auto iter = iterators_->iterate(edges_column_.get(), slice);
+    for (iter->Seek(slice); iter->Valid(); iter->Next()) {
+        const auto& conn_key = iter->key();
+        if (std::memcmp(key.data(), conn_key.data(), key.size()) != 0) {
+            break;
+        }
+        ids.push_back(GraphKV::decode_edge_dest_id(conn_key.data(), conn_key.size()));
+    }
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_get(const vertex_uid_t& vertex,
+                                         std::vector<vertex_t>& types,
+                                         std::vector<vertex_id_t>& ids) const {
+    logger_get()->debug("edges_get(vertex={}, types, ids)", vertex);
+    if (mapped_csr_) {
+        mapped_csr_->get(vertex, types, ids);
+        return Status::ok();
+    }
+    if (packed()) {
+        GraphKV::adjacency_key_prefix_t key;
+        GraphKV::encode_adjacency_prefix(vertex, key);
+        const rocksdb::Slice prefix(key.data(), key.size());
+        auto iter = iterators_->iterate(adjacency_column_.get(), prefix);
+        vertex_uid_t source;
+        vertex_t type;
+        for (iter->Seek(prefix); iter->Valid(); iter->Next()) {
+            const auto& adjacency_key = iter->key();
+            if (std::memcmp(key.data(), adjacency_key.data(), key.size()) != 0) {
+                break;
+            }
+            GraphKV::decode_adjacency(adjacency_key.data(), adjacency_key.size(), source, type);
+            const auto count = ids.size();
+            AdjacencyList::decode(iter->value().data(), iter->value().size(), ids);
+            types.insert(types.end(), ids.size() - count, type);
+        }
+        return to_status(iter->status());
+    }
+    GraphKV::edge_key_prefix_t key;
+    GraphKV::encode_edge_prefix(vertex, key);
+    const rocksdb::Slice slice(key.data(), key.size());
+    auto iter = iterators_->iterate(edges_column_.get(), slice);
+    for (iter->Seek(slice); iter->Valid(); iter->Next()) {
+        const auto& conn_key = iter->key();
+        if (std::memcmp(key.data(), conn_key.data(), key.size()) != 0) {
+            break;
+        }
+        GraphKV::decode_edge_dest(conn_key.data(), conn_key.size(), types, ids);
+    }
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_get_with_payloads(const vertex_uid_t& vertex,
+                                                       vertex_uids_t& edges,
+                                                       std::string& payloads,
+                                                       std::vector<std::size_t>& offsets) const {
+    logger_get()->debug("edges_get_with_payloads(vertex={})", vertex);
+    return edges_scan_payloads(
+        vertex,
+        nullptr,
+        [&edges](const vertex_uid_t& target) { edges.push_back(target); },
+        payloads,
+        offsets);
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_get_with_payloads(const vertex_uid_t& vertex,
+                                                       vertex_t filter,
+                                                       std::vector<vertex_id_t>& ids,
+                                                       std::string& payloads,
+                                                       std::vector<std::size_t>& offsets) const {
+    logger_get()->debug("edges_get_with_payloads(vertex={}, filter={})", vertex, filter);
+    return edges_scan_payloads(
+        vertex,
+        &filter,
+        [&ids](const vertex_uid_t& target) { ids.push_back(target.second); },
+        payloads,
+        offsets);
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_scan_payloads(
+    const vertex_uid_t& vertex,
+    const vertex_t* filter,
+    const std::function<void(const vertex_uid_t&)>& visitor,
+    std::string& payloads,
+    std::vector<std::size_t>& offsets) const {
+    if (offsets.empty()) {
+        offsets.push_back(payloads.size());
+    }
+    GraphKV::edge_key_type_prefix_t key;
+    std::size_t prefix_size;
+    if (filter != nullptr) {
+        GraphKV::encode_edge_prefix(vertex, *filter, key);
+        prefix_size = key.size();
+    } else {
+        GraphKV::edge_key_prefix_t vertex_key;
+        GraphKV::encode_edge_prefix(vertex, vertex_key);
+        std::copy(vertex_key.begin(), vertex_key.end(), key.begin());
+        prefix_size = vertex_key.size();
+    }
+    const rocksdb::Slice prefix(key.data(), prefix_size);
+    auto iter = iterators_->iterate(edges_column_.get(), prefix);
+    // targets smaller than the vertex come first in key order, their payloads
+    // may be stored under the reversed keys
+    vertex_uids_t reversed;
+
+    if (!packed()) {
+        for (iter->Seek(prefix); iter->Valid(); iter->Next()) {
+            const auto& edge_key = iter->key();
+            if (std::memcmp(key.data(), edge_key.data(), prefix_size) != 0) {
+                break;
+            }
+            vertex_uid_t target;
+            GraphKV::decode_edge_dest(edge_key.data(), edge_key.size(), target);
+            visitor(target);
+            if (canonical_payloads_ && target < vertex) {
+                reversed.push_back(target);
+                continue;
+            }
+            if (!reversed.empty()) {
+                const auto status = edges_reversed_payloads(vertex, reversed, payloads, offsets);
+                if (!status) {
+                    return status;
+                }
+                reversed.clear();
+            }
+            payloads.append(iter->value().data(), iter->value().size());
+            offsets.push_back(payloads.size());
+        }
+        if (!iter->status().ok()) {
+            return to_status(iter->status());
+        }
+        return edges_reversed_payloads(vertex, reversed, payloads, offsets);
+    }
+
+    // adjacency lists give the targets, the edges column family only holds
+    // the keys of the edges having a payload
+    vertex_uids_t targets;
+    const auto status = filter != nullptr ? edges_get(vertex, *filter, targets)
+                                          : edges_get(vertex, targets);
+    if (!status) {
+        return status;
+    }
+    auto target = targets.begin();
+    for (; target != targets.end() && canonical_payloads_ && *target < vertex; ++target) {
+        visitor(*target);
+        reversed.push_back(*target);
+    }
+    {
+        const auto reversed_status = edges_reversed_payloads(vertex, reversed, payloads, offsets);
+        if (!reversed_status) {
+            return reversed_status;
+        }
+    }
+    if (target == targets.end()) {
+        return Status::ok();
+    }
+    GraphKV::edge_key_t first_key;
+    GraphKV::encode(vertex, *target, first_key);
+    vertex_uid_t current{};
+    iter->Seek(rocksdb::Slice(first_key.data(), first_key.size()));
+    for (; target != targets.end(); ++target) {
+        visitor(*target);
+        // both the targets and the keys are sorted, merge them
+        while (iter->Valid() && std::memcmp(key.data(), iter->key().data(), prefix_size) == 0) {
+            GraphKV::decode_edge_dest(iter->key().data(), iter->key().size(), current);
+            if (!(current < *target)) {
+                break;
+            }
+            iter->Next();
+        }
+        if (iter->Valid() && std::memcmp(key.data(), iter->key().data(), prefix_size) == 0 &&
+            current == *target) {
+            payloads.append(iter->value().data(), iter->value().size());
+        }
+        offsets.push_back(payloads.size());
+    }
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_reversed_payloads(const vertex_uid_t& vertex,
+                                                       const vertex_uids_t& targets,
+                                                       std::string& payloads,
+                                                       std::vector<std::size_t>& offsets) const {
+    // the reversed keys are sorted like the targets
+    const auto batch_size = std::min(targets.size(), multiget_batch_size);
+    std::vector<GraphKV::edge_key_t> keys(batch_size);
+    std::vector<rocksdb::Slice> slices(batch_size);
+    std::vector<rocksdb::PinnableSlice> values(batch_size);
+    std::vector<rocksdb::Status> statuses(batch_size);
+    for (auto first = 0ul; first < targets.size(); first += batch_size) {
+        const auto count = std::min(batch_size, targets.size() - first);
+        for (auto i = 0ul; i < count; ++i) {
+            GraphKV::encode(targets[first + i], vertex, keys[i]);
+            slices[i] = rocksdb::Slice(keys[i].data(), keys[i].size());
+            values[i].Reset();
+        }
+        db_get()->MultiGet(default_read_options(),
+                           edges_column_.get(),
+                           count,
+                           slices.data(),
+                           values.data(),
+                           statuses.data(),
+                           true);
+        for (auto i = 0ul; i < count; ++i) {
+            if (statuses[i].ok()) {
+                payloads.append(values[i].data(), values[i].size());
+            } else if (!statuses[i].IsNotFound()) {
+                return to_status(statuses[i]);
+            }
+            offsets.push_back(payloads.size());
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::edges_degree(rocksdb::Iterator& iter,
+                                          const vertex_uid_t& vertex,
+                                          std::size_t& degree) const {
+    std::size_t edges = 0;
+    if (packed()) {
+        GraphKV::adjacency_key_prefix_t key;
+        GraphKV::encode_adjacency_prefix(vertex, key);
+        for (iter.Seek(rocksdb::Slice(key.data(), key.size())); iter.Valid(); iter.Next()) {
+            if (std::memcmp(key.data(), iter.key().data(), key.size()) != 0) {
+                break;
+            }
+            edges += AdjacencyList::count(iter.value().data(), iter.value().size());
+        }
+    } else {
+        GraphKV::edge_key_prefix_t key;
+        GraphKV::encode_edge_prefix(vertex, key);
+        for (iter.Seek(rocksdb::Slice(key.data(), key.size())); iter.Valid(); iter.Next()) {
+            if (std::memcmp(key.data(), iter.key().data(), key.size()) != 0) {
+                break;
+            }
+            ++edges;
+        }
+    }
+    degree = edges;
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_degree(const vertex_uid_t& vertex,
+                                            std::size_t& degree) const {
+    logger_get()->debug("edges_degree(vertex={})", vertex);
+    if (mapped_csr_) {
+        degree = mapped_csr_->degree(vertex);
+        return Status::ok();
+    }
+    auto iter = packed() ? iterators_->iterate(adjacency_column_.get(), 'A')
+                         : iterators_->iterate(edges_column_.get(), 'E');
+    edges_degree(*iter, vertex, degree);
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_degree(const vertex_uid_t& vertex,
+                                            vertex_t filter,
+                                            std::size_t& degree) const {
+    logger_get()->debug("edges_degree(vertex={}, filter={})", vertex, filter);
+    if (mapped_csr_) {
+        degree = mapped_csr_->degree(vertex, filter);
+        return Status::ok();
+    }
+    if (packed()) {
+        GraphKV::adjacency_key_t key;
+        GraphKV::encode_adjacency(vertex, filter, key);
+        rocksdb::PinnableSlice value;
+        const auto& status = db_get()->Get(default_read_options(),
+                                           adjacency_column_.get(),
+                                           rocksdb::Slice(key.data(), key.size()),
+                                           &value);
+        if (status.IsNotFound()) {
+            degree = 0;
+            return Status::ok();
+        }
+        if (status.ok()) {
+            degree = AdjacencyList::count(value.data(), value.size());
+        }
+        return to_status(status);
+    }
+    GraphKV::edge_key_type_prefix_t key;
+    GraphKV::encode_edge_prefix(vertex, filter, key);
+    const rocksdb::Slice prefix(key.data(), key.size());
+    auto iter = iterators_->iterate(edges_column_.get(), prefix);
+    std::size_t edges = 0;
+    for (iter->Seek(prefix); iter->Valid(); iter->Next()) {
+        if (std::memcmp(key.data(), iter->key().data(), key.size()) != 0) {
+            break;
+        }
+        ++edges;
+    }
+    degree = edges;
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_degree(const gsl::span<const vertex_t> types,
+                                            const gsl::span<const vertex_id_t> ids,
+                                            const gsl::span<std::size_t> degrees) const {
+    logger_get()->debug("edges_degree(vertices={})", types.size());
+    if (mapped_csr_) {
+        for (auto i = 0ul; i < types.size(); ++i) {
+            degrees[i] = mapped_csr_->degree(make_id(types[i], ids[i]));
+        }
+        return Status::ok();
+    }
+    // a single iterator is reused for all vertices
+    auto iter = packed() ? iterators_->iterate(adjacency_column_.get(), 'A')
+                         : iterators_->iterate(edges_column_.get(), 'E');
+    for (auto i = 0ul; i < types.size(); ++i) {
+        edges_degree(*iter, make_id(types[i], ids[i]), degrees[i]);
+        if (!iter->status().ok()) {
+            return to_status(iter->status());
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::edges_get(rocksdb::Iterator& iter,
+                                       const vertex_uid_t& vertex,
+                                       vertex_t filter,
+                                       std::vector<vertex_id_t>& ids) const {
+    if (packed()) {
+        GraphKV::adjacency_key_t key;
+        GraphKV::encode_adjacency(vertex, filter, key);
+        const rocksdb::Slice slice(key.data(), key.size());
+        iter.Seek(slice);
+        if (iter.Valid() && iter.key() == slice) {
+            AdjacencyList::decode(iter.value().data(), iter.value().size(), ids);
+        }
+        return;
+    }
+    GraphKV::edge_key_type_prefix_t key;
+    GraphKV::encode_edge_prefix(vertex, filter, key);
+    for (iter.Seek(rocksdb::Slice(key.data(), key.size())); iter.Valid(); iter.Next()) {
+        const auto& edge_key = iter.key();
+        if (std::memcmp(key.data(), edge_key.data(), key.size()) != 0) {
+            break;
+        }
+        ids.push_back(GraphKV::decode_edge_dest_id(edge_key.data(), edge_key.size()));
+    }
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::edges_get(rocksdb::Iterator& iter,
+                                       const vertex_uid_t& vertex,
+                                       vertex_uids_t& edges) const {
+    if (packed()) {
+        GraphKV::adjacency_key_prefix_t key;
+        GraphKV::encode_adjacency_prefix(vertex, key);
+        AdjacencyList::ids_t ids;
+        vertex_uid_t source;
+        vertex_t type;
+        for (iter.Seek(rocksdb::Slice(key.data(), key.size())); iter.Valid(); iter.Next()) {
+            const auto& adjacency_key = iter.key();
+            if (std::memcmp(key.data(), adjacency_key.data(), key.size()) != 0) {
+                break;
+            }
+            GraphKV::decode_adjacency(adjacency_key.data(), adjacency_key.size(), source, type);
+            ids.clear();
+            AdjacencyList::decode(iter.value().data(), iter.value().size(), ids);
+            for (const auto id: ids) {
+                edges.emplace_back(type, id);
+            }
+        }
+        return;
+    }
+    GraphKV::edge_key_prefix_t key;
+    GraphKV::encode_edge_prefix(vertex, key);
+    vertex_uid_t dest;
+    for (iter.Seek(rocksdb::Slice(key.data(), key.size())); iter.Valid(); iter.Next()) {
+        const auto& edge_key = iter.key();
+        if (std::memcmp(key.data(), edge_key.data(), key.size()) != 0) {
+            break;
+        }
+        GraphKV::decode_edge_dest(edge_key.data(), edge_key.size(), dest);
+        edges.push_back(dest);
+    }
+}
+
+/// size ratio of two lists from which the longer one is visited with exponential searches
+static constexpr std::size_t galloping_ratio = 32;
+
+/**
+ * \brief intersect two sorted lists without duplicates. When one list is
+ * much shorter, the other one is skipped through with exponential then binary searches
+ * instead of being visited element by element.
+ * \param result accumulator where the elements in both lists are added, sorted
+ */
+template <typename T>
+static void intersect(const std::vector<T>& lhs,
+                      const std::vector<T>& rhs,
+                      std::vector<T>& result) {
+    const auto& shorter = lhs.size() <= rhs.size() ? lhs : rhs;
+    const auto& longer = lhs.size() <= rhs.size() ? rhs : lhs;
+    if (shorter.size() * galloping_ratio >= longer.size()) {
+        std::set_intersection(lhs.begin(),
+                              lhs.end(),
+                              rhs.begin(),
+                              rhs.end(),
+                              std::back_inserter(result));
+        return;
+    }
+    // elements before position are smaller than the current identifier
+    auto position = longer.begin();
+    for (const auto& id: shorter) {
+        std::ptrdiff_t step = 1;
+        while (longer.end() - position > step && position[step] < id) {
+            position += step;
+            step *= 2;
+        }
+        const auto last = longer.end() - position > step ? position + step + 1 : longer.end();
+        position = std::lower_bound(position, last, id);
+        if (position == longer.end()) {
+            break;
+        }
+        if (*position == id) {
+            result.push_back(id);
+            ++position;
+        }
+    }
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_common(const vertex_uid_t& vertex1,
+                                            const vertex_uid_t& vertex2,
+                                            vertex_uids_t& vertices) const {
+    vertices.clear();
+    if (mapped_csr_) {
+        vertex_uids_t lhs;
+        vertex_uids_t rhs;
+        mapped_csr_->get(vertex1, lhs);
+        mapped_csr_->get(vertex2, rhs);
+        intersect(lhs, rhs, vertices);
+        return Status::ok();
+    }
+    // both lists are visited in lockstep from the same state of the database,
+    // the iterator behind seeks to the position of the other one
+    const auto snapshot = iterators_->snapshot();
+    if (packed()) {
+        auto iter1 = iterators_->iterate(adjacency_column_.get(), 'A', snapshot);
+        auto iter2 = iterators_->iterate(adjacency_column_.get(), 'A', snapshot);
+        GraphKV::adjacency_key_prefix_t prefix1;
+        GraphKV::adjacency_key_prefix_t prefix2;
+        GraphKV::encode_adjacency_prefix(vertex1, prefix1);
+        GraphKV::encode_adjacency_prefix(vertex2, prefix2);
+        const auto in_prefix = [](const rocksdb::Iterator& iter,
+                                  const GraphKV::adjacency_key_prefix_t& prefix) {
+            return iter.Valid() &&
+                   std::memcmp(prefix.data(), iter.key().data(), prefix.size()) == 0;
+        };
+        AdjacencyList::ids_t ids1;
+        AdjacencyList::ids_t ids2;
+        AdjacencyList::ids_t ids;
+        GraphKV::adjacency_key_t key;
+        vertex_uid_t source;
+        vertex_t type1;
+        vertex_t type2;
+        iter1->Seek(rocksdb::Slice(prefix1.data(), prefix1.size()));
+        iter2->Seek(rocksdb::Slice(prefix2.data(), prefix2.size()));
+        while (in_prefix(*iter1, prefix1) && in_prefix(*iter2, prefix2)) {
+            GraphKV::decode_adjacency(iter1->key().data(), iter1->key().size(), source, type1);
+            GraphKV::decode_adjacency(iter2->key().data(), iter2->key().size(), source, type2);
+            if (type1 < type2) {
+                GraphKV::encode_adjacency(vertex1, type2, key);
+                iter1->Seek(rocksdb::Slice(key.data(), key.size()));
+            } else if (type2 < type1) {
+                GraphKV::encode_adjacency(vertex2, type1, key);
+                iter2->Seek(rocksdb::Slice(key.data(), key.size()));
+            } else {
+                // one list per type, intersected once decoded
+                ids1.clear();
+                ids2.clear();
+                ids.clear();
+                AdjacencyList::decode(iter1->value().data(), iter1->value().size(), ids1);
+                AdjacencyList::decode(iter2->value().data(), iter2->value().size(), ids2);
+                intersect(ids1, ids2, ids);
+                for (const auto id: ids) {
+                    vertices.emplace_back(type1, id);
+                }
+                iter1->Next();
+                iter2->Next();
+            }
+        }
+        if (!iter1->status().ok()) {
+            return to_status(iter1->status());
+        }
+        return to_status(iter2->status());
+    }
+    auto iter1 = iterators_->iterate(edges_column_.get(), 'E', snapshot);
+    auto iter2 = iterators_->iterate(edges_column_.get(), 'E', snapshot);
+    GraphKV::edge_key_prefix_t prefix1;
+    GraphKV::edge_key_prefix_t prefix2;
+    GraphKV::encode_edge_prefix(vertex1, prefix1);
+    GraphKV::encode_edge_prefix(vertex2, prefix2);
+    const auto in_prefix = [](const rocksdb::Iterator& iter,
+                              const GraphKV::edge_key_prefix_t& prefix) {
+        return iter.Valid() && std::memcmp(prefix.data(), iter.key().data(), prefix.size()) == 0;
+    };
+    GraphKV::edge_key_t key;
+    vertex_uid_t dest1;
+    vertex_uid_t dest2;
+    iter1->Seek(rocksdb::Slice(prefix1.data(), prefix1.size()));
+    iter2->Seek(rocksdb::Slice(prefix2.data(), prefix2.size()));
+    while (in_prefix(*iter1, prefix1) && in_prefix(*iter2, prefix2)) {
+        GraphKV::decode_edge_dest(iter1->key().data(), iter1->key().size(), dest1);
+        GraphKV::decode_edge_dest(iter2->key().data(), iter2->key().size(), dest2);
+        if (dest1 < dest2) {
+            GraphKV::encode(vertex1, dest2, key);
+            iter1->Seek(rocksdb::Slice(key.data(), key.size()));
+        } else if (dest2 < dest1) {
+            GraphKV::encode(vertex2, dest1, key);
+            iter2->Seek(rocksdb::Slice(key.data(), key.size()));
+        } else {
+            vertices.push_back(dest1);
+            iter1->Next();
+            iter2->Next();
+        }
+    }
+    if (!iter1->status().ok()) {
+        return to_status(iter1->status());
+    }
+    return to_status(iter2->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_combine(SetOperation operation,
+                                             const vertex_uids_t& vertices,
+                                             vertex_t filter,
+                                             std::vector<vertex_id_t>& ids) const {
+    ids.clear();
+    if (vertices.empty()) {
+        return Status::ok();
+    }
+    // all lists are read from the same state of the database
+    std::unique_ptr<ManagedIterator> iter;
+    if (!mapped_csr_) {
+        iter.reset(new ManagedIterator(
+            packed() ? iterators_->iterate(adjacency_column_.get(), 'A')
+                     : iterators_->iterate(edges_column_.get(), 'E')));
+    }
+    const auto fetch = [&](const vertex_uid_t& vertex, std::vector<vertex_id_t>& list) {
+        list.clear();
+        if (mapped_csr_) {
+            mapped_csr_->get(vertex, filter, list);
+            return rocksdb::Status::OK();
+        }
+        edges_get(**iter, vertex, filter, list);
+        return (*iter)->status();
+    };
+    auto status = fetch(vertices.front(), ids);
+    std::vector<vertex_id_t> list;
+    std::vector<vertex_id_t> result;
+    for (auto vertex = std::next(vertices.begin()); vertex != vertices.end() && status.ok();
+         ++vertex) {
+        if (ids.empty() && operation != SetOperation::set_union) {
+            // nothing left to intersect with or to subtract from
+            break;
+        }
+        status = fetch(*vertex, list);
+        result.clear();
+        switch (operation) {
+        case SetOperation::set_intersection:
+            intersect(ids, list, result);
+            break;
+        case SetOperation::set_union:
+            std::set_union(
+                ids.begin(), ids.end(), list.begin(), list.end(), std::back_inserter(result));
+            break;
+        case SetOperation::set_difference:
+            std::set_difference(
+                ids.begin(), ids.end(), list.begin(), list.end(), std::back_inserter(result));
+            break;
+        }
+        ids.swap(result);
+    }
+    if (!status.ok()) {
+        ids.clear();
+        return to_status(status);
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_get_many(const gsl::span<const vertex_t> types,
+                                              const gsl::span<const vertex_id_t> ids,
+                                              vertex_t filter,
+                                              std::vector<std::size_t>& offsets,
+                                              std::vector<vertex_id_t>& neighbours,
+                                              std::size_t num_threads) const {
+    logger_get()->debug("edges_get_many(vertices={}, filter={}, num_threads={})",
+                        types.size(),
+                        filter,
+                        num_threads);
+    const auto num_vertices = static_cast<std::size_t>(types.size());
+    // visit the vertices in the order of their keys so that the iterator
+    // only moves forward
+    std::vector<std::size_t> order(num_vertices);
+    for (auto i = 0ul; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&types, &ids](std::size_t lhs, std::size_t rhs) {
+        return std::make_pair(types[lhs], ids[lhs]) < std::make_pair(types[rhs], ids[rhs]);
+    });
+
+    // neighbours of the vertices of every chunk of the sorted vertices
+    const auto num_chunks = std::max(
+        1ul,
+        std::min(scan_partitions(num_threads),
+                 (num_vertices + get_many_chunk_size - 1) / get_many_chunk_size));
+    const auto chunk_size = (num_vertices + num_chunks - 1) / num_chunks;
+    std::vector<std::vector<vertex_id_t>> chunk_neighbours(num_chunks);
+    std::vector<std::size_t> counts(num_vertices);
+    std::vector<rocksdb::Status> statuses(num_chunks);
+    // all chunks are read from the same state of the database
+    const auto snapshot = num_chunks > 1 ? iterators_->snapshot() : snapshot_ptr_t{};
+    const auto visit_chunk = [&](std::size_t chunk) {
+        auto& result = chunk_neighbours[chunk];
+        const auto first = std::min(num_vertices, chunk * chunk_size);
+        const auto last = std::min(num_vertices, first + chunk_size);
+        if (mapped_csr_) {
+            for (auto i = first; i < last; ++i) {
+                const auto size = result.size();
+                mapped_csr_->get(make_id(types[order[i]], ids[order[i]]), filter, result);
+                counts[order[i]] = result.size() - size;
+            }
+            return;
+        }
+        auto iter = packed() ? iterators_->iterate(adjacency_column_.get(), 'A', snapshot)
+                             : iterators_->iterate(edges_column_.get(), 'E', snapshot);
+        for (auto i = first; i < last; ++i) {
+            const auto size = result.size();
+            edges_get(*iter, make_id(types[order[i]], ids[order[i]]), filter, result);
+            if (!iter->status().ok()) {
+                statuses[chunk] = iter->status();
+                return;
+            }
+            counts[order[i]] = result.size() - size;
+        }
+    };
+    if (num_chunks == 1) {
+        visit_chunk(0);
+    } else {
+        ThreadPool pool(num_chunks);
+        pool.parallel_for(num_chunks, visit_chunk);
+    }
+    for (const auto& status: statuses) {
+        if (!status.ok()) {
+            return to_status(status);
+        }
+    }
+
+    // lay the neighbours out in the order of the input vertices
+    offsets.assign(num_vertices + 1, 0);
+    for (auto i = 0ul; i < num_vertices; ++i) {
+        offsets[i + 1] = offsets[i] + counts[i];
+    }
+    neighbours.resize(offsets.back());
+    for (auto chunk = 0ul; chunk < num_chunks; ++chunk) {
+        const auto first = std::min(num_vertices, chunk * chunk_size);
+        const auto last = std::min(num_vertices, first + chunk_size);
+        auto source = chunk_neighbours[chunk].cbegin();
+        for (auto i = first; i < last; ++i) {
+            const auto vertex = order[i];
+            std::copy(source,
+                      source + static_cast<std::ptrdiff_t>(counts[vertex]),
+                      neighbours.begin() + static_cast<std::ptrdiff_t>(offsets[vertex]));
+            source += static_cast<std::ptrdiff_t>(counts[vertex]);
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_erase(const vertex_uid_t& vertex1,
+                                           const vertex_uid_t& vertex2,
                                            bool commit) {
     logger_get()->debug("edges_erase(vertex1={}, vertex2={}, commit={})", vertex1, vertex2, commit);
 
     edge_keys_t keys;
     GraphKV::encode(vertex1, vertex2, keys);
     rocksdb::WriteBatch batch;
+    Counters counters;
+    if (counted_) {
+        bool present;
+        const auto status = edges_has(vertex1, vertex2, present);
+        if (!status) {
+            return status;
+        }
+        if (present) {
+            count_edge(counters, vertex1, vertex2, -1);
+        }
+    }
 
+    if (packed()) {
+        std::string operand;
+        GraphKV::adjacency_key_t key;
+        GraphKV::encode_adjacency(vertex1, vertex2.first, key);
+        AdjacencyList::encode_operand(AdjacencyList::removal_op, {vertex2.second}, operand);
+        batch.Merge(adjacency_column_.get(), rocksdb::Slice(key.data(), key.size()), operand);
+        if (Orientation == EdgeOrientation::undirected) {
+            GraphKV::encode_adjacency(vertex2, vertex1.first, key);
+            AdjacencyList::encode_operand(AdjacencyList::removal_op, {vertex1.second}, operand);
+            batch.Merge(adjacency_column_.get(), rocksdb::Slice(key.data(), key.size()), operand);
+        }
+    }
+    // also removes the payload in packed mode
     for (const auto& key: keys) {
         batch.Delete(edges_column_.get(), rocksdb::Slice(key.data(), key.size()));
     }
-    return to_status(db_get()->Write(write_options(commit), &batch));
+    return write(batch, counters, commit);
 }
 
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::edges_erase(rocksdb::WriteBatch& batch,
+                                           Counters& counters,
                                            const vertex_uid_t& vertex,
                                            size_t& removed) {
+    if (packed()) {
+        GraphKV::adjacency_key_prefix_t key;
+        GraphKV::encode_adjacency_prefix(vertex, key);
+        const rocksdb::Slice prefix(key.data(), key.size());
+        auto iter = iterators_->iterate(adjacency_column_.get(), prefix);
+        auto edges = 0ul;
+        for (iter->Seek(prefix); iter->Valid(); iter->Next()) {
+            if (std::memcmp(key.data(), iter->key().data(), key.size()) != 0) {
+                break;
+            }
+            const auto status =
+                adjacency_erase(batch, counters, vertex, iter->key(), iter->value(), edges);
+            if (!status) {
+                return status;
+            }
+        }
+        const auto status = iter->status();
+        if (status.ok()) {
+            removed = edges;
+        }
+        return to_status(status);
+    }
     GraphKV::edge_key_prefix_t key;
     GraphKV::encode_edge_prefix(vertex, key);
     const rocksdb::Slice slice(key.data(), key.size());
 
-    auto iter = db_get()->NewIterator(default_read_options(), edges_column_.get());
+    auto iter = iterators_->iterate(edges_column_.get(), slice);
     iter->Seek(slice);
 
     // iterate over all edges
     auto edges = 0ul;
+    vertex_uids_t targets;
     while (iter->Valid()) {
         // remove the key
         auto const& conn_slice = iter->key();
@@ -619,6 +2094,9 @@ Status GraphImpl<Orientation>::edges_erase(rocksdb::WriteBatch& batch,
             break;
         }
         batch.Delete(this->edges_column_.get(), conn_slice);
+        vertex_uid_t dest;
+        GraphKV::decode_edge_dest(conn_slice.data(), conn_slice.size(), dest);
+        targets.push_back(dest);
 
         // remove the reverse edge
         GraphKV::edge_key_t reversed_key;
@@ -628,11 +2106,14 @@ Status GraphImpl<Orientation>::edges_erase(rocksdb::WriteBatch& batch,
         ++edges;
         iter->Next();
     }
-    const auto status = iter->status();
-    if (status.ok()) {
+    if (!iter->status().ok()) {
+        return to_status(iter->status());
+    }
+    const auto status = count_edge_erasures(counters, vertex, targets);
+    if (status) {
         removed = edges;
     }
-    return to_status(status);
+    return status;
 }
 
 template <EdgeOrientation Orientation>
@@ -641,13 +2122,16 @@ Status GraphImpl<Orientation>::edges_erase(const vertex_uid_t& vertex,
                                            bool commit) {
     logger_get()->debug("edges_erase(vertex={}, commit={})", vertex, commit);
     rocksdb::WriteBatch batch;
+    Counters counters;
     auto edges = 0ul;
-    edges_erase(batch, vertex, edges).raise_on_error();
-    auto const& status = to_status(db_get()->Write(write_options(commit), &batch));
+    removed = 0;
+    const auto erase_status = edges_erase(batch, counters, vertex, edges);
+    if (!erase_status) {
+        return erase_status;
+    }
+    auto const& status = write(batch, counters, commit);
     if (status) {
         removed = edges;
-    } else {
-        removed = 0;
     }
     return status;
 }
@@ -658,48 +2142,949 @@ Status GraphImpl<Orientation>::edges_erase(const vertex_uid_t& vertex,
                                            size_t& removed,
                                            bool commit) {
     logger_get()->debug("edges_erase(vertex={}, filter={}, commit={})", vertex, filter, commit);
+    if (packed()) {
+        GraphKV::adjacency_key_t key;
+        GraphKV::encode_adjacency(vertex, filter, key);
+        const rocksdb::Slice slice(key.data(), key.size());
+        std::string value;
+        auto status = db_get()->Get(default_read_options(), adjacency_column_.get(), slice, &value);
+        removed = 0;
+        if (status.IsNotFound()) {
+            return Status::ok();
+        }
+        if (!status.ok()) {
+            return to_status(status);
+        }
+        rocksdb::WriteBatch batch;
+        Counters counters;
+        auto edges = 0ul;
+        const auto erase_status = adjacency_erase(batch, counters, vertex, slice, value, edges);
+        if (!erase_status) {
+            return erase_status;
+        }
+        const auto write_status = write(batch, counters, commit);
+        if (write_status) {
+            removed = edges;
+        }
+        return write_status;
+    }
     GraphKV::edge_key_type_prefix_t key;
     GraphKV::encode_edge_prefix(vertex, filter, key);
-    auto iter = db_get()->NewIterator(default_read_options());
-    iter->Seek(rocksdb::Slice(key.data(), key.size()));
+    const rocksdb::Slice prefix(key.data(), key.size());
+    auto iter = iterators_->iterate(edges_column_.get(), prefix);
+    iter->Seek(prefix);
 
     // iterate over all edges
     rocksdb::WriteBatch batch;
+    Counters counters;
     auto edges = 0ul;
+    vertex_uids_t targets;
     while (iter->Valid()) {
         auto const& conn_key = iter->key();
         if (std::memcmp(key.data(), conn_key.data(), key.size()) != 0) {
             break;
         }
-        batch.Delete(conn_key);
+        batch.Delete(edges_column_.get(), conn_key);
+        vertex_uid_t dest;
+        GraphKV::decode_edge_dest(conn_key.data(), conn_key.size(), dest);
+        targets.push_back(dest);
 
         // remove the reverse edge
         GraphKV::edge_key_t reversed_key;
         GraphKV::encode_reversed_edge(conn_key.data(), conn_key.size(), reversed_key);
-        batch.Delete(rocksdb::Slice(reversed_key.data(), reversed_key.size()));
+        batch.Delete(edges_column_.get(),
+                     rocksdb::Slice(reversed_key.data(), reversed_key.size()));
         ++edges;
         iter->Next();
     }
-    auto status = iter->status();
-    if (status.ok()) {
-        status = db_get()->Write(write_options(commit), &batch);
+    removed = 0;
+    if (!iter->status().ok()) {
+        return to_status(iter->status());
     }
-    if (status.ok()) {
+    {
+        const auto status = count_edge_erasures(counters, vertex, targets);
+        if (!status) {
+            return status;
+        }
+    }
+    const auto status = write(batch, counters, commit);
+    if (status) {
         removed = edges;
-    } else {
-        removed = 0;
     }
-    return to_status(status);
+    return status;
 }
 
 template <EdgeOrientation Orientation>
 Status GraphImpl<Orientation>::commit() {
     logger_get()->debug("commit()");
     to_status(db_get()->Flush(rocksdb::FlushOptions(), vertices_column_.get())).raise_on_error();
+    if (packed()) {
+        to_status(db_get()->Flush(rocksdb::FlushOptions(), adjacency_column_.get()))
+            .raise_on_error();
+    }
+    if (meta_column_) {
+        to_status(db_get()->Flush(rocksdb::FlushOptions(), meta_column_.get())).raise_on_error();
+    }
     return to_status(db_get()->Flush(rocksdb::FlushOptions(), edges_column_.get()))
         .raise_on_error();
 }
 
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::adjacency_insert(rocksdb::WriteBatch& batch,
+                                              const vertex_uid_t& vertex,
+                                              vertex_t type,
+                                              AdjacencyList::ids_t ids) {
+    AdjacencyList::normalize(ids);
+    std::string operand;
+    GraphKV::adjacency_key_t key;
+    GraphKV::encode_adjacency(vertex, type, key);
+    AdjacencyList::encode_operand(AdjacencyList::insertion_op, ids, operand);
+    batch.Merge(adjacency_column_.get(), rocksdb::Slice(key.data(), key.size()), operand);
+    if (Orientation == EdgeOrientation::undirected) {
+        AdjacencyList::encode_operand(AdjacencyList::insertion_op, {vertex.second}, operand);
+        for (const auto id: ids) {
+            GraphKV::encode_adjacency(make_id(type, id), vertex.first, key);
+            batch.Merge(adjacency_column_.get(), rocksdb::Slice(key.data(), key.size()), operand);
+        }
+    }
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::adjacency_get(const vertex_uid_t& vertex,
+                                             vertex_t type,
+                                             AdjacencyList::ids_t& ids) const {
+    GraphKV::adjacency_key_t key;
+    GraphKV::encode_adjacency(vertex, type, key);
+    std::string value;
+    const auto& status = db_get()->Get(default_read_options(),
+                                       adjacency_column_.get(),
+                                       rocksdb::Slice(key.data(), key.size()),
+                                       &value);
+    if (status.IsNotFound()) {
+        return Status::ok();
+    }
+    if (status.ok()) {
+        AdjacencyList::decode(value.data(), value.size(), ids);
+    }
+    return to_status(status);
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::adjacency_erase(rocksdb::WriteBatch& batch,
+                                               Counters& counters,
+                                               const vertex_uid_t& vertex,
+                                               const rocksdb::Slice& key,
+                                               const rocksdb::Slice& value,
+                                               size_t& removed) {
+    vertex_uid_t source;
+    vertex_t type;
+    GraphKV::decode_adjacency(key.data(), key.size(), source, type);
+    AdjacencyList::ids_t ids;
+    AdjacencyList::decode(value.data(), value.size(), ids);
+    batch.Delete(adjacency_column_.get(), key);
+
+    // remove the reverse edges and the payloads
+    std::string operand;
+    AdjacencyList::encode_operand(AdjacencyList::removal_op, {vertex.second}, operand);
+    GraphKV::adjacency_key_t reversed_key;
+    GraphKV::edge_key_t edge_key;
+    vertex_uids_t targets;
+    targets.reserve(ids.size());
+    for (const auto id: ids) {
+        const auto target = make_id(type, id);
+        targets.push_back(target);
+        GraphKV::encode_adjacency(target, vertex.first, reversed_key);
+        batch.Merge(adjacency_column_.get(),
+                    rocksdb::Slice(reversed_key.data(), reversed_key.size()),
+                    operand);
+        GraphKV::encode(vertex, target, edge_key);
+        batch.Delete(edges_column_.get(), rocksdb::Slice(edge_key.data(), edge_key.size()));
+        GraphKV::encode(target, vertex, edge_key);
+        batch.Delete(edges_column_.get(), rocksdb::Slice(edge_key.data(), edge_key.size()));
+    }
+    removed += ids.size();
+    return count_edge_erasures(counters, vertex, targets);
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::recount() {
+    logger_get()->debug("recount()");
+    if (!meta_column_ || config_.read_only()) {
+        return to_status(rocksdb::Status::NotSupported("Cannot write counters in this database"));
+    }
+    Counters counters;
+    const auto status = counters_scan(counters);
+    if (!status) {
+        return status;
+    }
+    rocksdb::WriteBatch batch;
+    clear(batch, meta_column_);
+    // the key format is recorded in the same column family
+    batch.Put(meta_column_.get(),
+              GraphKV::key_format_key(),
+              std::to_string(GraphKV::key_format_version));
+    counters.put(batch, meta_column_.get());
+    batch.Put(meta_column_.get(), Counters::initialized_key(), rocksdb::Slice());
+    const auto write_status = to_status(db_get()->Write(write_options(true), &batch));
+    if (write_status) {
+        counted_ = true;
+    }
+    return write_status;
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::ingest_overlaps(bool& result) const {
+    result = false;
+    if (!counted_) {
+        return Status::ok();
+    }
+    std::int64_t vertices = 0;
+    std::int64_t edges = 0;
+    const auto vertices_status = counters_sum('N', vertices);
+    if (!vertices_status) {
+        return vertices_status;
+    }
+    const auto edges_status = counters_sum('E', edges);
+    if (!edges_status) {
+        return edges_status;
+    }
+    result = vertices != 0 || edges != 0;
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::ingest(const std::vector<rocksdb::IngestExternalFileArg>& args,
+                                      const Counters& counters) {
+    logger_get()->debug("ingest(column_families={})", args.size());
+    if (args.empty()) {
+        return Status::ok();
+    }
+    const auto status = to_status(db_get()->IngestExternalFiles(args));
+    if (!status || !counted_) {
+        return status;
+    }
+    rocksdb::WriteBatch batch;
+    return write(batch, counters, true);
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::write(rocksdb::WriteBatch& batch,
+                                     const Counters& counters,
+                                     bool commit) {
+    if (counted_) {
+        counters.merge(batch, meta_column_.get());
+    }
+    return to_status(db_get()->Write(write_options(commit), &batch));
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::key_exists(rocksdb::ColumnFamilyHandle* column,
+                                          const rocksdb::Slice& key,
+                                          bool& result) const {
+    std::string value;
+    bool value_found = false;
+    // cheap negative answer from memtables and bloom filters
+    if (!db_get()->KeyMayExist(default_read_options(), column, key, &value, &value_found)) {
+        result = false;
+        return Status::ok();
+    }
+    if (value_found) {
+        result = true;
+        return Status::ok();
+    }
+    const auto& status = db_get()->Get(default_read_options(), column, key, &value);
+    if (status.IsNotFound()) {
+        result = false;
+        return Status::ok();
+    }
+    result = status.ok();
+    return to_status(status);
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::keys_get(rocksdb::ColumnFamilyHandle* column,
+                                        const std::vector<std::string>& keys,
+                                        const key_visitor_t& visitor) const {
+    // look up keys in their bytewise order so that MultiGet can visit the
+    // memtables and SST files sequentially.
+    std::vector<std::size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0ul);
+    std::sort(order.begin(), order.end(), [&keys](std::size_t lhs, std::size_t rhs) {
+        return keys[lhs] < keys[rhs];
+    });
+    const auto batch_size = std::min(order.size(), multiget_batch_size);
+    std::vector<rocksdb::Slice> slices(batch_size);
+    std::vector<rocksdb::PinnableSlice> values(batch_size);
+    std::vector<rocksdb::Status> statuses(batch_size);
+    for (auto first = 0ul; first < order.size(); first += batch_size) {
+        const auto count = std::min(batch_size, order.size() - first);
+        for (auto i = 0ul; i < count; ++i) {
+            slices[i] = keys[order[first + i]];
+            values[i].Reset();
+        }
+        db_get()->MultiGet(default_read_options(),
+                           column,
+                           count,
+                           slices.data(),
+                           values.data(),
+                           statuses.data(),
+                           true);
+        for (auto i = 0ul; i < count; ++i) {
+            if (statuses[i].ok()) {
+                visitor(order[first + i], values[i]);
+            } else if (!statuses[i].IsNotFound()) {
+                return to_status(statuses[i]);
+            }
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::count_vertex_insertions(Counters& counters,
+                                                       vertex_uids_t vertices) const {
+    if (!counted_) {
+        return Status::ok();
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+    std::unique_ptr<bool[]> present(new bool[vertices.size()]);
+    const auto status = vertices_has(vertices, {present.get(), vertices.size()});
+    if (!status) {
+        return status;
+    }
+    for (auto i = 0ul; i < vertices.size(); ++i) {
+        if (!present[i]) {
+            counters.add_vertices(vertices[i].first, 1);
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::count_edge_insertions(Counters& counters,
+                                                     const vertex_uid_t& vertex,
+                                                     vertex_t type,
+                                                     const AdjacencyList::ids_t& ids) const {
+    if (!counted_) {
+        return Status::ok();
+    }
+    if (packed()) {
+        AdjacencyList::ids_t existing;
+        const auto status = adjacency_get(vertex, type, existing);
+        if (!status) {
+            return status;
+        }
+        for (const auto id: ids) {
+            if (!std::binary_search(existing.begin(), existing.end(), id)) {
+                count_edge(counters, vertex, make_id(type, id), 1);
+            }
+        }
+        return Status::ok();
+    }
+    std::vector<std::string> keys(ids.size());
+    GraphKV::edge_key_t key;
+    for (auto i = 0ul; i < ids.size(); ++i) {
+        GraphKV::encode(vertex, make_id(type, ids[i]), key);
+        keys[i].assign(key.data(), key.size());
+    }
+    std::vector<bool> present(ids.size());
+    const auto status = keys_get(edges_column_.get(),
+                                 keys,
+                                 [&present](std::size_t index, const rocksdb::Slice&) {
+                                     present[index] = true;
+                                 });
+    if (!status) {
+        return status;
+    }
+    for (auto i = 0ul; i < ids.size(); ++i) {
+        if (!present[i]) {
+            count_edge(counters, vertex, make_id(type, ids[i]), 1);
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::count_edge_erasures(Counters& counters,
+                                                   const vertex_uid_t& vertex,
+                                                   const vertex_uids_t& targets) const {
+    if (!counted_ || targets.empty()) {
+        return Status::ok();
+    }
+    std::vector<bool> reversed(targets.size(), Orientation == EdgeOrientation::undirected);
+    if (Orientation == EdgeOrientation::directed) {
+        // the reverse edges are removed too but may not exist
+        std::vector<std::string> keys(targets.size());
+        key_visitor_t visitor;
+        if (packed()) {
+            GraphKV::adjacency_key_t key;
+            for (auto i = 0ul; i < targets.size(); ++i) {
+                GraphKV::encode_adjacency(targets[i], vertex.first, key);
+                keys[i].assign(key.data(), key.size());
+            }
+            visitor = [&reversed, &vertex](std::size_t index, const rocksdb::Slice& value) {
+                reversed[index] = AdjacencyList::contains(value.data(), value.size(), vertex.second);
+            };
+        } else {
+            GraphKV::edge_key_t key;
+            for (auto i = 0ul; i < targets.size(); ++i) {
+                GraphKV::encode(targets[i], vertex, key);
+                keys[i].assign(key.data(), key.size());
+            }
+            visitor = [&reversed](std::size_t index, const rocksdb::Slice&) {
+                reversed[index] = true;
+            };
+        }
+        const auto status = keys_get(packed() ? adjacency_column_.get() : edges_column_.get(),
+                                     keys,
+                                     visitor);
+        if (!status) {
+            return status;
+        }
+    }
+    for (auto i = 0ul; i < targets.size(); ++i) {
+        counters.add_edges(vertex.first, targets[i].first, -1);
+        if (targets[i] != vertex && reversed[i]) {
+            counters.add_edges(targets[i].first, vertex.first, -1);
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::count_edge(Counters& counters,
+                                        const vertex_uid_t& vertex1,
+                                        const vertex_uid_t& vertex2,
+                                        std::int64_t delta) {
+    counters.add_edges(vertex1.first, vertex2.first, delta);
+    if (Orientation == EdgeOrientation::undirected && vertex1 != vertex2) {
+        counters.add_edges(vertex2.first, vertex1.first, delta);
+    }
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::counters_sum(char prefix, std::int64_t& value) const {
+    const rocksdb::Slice key_prefix(&prefix, 1);
+    auto iter = iterators_->iterate(meta_column_.get(), key_prefix);
+    std::int64_t sum = 0;
+    for (iter->Seek(key_prefix); iter->Valid() && iter->key()[0] == prefix; iter->Next()) {
+        std::int64_t counter;
+        if (!Counters::decode_value(iter->value().data(), iter->value().size(), counter)) {
+            return to_status(rocksdb::Status::Corruption("Invalid counter value"));
+        }
+        sum += counter;
+    }
+    if (iter->status().ok()) {
+        value = sum;
+    }
+    return to_status(iter->status());
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::counter_get(const rocksdb::Slice& key, std::int64_t& value) const {
+    std::string data;
+    const auto& status = db_get()->Get(default_read_options(), meta_column_.get(), key, &data);
+    if (status.IsNotFound()) {
+        value = 0;
+        return Status::ok();
+    }
+    if (status.ok() && !Counters::decode_value(data.data(), data.size(), value)) {
+        return to_status(rocksdb::Status::Corruption("Invalid counter value"));
+    }
+    return to_status(status);
+}
+
+template <EdgeOrientation Orientation>
+void GraphImpl<Orientation>::counters_clear(rocksdb::WriteBatch& batch, char prefix) {
+    const rocksdb::Slice key_prefix(&prefix, 1);
+    auto iter = iterators_->iterate(meta_column_.get(), key_prefix);
+    for (iter->Seek(key_prefix); iter->Valid() && iter->key()[0] == prefix; iter->Next()) {
+        batch.Delete(meta_column_.get(), iter->key());
+    }
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::counters_scan(Counters& counters) const {
+    // one set of counters per range of keys, summed once all are scanned
+    std::vector<Counters> partitions(scan_partitions(0));
+    const auto scan_vertex = [&partitions](std::size_t partition,
+                                           const rocksdb::Slice& key,
+                                           const rocksdb::Slice& /* value */) {
+        vertex_uid_t vertex;
+        GraphKV::decode_vertex(key.data(), key.size(), vertex);
+        partitions[partition].add_vertices(vertex.first, 1);
+    };
+    {
+        const auto status =
+            parallel_scan(vertices_column_.get(), 'N', partitions.size(), scan_vertex);
+        if (!status) {
+            return status;
+        }
+    }
+    const auto scan_adjacency = [&partitions](std::size_t partition,
+                                              const rocksdb::Slice& key,
+                                              const rocksdb::Slice& value) {
+        vertex_uid_t vertex;
+        vertex_t type;
+        GraphKV::decode_adjacency(key.data(), key.size(), vertex, type);
+        partitions[partition].add_edges(
+            vertex.first,
+            type,
+            static_cast<std::int64_t>(AdjacencyList::count(value.data(), value.size())));
+    };
+    const auto scan_edge = [&partitions](std::size_t partition,
+                                         const rocksdb::Slice& key,
+                                         const rocksdb::Slice& /* value */) {
+        edge_uid_t edge;
+        GraphKV::decode_edge(key.data(), key.size(), edge);
+        partitions[partition].add_edges(edge.first.first, edge.second.first, 1);
+    };
+    const auto status =
+        packed() ? parallel_scan(adjacency_column_.get(), 'A', partitions.size(), scan_adjacency)
+                 : parallel_scan(edges_column_.get(), 'E', partitions.size(), scan_edge);
+    if (!status) {
+        return status;
+    }
+    for (const auto& partition: partitions) {
+        counters.add(partition);
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::snapshot_csr(CSR& csr,
+                                            std::size_t num_partitions,
+                                            const snapshot_ptr_t& from) const {
+    logger_get()->debug("snapshot_csr(num_partitions={})", num_partitions);
+    num_partitions = scan_partitions(num_partitions);
+    const auto snapshot = from ? from : iterators_->snapshot();
+    csr.clear();
+    {
+        std::vector<vertex_uids_t> partitions(num_partitions);
+        const auto status = vertices_parallel_for_each(
+            num_partitions,
+            [&partitions](std::size_t partition, const vertex_uid_t& vertex) {
+                partitions[partition].push_back(vertex);
+            },
+            snapshot);
+        if (!status) {
+            return status;
+        }
+        // ranges are sorted and do not overlap
+        for (const auto& partition: partitions) {
+            for (const auto& vertex: partition) {
+                csr.types.push_back(vertex.first);
+                csr.ids.push_back(vertex.second);
+            }
+        }
+    }
+
+    // dense indices of the edges of a range of keys
+    struct EdgeIndices {
+        std::vector<std::int64_t> sources;
+        std::vector<std::int64_t> targets;
+        // last source looked up, edges are sorted by source
+        vertex_uid_t source;
+        std::int64_t source_index = -1;
+        // first vertex of an edge missing from the snapshot, if any
+        std::unique_ptr<vertex_uid_t> missing;
+    };
+    std::vector<EdgeIndices> partitions(num_partitions);
+    {
+        const auto status = edges_parallel_for_each(
+            num_partitions,
+            [&partitions, &csr](std::size_t partition, const edge_uid_t& edge) {
+                auto& range = partitions[partition];
+                if (range.source_index < 0 || range.source != edge.first) {
+                    range.source = edge.first;
+                    range.source_index = csr.index(edge.first);
+                }
+                const auto target = csr.index(edge.second);
+                if (range.source_index < 0 || target < 0) {
+                    if (!range.missing) {
+                        range.missing.reset(
+                            new vertex_uid_t(target < 0 ? edge.second : edge.first));
+                    }
+                    return;
+                }
+                range.sources.push_back(range.source_index);
+                range.targets.push_back(target);
+            },
+            snapshot);
+        if (!status) {
+            return status;
+        }
+    }
+    std::size_t num_edges = 0;
+    for (const auto& range: partitions) {
+        if (range.missing) {
+            return Status::error_missing_vertex(*range.missing);
+        }
+        num_edges += range.targets.size();
+    }
+    csr.offsets.assign(csr.num_vertices() + 1, 0);
+    csr.indices.reserve(num_edges);
+    for (auto& range: partitions) {
+        for (const auto source: range.sources) {
+            ++csr.offsets[static_cast<std::size_t>(source) + 1];
+        }
+        csr.indices.insert(csr.indices.end(), range.targets.begin(), range.targets.end());
+        std::vector<std::int64_t>().swap(range.sources);
+        std::vector<std::int64_t>().swap(range.targets);
+    }
+    std::partial_sum(csr.offsets.begin(), csr.offsets.end(), csr.offsets.begin());
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::export_csr(std::size_t num_partitions) const {
+    logger_get()->debug("export_csr(num_partitions={})", num_partitions);
+    const auto snapshot = iterators_->snapshot();
+    CSR csr;
+    const auto status = snapshot_csr(csr, num_partitions, snapshot);
+    if (!status) {
+        return status;
+    }
+    return to_status(MappedCSR::write(path_ + '/' + MappedCSR::filename,
+                                      csr,
+                                      Orientation,
+                                      snapshot->GetSequenceNumber()));
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::edges_expand(const vertex_uids_t& frontier,
+                                            const vertex_t* filter,
+                                            vertex_uids_t& neighbours,
+                                            const snapshot_ptr_t& snapshot,
+                                            std::vector<std::size_t>* offsets) const {
+    if (offsets != nullptr) {
+        offsets->clear();
+        offsets->reserve(frontier.size() + 1);
+        offsets->push_back(neighbours.size());
+    }
+    if (mapped_csr_) {
+        for (const auto& vertex: frontier) {
+            if (filter != nullptr) {
+                mapped_csr_->get(vertex, *filter, neighbours);
+            } else {
+                mapped_csr_->get(vertex, neighbours);
+            }
+            if (offsets != nullptr) {
+                offsets->push_back(neighbours.size());
+            }
+        }
+        return Status::ok();
+    }
+    auto iter = packed() ? iterators_->iterate(adjacency_column_.get(), 'A', snapshot)
+                         : iterators_->iterate(edges_column_.get(), 'E', snapshot);
+    std::vector<vertex_id_t> ids;
+    for (const auto& vertex: frontier) {
+        if (filter != nullptr) {
+            ids.clear();
+            edges_get(*iter, vertex, *filter, ids);
+            for (const auto id: ids) {
+                neighbours.emplace_back(*filter, id);
+            }
+        } else {
+            edges_get(*iter, vertex, neighbours);
+        }
+        if (!iter->status().ok()) {
+            return to_status(iter->status());
+        }
+        if (offsets != nullptr) {
+            offsets->push_back(neighbours.size());
+        }
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::k_hop(const vertex_uids_t& seeds,
+                                     std::size_t num_hops,
+                                     const std::vector<vertex_t>& type_filters,
+                                     Hops& hops) const {
+    logger_get()->debug("k_hop(seeds={}, num_hops={}, type_filters={})",
+                        seeds.size(),
+                        num_hops,
+                        type_filters.size());
+    if (!type_filters.empty() && type_filters.size() != num_hops) {
+        return to_status(rocksdb::Status::InvalidArgument("Number of type filters and hops differ"));
+    }
+    hops.clear();
+    hops.offsets.push_back(0);
+    // visited vertices are kept sorted, so that every hop only costs a merge
+    vertex_uids_t visited(seeds);
+    std::sort(visited.begin(), visited.end());
+    visited.erase(std::unique(visited.begin(), visited.end()), visited.end());
+    vertex_uids_t frontier(visited);
+    vertex_uids_t neighbours;
+    vertex_uids_t merged;
+    const auto snapshot = iterators_->snapshot();
+    for (auto hop = 0ul; hop < num_hops; ++hop) {
+        neighbours.clear();
+        const auto status = edges_expand(frontier,
+                                         type_filters.empty() ? nullptr : &type_filters[hop],
+                                         neighbours,
+                                         snapshot);
+        if (!status) {
+            return status;
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        frontier.clear();
+        std::set_difference(neighbours.begin(),
+                            neighbours.end(),
+                            visited.begin(),
+                            visited.end(),
+                            std::back_inserter(frontier));
+        merged.clear();
+        merged.reserve(visited.size() + frontier.size());
+        std::merge(visited.begin(),
+                   visited.end(),
+                   frontier.begin(),
+                   frontier.end(),
+                   std::back_inserter(merged));
+        visited.swap(merged);
+        for (const auto& vertex: frontier) {
+            hops.types.push_back(vertex.first);
+            hops.ids.push_back(vertex.second);
+        }
+        hops.offsets.push_back(hops.ids.size());
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::traverse(const vertex_uids_t& seeds,
+                                        const Traversal& traversal,
+                                        std::vector<vertex_t>& types,
+                                        std::vector<vertex_id_t>& ids) const {
+    const auto& steps = traversal.steps();
+    logger_get()->debug("traverse(seeds={}, steps={})", seeds.size(), steps.size());
+    // multiplicity of the vertices only matters until the last distinct step
+    std::size_t last_distinct = 0;
+    for (auto i = 0ul; i < steps.size(); ++i) {
+        if (steps[i].operation == Traversal::Operation::distinct) {
+            last_distinct = i + 1;
+        }
+    }
+    vertex_uids_t current(seeds);
+    vertex_uids_t frontier;
+    vertex_uids_t neighbours;
+    std::vector<std::size_t> offsets;
+    const auto snapshot = iterators_->snapshot();
+    for (auto i = 0ul; i < steps.size(); ++i) {
+        const auto& step = steps[i];
+        std::sort(current.begin(), current.end());
+        if (step.operation == Traversal::Operation::distinct || i < last_distinct) {
+            current.erase(std::unique(current.begin(), current.end()), current.end());
+        }
+        if (step.operation == Traversal::Operation::distinct) {
+            continue;
+        }
+        // every vertex reached several times is expanded only once
+        frontier.clear();
+        std::unique_copy(current.begin(), current.end(), std::back_inserter(frontier));
+        neighbours.clear();
+        const auto status = edges_expand(frontier,
+                                         step.filtered ? &step.type : nullptr,
+                                         neighbours,
+                                         snapshot,
+                                         &offsets);
+        if (!status) {
+            return status;
+        }
+        if (frontier.size() == current.size()) {
+            current.swap(neighbours);
+            continue;
+        }
+        vertex_uids_t next;
+        auto vertex = current.begin();
+        for (auto f = 0ul; f < frontier.size(); ++f) {
+            for (; vertex != current.end() && *vertex == frontier[f]; ++vertex) {
+                next.insert(next.end(),
+                            neighbours.begin() + static_cast<std::ptrdiff_t>(offsets[f]),
+                            neighbours.begin() + static_cast<std::ptrdiff_t>(offsets[f + 1]));
+            }
+        }
+        current.swap(next);
+    }
+    types.clear();
+    ids.clear();
+    types.reserve(current.size());
+    ids.reserve(current.size());
+    for (const auto& vertex: current) {
+        types.push_back(vertex.first);
+        ids.push_back(vertex.second);
+    }
+    return Status::ok();
+}
+
+template <EdgeOrientation Orientation>
+std::vector<std::string> GraphImpl<Orientation>::key_splits(rocksdb::ColumnFamilyHandle* column,
+                                                            char prefix,
+                                                            std::size_t count) const {
+    std::vector<rocksdb::LiveFileMetaData> files;
+    db_get()->GetLiveFilesMetaData(&files);
+    const auto& name = column->GetName();
+    files.erase(std::remove_if(files.begin(),
+                               files.end(),
+                               [&name](const rocksdb::LiveFileMetaData& file) {
+                                   return file.column_family_name != name;
+                               }),
+                files.end());
+    std::sort(files.begin(),
+              files.end(),
+              [](const rocksdb::LiveFileMetaData& lhs, const rocksdb::LiveFileMetaData& rhs) {
+                  return lhs.smallestkey < rhs.smallestkey;
+              });
+    std::size_t total_size = 0;
+    for (const auto& file: files) {
+        total_size += file.size;
+    }
+    // files of different levels overlap, the ranges only have similar sizes
+    std::vector<std::string> splits;
+    std::size_t size = 0;
+    for (const auto& file: files) {
+        if (splits.size() + 1 >= count) {
+            break;
+        }
+        if (size > 0 && size * count >= total_size * (splits.size() + 1) &&
+            (splits.empty() || splits.back() < file.smallestkey)) {
+            splits.push_back(file.smallestkey);
+        }
+        size += file.size;
+    }
+    if (splits.size() + 1 < count) {
+        // keys still in memtables or in too few files
+        auto sampled = sampled_key_splits(column, prefix, count);
+        if (sampled.size() > splits.size()) {
+            splits.swap(sampled);
+        }
+    }
+    return splits;
+}
+
+template <EdgeOrientation Orientation>
+std::vector<std::string> GraphImpl<Orientation>::sampled_key_splits(
+    rocksdb::ColumnFamilyHandle* column,
+    char prefix,
+    std::size_t count) const {
+    std::vector<std::string> splits;
+    const std::string upper_bound(1, static_cast<char>(prefix + 1));
+    std::string first;
+    std::string last;
+    {
+        auto iter = iterators_->iterate(column, prefix);
+        iter->Seek(rocksdb::Slice(&prefix, 1));
+        if (!iter->Valid()) {
+            return splits;
+        }
+        first = iter->key().ToString();
+        iter->SeekForPrev(rocksdb::Slice(upper_bound));
+        if (!iter->Valid()) {
+            return splits;
+        }
+        last = iter->key().ToString();
+    }
+    // candidate keys are interpolated on the 8 bytes following the common prefix
+    std::size_t common = 0;
+    while (common < first.size() && common < last.size() && first[common] == last[common]) {
+        ++common;
+    }
+    const auto to_integer = [common](const std::string& key) {
+        std::uint64_t value = 0;
+        for (auto i = common; i < common + sizeof(value); ++i) {
+            value = value << 8u | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0u);
+        }
+        return value;
+    };
+    const auto low = to_integer(first);
+    const auto range = to_integer(last) - low;
+    const auto num_samples = static_cast<std::uint64_t>(count * samples_per_split);
+    std::vector<std::string> samples;
+    for (std::uint64_t i = 1; i < num_samples; ++i) {
+        auto value = low + range / num_samples * i + range % num_samples * i / num_samples;
+        std::string key(first, 0, common);
+        key.resize(common + sizeof(value));
+        for (auto j = key.size(); j > common; --j) {
+            key[j - 1] = static_cast<char>(value & 0xffu);
+            value >>= 8u;
+        }
+        if (key > first && (samples.empty() || key > samples.back())) {
+            samples.push_back(std::move(key));
+        }
+    }
+    if (samples.empty()) {
+        return splits;
+    }
+    std::vector<rocksdb::Range> ranges;
+    ranges.reserve(samples.size() + 1);
+    ranges.emplace_back(first, samples.front());
+    for (auto i = 1ul; i < samples.size(); ++i) {
+        ranges.emplace_back(samples[i - 1], samples[i]);
+    }
+    ranges.emplace_back(samples.back(), upper_bound);
+    std::vector<std::uint64_t> sizes(ranges.size());
+    db_get()->GetApproximateSizes(column,
+                                  ranges.data(),
+                                  static_cast<int>(ranges.size()),
+                                  sizes.data(),
+                                  rocksdb::DB::SizeApproximationFlags::INCLUDE_FILES |
+                                      rocksdb::DB::SizeApproximationFlags::INCLUDE_MEMTABLES);
+    auto total_size = std::accumulate(sizes.begin(), sizes.end(), std::uint64_t{0});
+    if (total_size == 0) {
+        // no estimate at all, split the interpolated key space evenly
+        std::fill(sizes.begin(), sizes.end(), 1);
+        total_size = sizes.size();
+    }
+    std::uint64_t size = 0;
+    for (auto i = 0ul; i < samples.size() && splits.size() + 1 < count; ++i) {
+        size += sizes[i];
+        if (size * count >= total_size * (splits.size() + 1)) {
+            splits.push_back(samples[i]);
+        }
+    }
+    return splits;
+}
+
+template <EdgeOrientation Orientation>
+Status GraphImpl<Orientation>::parallel_scan(rocksdb::ColumnFamilyHandle* column,
+                                             char prefix,
+                                             std::size_t num_partitions,
+                                             const scan_visitor_t& visitor,
+                                             const snapshot_ptr_t& snapshot) const {
+    auto splits = key_splits(column, prefix, scan_partitions(num_partitions));
+    splits.erase(std::remove_if(splits.begin(),
+                                splits.end(),
+                                [prefix](const std::string& split) {
+                                    return split.empty() || split[0] != prefix;
+                                }),
+                 splits.end());
+    const std::string lower_bound(1, prefix);
+    const std::string upper_bound(1, static_cast<char>(prefix + 1));
+    // all ranges are read from the same state of the database
+    const auto scan_snapshot = snapshot ? snapshot : iterators_->snapshot();
+    std::vector<rocksdb::Status> statuses(splits.size() + 1);
+    ThreadPool pool(statuses.size());
+    pool.parallel_for(statuses.size(), [&](std::size_t partition) {
+        auto iter = iterators_->iterate_until(
+            column, partition < splits.size() ? splits[partition] : upper_bound, scan_snapshot);
+        iter->Seek(rocksdb::Slice(partition == 0 ? lower_bound : splits[partition - 1]));
+        for (; iter->Valid(); iter->Next()) {
+            visitor(partition, iter->key(), iter->value());
+        }
+        statuses[partition] = iter->status();
+    });
+    for (const auto& status: statuses) {
+        if (!status.ok()) {
+            return to_status(status);
+        }
+    }
+    return Status::ok();
+}
+
 template <EdgeOrientation Orientation>
 std::string GraphImpl<Orientation>::statistics() const {
     return statistics_->ToString();
@@ -707,8 +3092,8 @@ std::string GraphImpl<Orientation>::statistics() const {
 
 template <EdgeOrientation Orientation>
 void GraphImpl<Orientation>::clear(rocksdb::WriteBatch& batch,
-                                   const std::unique_ptr<rocksdb::ColumnFamilyHandle>& handle) {
-    auto iter = db_get()->NewIterator(default_read_options(), handle.get());
+                                   const std::shared_ptr<rocksdb::ColumnFamilyHandle>& handle) {
+    auto iter = iterators_->iterate_until(handle.get(), rocksdb::Slice());
     iter->SeekToFirst();
     if (iter->Valid()) {
         while (iter->Valid()) {
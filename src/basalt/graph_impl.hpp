@@ -6,16 +6,25 @@
  *************************************************************************/
 #pragma once
 
+#include <functional>
+
 #include <gsl>
 
 #include <basalt/edges.hpp>
 #include <basalt/graph.hpp>
+#include <basalt/hops.hpp>
+#include <basalt/payload_view.hpp>
 #include <basalt/status.hpp>
+#include <basalt/traversal.hpp>
 #include <basalt/vertices.hpp>
 
+#include "adjacency.hpp"
 #include "config.hpp"
+#include "counters.hpp"
 #include "fwd.hpp"
 #include "graph_kv.hpp"
+#include "iterator_pool.hpp"
+#include "mapped_csr.hpp"
 
 namespace basalt {
 
@@ -52,6 +61,22 @@ class GraphImpl {
         return this->vertices_;
     }
 
+    inline rocksdb::ColumnFamilyHandle* vertices_column_get() const noexcept {
+        return this->vertices_column_.get();
+    }
+    inline rocksdb::ColumnFamilyHandle* edges_column_get() const noexcept {
+        return this->edges_column_.get();
+    }
+    /// \return handle of the "adjacency" column family, \a nullptr unless edges are packed
+    inline rocksdb::ColumnFamilyHandle* adjacency_column_get() const noexcept {
+        return this->adjacency_column_.get();
+    }
+
+    /// \return true if payloads of undirected edges are only stored under their canonical key
+    inline bool canonical_payloads() const noexcept {
+        return this->canonical_payloads_;
+    }
+
     inline const db_t& db_get() const noexcept {
         return this->db_;
     }
@@ -71,12 +96,58 @@ class GraphImpl {
                            bool commit);
 
     Status vertices_has(const vertex_uid_t& vertex, bool& result) const;
+    /**
+     * \brief check presence of several vertices with batched lookups
+     * \param results updated with the presence of every vertex
+     */
+    Status vertices_has(const gsl::span<const vertex_uid_t> vertices,
+                        const gsl::span<bool> results) const;
     Status vertices_erase(const vertex_uid_t& vertex, bool commit);
     Status vertices_count(std::size_t& count) const;
     Status vertices_count(vertex_t type, std::size_t& count) const;
     Status vertices_get(const basalt::vertex_uid_t& vertex, std::string* value);
-    std::shared_ptr<VertexIteratorImpl> vertex_iterator(std::size_t from) const;
+    Status vertices_get(const vertex_uid_t& vertex, PayloadView& value) const;
+    Status vertices_range(vertex_t type,
+                          vertex_id_t first,
+                          vertex_id_t last,
+                          vertex_uids_t& vertices) const;
+    /**
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    std::shared_ptr<VertexIteratorImpl> vertex_iterator(std::size_t from,
+                                                        const snapshot_ptr_t& snapshot = {}) const;
+    /**
+     * \param from first vertex to visit, or the next one if missing
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    std::shared_ptr<VertexIteratorImpl> vertex_iterator(const vertex_uid_t& from,
+                                                        const snapshot_ptr_t& snapshot = {}) const;
+    /**
+     * \brief iterate over the edges of the graph, undirected edges only once
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    std::shared_ptr<EdgeIteratorImpl> canonical_edge_iterator(
+        const snapshot_ptr_t& snapshot = {}) const;
+    /**
+     * \brief iterate over the vertices of a certain type, bounded by the type key prefix
+     * \param type type of the vertices to visit
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    std::shared_ptr<VertexIteratorImpl> vertex_type_iterator(
+        vertex_t type,
+        const snapshot_ptr_t& snapshot = {}) const;
     Status vertices_clear(bool commit) __attribute__((warn_unused_result));
+    /**
+     * \brief visit all vertices on several threads
+     * \param num_partitions maximum number of ranges of vertices visited concurrently,
+     * 0 for one per hardware thread
+     * \param visitor called with the index of a range and every vertex in it
+     * \param snapshot snapshot to read from, a new one if empty
+     */
+    Status vertices_parallel_for_each(
+        std::size_t num_partitions,
+        const std::function<void(std::size_t, const vertex_uid_t&)>& visitor,
+        const snapshot_ptr_t& snapshot = {}) const;
 
     Status edges_insert(const vertex_uid_t& vertex1,
                         const vertex_uid_t& vertex2,
@@ -106,31 +177,343 @@ class GraphImpl {
     Status edges_get(const vertex_uid_t& vertex, vertex_uids_t& edges) const;
     Status edges_get(const edge_uid_t& edge, std::string* value) const
         __attribute__((warn_unused_result));
+    Status edges_get(const edge_uid_t& edge, PayloadView& value) const
+        __attribute__((warn_unused_result));
 
     Status edges_has(const vertex_uid_t& vertex1, const vertex_uid_t& vertex2, bool& result) const;
 
     Status edges_get(const vertex_uid_t& vertex, vertex_t filter, vertex_uids_t& edges) const;
+    Status edges_get(const vertex_uid_t& vertex,
+                     vertex_t filter,
+                     vertex_id_t first,
+                     vertex_id_t last,
+                     vertex_uids_t& edges) const;
+    Status edges_get(const vertex_uid_t& vertex,
+                     vertex_t filter,
+                     std::vector<vertex_id_t>& ids) const;
+    Status edges_get(const vertex_uid_t& vertex,
+                     std::vector<vertex_t>& types,
+                     std::vector<vertex_id_t>& ids) const;
+
+    Status edges_get_with_payloads(const vertex_uid_t& vertex,
+                                   vertex_uids_t& edges,
+                                   std::string& payloads,
+                                   std::vector<std::size_t>& offsets) const;
+    Status edges_get_with_payloads(const vertex_uid_t& vertex,
+                                   vertex_t filter,
+                                   std::vector<vertex_id_t>& ids,
+                                   std::string& payloads,
+                                   std::vector<std::size_t>& offsets) const;
+
+    Status edges_get_many(const gsl::span<const vertex_t> types,
+                          const gsl::span<const vertex_id_t> ids,
+                          vertex_t filter,
+                          std::vector<std::size_t>& offsets,
+                          std::vector<vertex_id_t>& neighbours,
+                          std::size_t num_threads) const;
+
+    Status edges_common(const vertex_uid_t& vertex1,
+                        const vertex_uid_t& vertex2,
+                        vertex_uids_t& vertices) const;
+    Status edges_combine(SetOperation operation,
+                         const vertex_uids_t& vertices,
+                         vertex_t filter,
+                         std::vector<vertex_id_t>& ids) const;
+
+    Status edges_degree(const vertex_uid_t& vertex, std::size_t& degree) const;
+    Status edges_degree(const vertex_uid_t& vertex, vertex_t filter, std::size_t& degree) const;
+    Status edges_degree(const gsl::span<const vertex_t> types,
+                        const gsl::span<const vertex_id_t> ids,
+                        const gsl::span<std::size_t> degrees) const;
 
     Status edges_erase(const vertex_uid_t& vertex1, const vertex_uid_t& vertex2, bool commit);
 
     Status edges_erase(const vertex_uid_t& vertex, vertex_t filter, size_t& removed, bool commit);
     Status edges_erase(const vertex_uid_t& vertex, std::size_t& removed, bool commit);
     Status edges_count(std::size_t& count) const;
+    Status edges_count(vertex_t head, vertex_t tail, std::size_t& count) const;
+    /**
+     * \brief visit all edges on several threads
+     * \param num_partitions maximum number of ranges of edges visited concurrently,
+     * 0 for one per hardware thread
+     * \param visitor called with the index of a range and every edge in it
+     * \param snapshot snapshot to read from, a new one if empty
+     */
+    Status edges_parallel_for_each(
+        std::size_t num_partitions,
+        const std::function<void(std::size_t, const edge_uid_t&)>& visitor,
+        const snapshot_ptr_t& snapshot = {}) const;
+    /**
+     * \brief build the compressed sparse row representation of the graph
+     * \param num_partitions maximum number of ranges of vertices and edges visited
+     * concurrently, 0 for one per hardware thread
+     * \param snapshot snapshot to read from, a new one if empty
+     */
+    Status snapshot_csr(CSR& csr,
+                        std::size_t num_partitions,
+                        const snapshot_ptr_t& snapshot = {}) const;
+    /**
+     * \brief write the compressed sparse row representation of the graph in the
+     * graph directory, mapped in memory by the next read-only instances
+     * \param num_partitions maximum number of ranges of vertices and edges visited
+     * concurrently, 0 for one per hardware thread
+     */
+    Status export_csr(std::size_t num_partitions) const;
+    /**
+     * \brief breadth-first traversal, see \a Graph::k_hop
+     */
+    Status k_hop(const vertex_uids_t& seeds,
+                 std::size_t num_hops,
+                 const std::vector<vertex_t>& type_filters,
+                 Hops& hops) const;
+    /**
+     * \brief execute a traversal, see \a Graph::traverse
+     */
+    Status traverse(const vertex_uids_t& seeds,
+                    const Traversal& traversal,
+                    std::vector<vertex_t>& types,
+                    std::vector<vertex_id_t>& ids) const;
     Status edges_clear(bool commit) __attribute__((warn_unused_result));
-    std::shared_ptr<EdgeIteratorImpl> edge_iterator(std::size_t from) const;
+    /**
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    std::shared_ptr<EdgeIteratorImpl> edge_iterator(std::size_t from,
+                                                    const snapshot_ptr_t& snapshot = {}) const;
+    /**
+     * \param from first edge to visit, or the next one if missing
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    std::shared_ptr<EdgeIteratorImpl> edge_iterator(const edge_uid_t& from,
+                                                    const snapshot_ptr_t& snapshot = {}) const;
+    /// \brief create a snapshot of the database, released with its last reference
+    snapshot_ptr_t snapshot() const;
 
 
     Status commit();
+    Status recount() __attribute__((warn_unused_result));
+    /**
+     * \brief tell whether the records of SST files to ingest may already be in
+     * the database, in which case their presence must be looked up to count them
+     * \param result false if counters are not maintained or if the database is empty
+     */
+    Status ingest_overlaps(bool& result) const __attribute__((warn_unused_result));
+    /**
+     * \brief atomically ingest SST files in the database
+     * \param args files to ingest per column family
+     * \param counters number of vertices and edges in the files not already in the database
+     */
+    Status ingest(const std::vector<rocksdb::IngestExternalFileArg>& args,
+                  const Counters& counters) __attribute__((warn_unused_result));
     std::string statistics() const;
 
     static Status to_status(const rocksdb::Status& status);
 
   private:
-    Status edges_erase(rocksdb::WriteBatch& batch, const vertex_uid_t& vertex, size_t& removed);
+    /// maximum number of keys looked up by a single \a MultiGet call
+    constexpr static std::size_t multiget_batch_size = 1024;
+    /// minimum number of vertices visited by every thread of \a edges_get_many
+    constexpr static std::size_t get_many_chunk_size = 4096;
+    /// number of sampled ranges per range returned by \a sampled_key_splits
+    constexpr static std::size_t samples_per_split = 16;
+
+    /**
+     * \brief check that the keys of the database are encoded with the supported format,
+     * and record the format in the "meta" column family if it is not yet
+     * \param existed false if the database has just been created
+     * \throw std::runtime_error if the format is not supported
+     */
+    void key_format_check(bool existed);
+
+    /**
+     * \brief check that all vertices are in the database
+     * \return \a Status::error_missing_vertex with the first missing vertex, if any
+     */
+    Status vertices_require(const vertex_uids_t& vertices) const;
+
+    using scan_visitor_t =
+        std::function<void(std::size_t, const rocksdb::Slice&, const rocksdb::Slice&)>;
+
+    /**
+     * \brief split the keys of a column family in ranges of similar sizes,
+     * at the boundaries of its SST files or, when they are too few, at keys sampled
+     * between the first and the last keys, see \a sampled_key_splits
+     * \param prefix first byte of all keys of the column family
+     * \param count maximum number of ranges
+     * \return sorted keys separating the ranges, at most \a count - 1
+     */
+    std::vector<std::string> key_splits(rocksdb::ColumnFamilyHandle* column,
+                                        char prefix,
+                                        std::size_t count) const;
+
+    /**
+     * \brief split the keys of a column family in ranges of similar approximate sizes,
+     * memtables included. Candidate keys are interpolated between the first and the
+     * last keys, then grouped according to \a GetApproximateSizes.
+     * \param prefix first byte of all keys of the column family
+     * \param count maximum number of ranges
+     * \return sorted keys separating the ranges, at most \a count - 1
+     */
+    std::vector<std::string> sampled_key_splits(rocksdb::ColumnFamilyHandle* column,
+                                                char prefix,
+                                                std::size_t count) const;
+
+    /**
+     * \brief visit the keys of a column family from a snapshot, with one thread per
+     * range of keys
+     * \param prefix first byte of the visited keys
+     * \param num_partitions maximum number of ranges, 0 for one per hardware thread
+     * \param visitor called with the index of a range, every key in it and its value
+     * \param snapshot snapshot to read from, a new one if empty
+     */
+    Status parallel_scan(rocksdb::ColumnFamilyHandle* column,
+                         char prefix,
+                         std::size_t num_partitions,
+                         const scan_visitor_t& visitor,
+                         const snapshot_ptr_t& snapshot = {}) const;
+
+    /// \return true if edges are stored as adjacency lists
+    inline bool packed() const noexcept {
+        return this->adjacency_column_ != nullptr;
+    }
+
+    /**
+     * \brief encode the key holding the payload of an edge, the one starting with
+     * the smaller vertex if payloads of undirected edges are stored once
+     */
+    void encode_payload_key(const edge_uid_t& edge, GraphKV::edge_key_t& key) const;
+    /**
+     * \brief write the keys of an edge along with its payload. If payloads of undirected
+     * edges are stored once, the other key is an empty marker, omitted in packed mode.
+     */
+    void edge_put(rocksdb::WriteBatch& batch,
+                  const vertex_uid_t& vertex1,
+                  const vertex_uid_t& vertex2,
+                  const rocksdb::Slice& payload);
+
+    Status edges_erase(rocksdb::WriteBatch& batch,
+                       Counters& counters,
+                       const vertex_uid_t& vertex,
+                       size_t& removed);
+    Status adjacency_erase(rocksdb::WriteBatch& batch,
+                           Counters& counters,
+                           const vertex_uid_t& vertex,
+                           const rocksdb::Slice& key,
+                           const rocksdb::Slice& value,
+                           size_t& removed);
+    /**
+     * \brief append the identifiers of the vertices of a type connected to a vertex
+     * \param iter iterator over the edges or adjacency column family, moved forward
+     */
+    void edges_get(rocksdb::Iterator& iter,
+                   const vertex_uid_t& vertex,
+                   vertex_t filter,
+                   std::vector<vertex_id_t>& ids) const;
+    /**
+     * \brief append the vertices connected to a vertex
+     * \param iter iterator over the edges or adjacency column family, moved forward
+     */
+    void edges_get(rocksdb::Iterator& iter, const vertex_uid_t& vertex, vertex_uids_t& edges) const;
+    /**
+     * \brief append the vertices connected to the vertices of a frontier
+     * \param frontier sorted vertices, visited with forward seeks of a single iterator
+     * \param filter type of target vertices, all types if null
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     * \param offsets if not null, replaced by the positions in \a neighbours of the
+     * neighbours of every vertex of the frontier, plus the total
+     */
+    Status edges_expand(const vertex_uids_t& frontier,
+                        const vertex_t* filter,
+                        vertex_uids_t& neighbours,
+                        const snapshot_ptr_t& snapshot,
+                        std::vector<std::size_t>* offsets = nullptr) const;
+    /**
+     * \brief count the edges of a vertex without decoding them
+     * \param iter iterator over the edges or adjacency column family
+     */
+    void edges_degree(rocksdb::Iterator& iter,
+                      const vertex_uid_t& vertex,
+                      std::size_t& degree) const;
+    /**
+     * \brief visit the edges of a vertex and append their payloads
+     * \param filter type of target vertices, all types if null
+     * \param visitor function called with every target vertex, in order
+     */
+    Status edges_scan_payloads(const vertex_uid_t& vertex,
+                               const vertex_t* filter,
+                               const std::function<void(const vertex_uid_t&)>& visitor,
+                               std::string& payloads,
+                               std::vector<std::size_t>& offsets) const;
+    /**
+     * \brief append the payloads of edges to vertices smaller than \a vertex, stored
+     * under the canonical keys (target, vertex) if payloads of undirected edges are
+     * stored once
+     * \param targets sorted target vertices
+     */
+    Status edges_reversed_payloads(const vertex_uid_t& vertex,
+                                   const vertex_uids_t& targets,
+                                   std::string& payloads,
+                                   std::vector<std::size_t>& offsets) const;
+    Status adjacency_get(const vertex_uid_t& vertex,
+                         vertex_t type,
+                         AdjacencyList::ids_t& ids) const;
+    void adjacency_insert(rocksdb::WriteBatch& batch,
+                          const vertex_uid_t& vertex,
+                          vertex_t type,
+                          AdjacencyList::ids_t ids);
     void clear(rocksdb::WriteBatch& batch,
-               const std::unique_ptr<rocksdb::ColumnFamilyHandle>& handle);
+               const std::shared_ptr<rocksdb::ColumnFamilyHandle>& handle);
+
+    /**
+     * \name Counters helpers
+     * They do nothing if counters are not maintained in the database
+     * \{
+     */
+
+    /// \brief write a batch along with the variations of the counters
+    Status write(rocksdb::WriteBatch& batch, const Counters& counters, bool commit);
+    Status key_exists(rocksdb::ColumnFamilyHandle* column,
+                      const rocksdb::Slice& key,
+                      bool& result) const;
+    /// function called with the index and the value of a key found by \a keys_get
+    using key_visitor_t = std::function<void(std::size_t, const rocksdb::Slice&)>;
+    /**
+     * \brief look up keys of a column family with batched \a MultiGet calls
+     * \param keys keys to look up, in any order
+     * \param visitor called for every key found
+     */
+    Status keys_get(rocksdb::ColumnFamilyHandle* column,
+                    const std::vector<std::string>& keys,
+                    const key_visitor_t& visitor) const;
+    /**
+     * \brief record the insertion of the vertices not already in the database
+     * \param vertices inserted vertices, possibly with duplicates
+     */
+    Status count_vertex_insertions(Counters& counters, vertex_uids_t vertices) const;
+    /**
+     * \brief record the insertion of the edges not already in the database
+     * \param ids sorted identifiers of the target vertices without duplicates
+     */
+    Status count_edge_insertions(Counters& counters,
+                                 const vertex_uid_t& vertex,
+                                 vertex_t type,
+                                 const AdjacencyList::ids_t& ids) const;
+    /// \brief record the removal of edges of a vertex and of their reverse ones, if any
+    Status count_edge_erasures(Counters& counters,
+                               const vertex_uid_t& vertex,
+                               const vertex_uids_t& targets) const;
+    static void count_edge(Counters& counters,
+                           const vertex_uid_t& vertex1,
+                           const vertex_uid_t& vertex2,
+                           std::int64_t delta);
+    /// \brief sum the values of the counters whose key starts with the given prefix
+    Status counters_sum(char prefix, std::int64_t& value) const;
+    Status counter_get(const rocksdb::Slice& key, std::int64_t& value) const;
+    void counters_clear(rocksdb::WriteBatch& batch, char prefix);
+    /// \brief compute counters by iterating over vertices and edges
+    Status counters_scan(Counters& counters) const;
+    /** \} */
 
-    const std::string& path_;
+    const std::string path_;
     const Config config_;
     Vertices<Orientation> vertices_;
     Edges<Orientation> edges_;
@@ -139,8 +522,19 @@ class GraphImpl {
     logger_t logger_;
     db_t db_;
     column_families_t column_families_;
-    std::unique_ptr<rocksdb::ColumnFamilyHandle> vertices_column_;
-    std::unique_ptr<rocksdb::ColumnFamilyHandle> edges_column_;
+    std::shared_ptr<rocksdb::ColumnFamilyHandle> vertices_column_;
+    std::shared_ptr<rocksdb::ColumnFamilyHandle> edges_column_;
+    std::shared_ptr<rocksdb::ColumnFamilyHandle> adjacency_column_;
+    std::shared_ptr<rocksdb::ColumnFamilyHandle> meta_column_;
+    /// true if counters in the "meta" column family are up to date
+    bool counted_;
+    /// true if payloads of undirected edges are only stored under their canonical key
+    const bool canonical_payloads_;
+    /// topology read from the CSR file of a read-only database, if up to date
+    std::unique_ptr<MappedCSR> mapped_csr_;
+    /// declared last so that pooled iterators are deleted before the column families,
+    /// iterators still in use keep them and the database open
+    std::shared_ptr<IteratorPool> iterators_;
 };
 
 extern template class GraphImpl<EdgeOrientation::directed>;
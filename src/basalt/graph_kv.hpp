@@ -8,30 +8,87 @@
 
 #include <array>
 #include <cassert>
+#include <climits>
+#include <cstdint>
 #include <cstring>
+#include <type_traits>
+#include <vector>
 
 #include <basalt/fwd.hpp>
 
 namespace basalt {
 
+/**
+ * Encode and decode the keys of the graph in the RocksDB column families.
+ *
+ * Vertex types and identifiers are written in big-endian order, and the sign bit
+ * of vertex types is flipped, so that the bytewise order of the keys used by RocksDB
+ * is also the numerical order of (type, id). Ranges of identifiers can then be
+ * scanned with bounded seeks.
+ */
 class GraphKV {
   public:
     using vertex_key_t = std::array<char, 1 + sizeof(vertex_id_t) + sizeof(vertex_t)>;
     using edge_key_prefix_t = std::array<char, 1 + sizeof(vertex_id_t) + sizeof(vertex_t)>;
     using edge_key_type_prefix_t = std::array<char, 1 + sizeof(vertex_id_t) + 2 * sizeof(vertex_t)>;
     using edge_key_t = std::array<char, 1 + 2 * (sizeof(vertex_id_t) + sizeof(vertex_t))>;
+    using adjacency_key_prefix_t = std::array<char, 1 + sizeof(vertex_id_t) + sizeof(vertex_t)>;
+    using adjacency_key_t = std::array<char, 1 + sizeof(vertex_id_t) + 2 * sizeof(vertex_t)>;
+    using vertex_counter_key_t = std::array<char, 1 + sizeof(vertex_t)>;
+    using edge_counter_key_t = std::array<char, 1 + 2 * sizeof(vertex_t)>;
 
     constexpr static auto edge_key_size = std::tuple_size<edge_key_t>::value;
 
+    /**
+     * \name Key format versions
+     * Recorded in the "meta" column family, and written in the database JSON
+     * configuration, to detect incompatible databases
+     * \{
+     */
+    /// native-endian encoding of types and identifiers, not order-preserving
+    constexpr static int legacy_key_format = 0;
+    /// big-endian encoding with sign-flipped vertex types
+    constexpr static int key_format_version = 1;
+
+    /// \return key of the "meta" column family holding the key format of the database
+    static inline const char* key_format_key() noexcept {
+        return "key_format";
+    }
+    /** \} */
+
+    /** \name Scalar encoding functions
+     *  \{
+     */
+    static inline void encode_type(const vertex_t type, char* data) {
+        using unsigned_t = std::make_unsigned<vertex_t>::type;
+        constexpr auto sign_bit = static_cast<unsigned_t>(1) << (sizeof(vertex_t) * CHAR_BIT - 1);
+        encode_big_endian(static_cast<unsigned_t>(static_cast<unsigned_t>(type) ^ sign_bit), data);
+    }
+
+    static inline void encode_id(const vertex_id_t id, char* data) {
+        encode_big_endian(id, data);
+    }
+
+    static inline vertex_t decode_type(const char* data) {
+        using unsigned_t = std::make_unsigned<vertex_t>::type;
+        constexpr auto sign_bit = static_cast<unsigned_t>(1) << (sizeof(vertex_t) * CHAR_BIT - 1);
+        return static_cast<vertex_t>(decode_big_endian<unsigned_t>(data) ^ sign_bit);
+    }
+
+    static inline vertex_id_t decode_id(const char* data) {
+        return decode_big_endian<vertex_id_t>(data);
+    }
+    /**
+     *  \}
+     */
+
     /** \name Key encoding functions
      *  \{
      */
     static inline void encode(const vertex_t type, const vertex_id_t id, vertex_key_t& key) {
         key[0] = 'N';
-        std::memcpy(key.data() + 1, reinterpret_cast<const char*>(&type), sizeof(decltype(type)));
-        std::memcpy(key.data() + 1 + sizeof(decltype(type)),
-                    reinterpret_cast<const char*>(&id),
-                    sizeof(decltype(id)));
+        encode_type(type, key.data() + 1);
+        encode_id(id, key.data() + 1 + sizeof(vertex_t));
     }
 
     static inline void encode(const vertex_uid_t& vertex, vertex_key_t& key) {
@@ -40,48 +97,23 @@ class GraphKV {
 
     static inline void encode_edge_prefix(const vertex_uid_t& vertex, edge_key_prefix_t& key) {
         key[0] = 'E';
-        std::memcpy(key.data() + 1,
-                    reinterpret_cast<const char*>(&vertex.first),
-                    sizeof(vertex_uid_t::first_type));
-        std::memcpy(key.data() + 1 + sizeof(vertex_uid_t::first_type),
-                    reinterpret_cast<const char*>(&vertex.second),
-                    sizeof(vertex_uid_t::second_type));
+        encode_vertex(vertex, key.data() + 1);
     }
 
     static inline void encode_edge_prefix(const vertex_uid_t& vertex,
                                           vertex_t type,
                                           edge_key_type_prefix_t& key) {
         key[0] = 'E';
-        std::memcpy(key.data() + 1,
-                    reinterpret_cast<const char*>(&vertex.first),
-                    sizeof(vertex_uid_t::first_type));
-        std::memcpy(key.data() + 1 + sizeof(vertex_uid_t::first_type),
-                    reinterpret_cast<const char*>(&vertex.second),
-                    sizeof(vertex_uid_t::second_type));
-        std::memcpy(key.data() + 1 + sizeof(vertex_uid_t::first_type) +
-                        sizeof(vertex_uid_t::second_type),
-                    reinterpret_cast<const char*>(&type),
-                    sizeof(vertex_uid_t::first_type));
+        encode_vertex(vertex, key.data() + 1);
+        encode_type(type, key.data() + 1 + vertex_size);
     }
 
     static inline void encode(const vertex_uid_t& vertex1,
                               const vertex_uid_t& vertex2,
                               edge_key_t& key) {
         key[0] = 'E';
-        std::memcpy(key.data() + 1,
-                    reinterpret_cast<const char*>(&vertex1.first),
-                    sizeof(vertex_uid_t::first_type));
-        std::memcpy(key.data() + 1 + sizeof(vertex_uid_t::first_type),
-                    reinterpret_cast<const char*>(&vertex1.second),
-                    sizeof(vertex_uid_t::second_type));
-        std::memcpy(key.data() + 1 + sizeof(vertex_uid_t::first_type) +
-                        sizeof(vertex_uid_t::second_type),
-                    reinterpret_cast<const char*>(&vertex2.first),
-                    sizeof(vertex_uid_t::first_type));
-        std::memcpy(key.data() + 1 + 2 * sizeof(vertex_uid_t::first_type) +
-                        sizeof(vertex_uid_t::second_type),
-                    reinterpret_cast<const char*>(&vertex2.second),
-                    sizeof(vertex_uid_t::second_type));
+        encode_vertex(vertex1, key.data() + 1);
+        encode_vertex(vertex2, key.data() + 1 + vertex_size);
     }
 
     static inline void encode(const vertex_uid_t& vertex1,
@@ -97,17 +129,37 @@ class GraphKV {
         encode(vertex2, vertex1, keys[1]);
     }
 
+    static inline void encode_adjacency_prefix(const vertex_uid_t& vertex,
+                                               adjacency_key_prefix_t& key) {
+        key[0] = 'A';
+        encode_vertex(vertex, key.data() + 1);
+    }
+
+    static inline void encode_adjacency(const vertex_uid_t& vertex,
+                                        vertex_t type,
+                                        adjacency_key_t& key) {
+        key[0] = 'A';
+        encode_vertex(vertex, key.data() + 1);
+        encode_type(type, key.data() + 1 + vertex_size);
+    }
+
+    static inline void encode_vertex_counter(vertex_t type, vertex_counter_key_t& key) {
+        key[0] = 'N';
+        encode_type(type, key.data() + 1);
+    }
+
+    static inline void encode_edge_counter(vertex_t head, vertex_t tail, edge_counter_key_t& key) {
+        key[0] = 'E';
+        encode_type(head, key.data() + 1);
+        encode_type(tail, key.data() + 1 + sizeof(vertex_t));
+    }
+
     static inline void encode_reversed_edge(const char* data, size_t size, edge_key_t& key) {
         static_cast<void>(size);
         assert(size == std::tuple_size<edge_key_t>::value);
         key[0] = 'E';
-        std::memcpy(key.data() + 1,
-                    data + 1 + sizeof(vertex_uid_t::first_type) + sizeof(vertex_uid_t::second_type),
-                    sizeof(vertex_uid_t::first_type) + sizeof(vertex_uid_t::second_type));
-        std::memcpy(key.data() + 1 + sizeof(vertex_uid_t::first_type) +
-                        sizeof(vertex_uid_t::second_type),
-                    data + 1,
-                    sizeof(vertex_uid_t::first_type) + sizeof(vertex_uid_t::second_type));
+        std::memcpy(key.data() + 1, data + 1 + vertex_size, vertex_size);
+        std::memcpy(key.data() + 1 + vertex_size, data + 1, vertex_size);
     }
     /**
      *  \}
@@ -120,40 +172,105 @@ class GraphKV {
         static_cast<void>(size);
         assert(size == std::tuple_size<edge_key_t>::value);
         assert(data[0] == 'E');
-        std::memcpy(reinterpret_cast<char*>(&vertex.first),
-                    data + 1 + sizeof(vertex_uid_t::first_type) + sizeof(vertex_uid_t::second_type),
-                    sizeof(vertex_uid_t::first_type));
-        std::memcpy(reinterpret_cast<char*>(&vertex.second),
-                    data + 1 + 2 * sizeof(vertex_uid_t::first_type) +
-                        sizeof(vertex_uid_t::second_type),
-                    sizeof(vertex_uid_t::second_type));
+        decode_vertex(data + 1 + vertex_size, vertex);
+    }
+
+    /**
+     * \brief decode the identifier of the target vertex of an edge key, when its
+     * type is already known. The identifier is read with a single byte swap.
+     */
+    static inline vertex_id_t decode_edge_dest_id(const char* data, size_t size) {
+        static_cast<void>(size);
+        assert(size == std::tuple_size<edge_key_t>::value);
+        assert(data[0] == 'E');
+        return decode_id(data + 1 + vertex_size + sizeof(vertex_t));
+    }
+
+    /**
+     * \brief decode the target vertex of an edge key in separate arrays
+     */
+    static inline void decode_edge_dest(const char* data,
+                                        size_t size,
+                                        std::vector<vertex_t>& types,
+                                        std::vector<vertex_id_t>& ids) {
+        static_cast<void>(size);
+        assert(size == std::tuple_size<edge_key_t>::value);
+        assert(data[0] == 'E');
+        types.push_back(decode_type(data + 1 + vertex_size));
+        ids.push_back(decode_id(data + 1 + vertex_size + sizeof(vertex_t)));
     }
 
     static inline void decode_vertex(const char* data, size_t size, vertex_uid_t& vertex) {
         static_cast<void>(size);
         assert(size == 1 + sizeof(vertex_uid_t::first_type) + sizeof(vertex_uid_t::second_type));
         assert(data[0] == 'N');
-        std::memcpy(reinterpret_cast<char*>(&vertex.first),
-                    data + 1,
-                    sizeof(vertex_uid_t::first_type));
-        std::memcpy(reinterpret_cast<char*>(&vertex.second),
-                    data + 1 + sizeof(vertex_uid_t::first_type),
-                    sizeof(vertex_uid_t::second_type));
+        decode_vertex(data + 1, vertex);
     }
 
     static inline void decode_edge(const char* data, size_t size, edge_uid_t& edge) {
         decode_edge_dest(data, size, edge.second);
-        std::memcpy(reinterpret_cast<char*>(&edge.first.first),
-                    data + 1,
-                    sizeof(vertex_uid_t::first_type));
-        std::memcpy(reinterpret_cast<char*>(&edge.first.second),
-                    data + 1 + sizeof(vertex_uid_t::first_type),
-                    sizeof(vertex_uid_t::second_type));
+        decode_vertex(data + 1, edge.first);
+    }
+
+    static inline void decode_adjacency(const char* data,
+                                        size_t size,
+                                        vertex_uid_t& vertex,
+                                        vertex_t& type) {
+        static_cast<void>(size);
+        assert(size == std::tuple_size<adjacency_key_t>::value);
+        assert(data[0] == 'A');
+        decode_vertex(data + 1, vertex);
+        type = decode_type(data + 1 + vertex_size);
     }
 
     /**
      * \}
      */
+
+  private:
+    constexpr static std::size_t vertex_size = sizeof(vertex_t) + sizeof(vertex_id_t);
+
+    template <typename T>
+    static inline void encode_big_endian(T value, char* data) {
+        static_assert(std::is_unsigned<T>::value, "expecting an unsigned integral type");
+        for (auto i = sizeof(T); i > 0; --i) {
+            data[i - 1] = static_cast<char>(value & 0xffu);
+            value >>= CHAR_BIT;
+        }
+    }
+
+    /// decode with one unaligned load and one byte swap instead of a loop over bytes
+    template <typename T>
+    static inline T decode_big_endian(const char* data) {
+        static_assert(std::is_unsigned<T>::value, "expecting an unsigned integral type");
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "expecting a 32 or 64-bit integer");
+        using word_t =
+            typename std::conditional<sizeof(T) == 8, std::uint64_t, std::uint32_t>::type;
+        word_t value;
+        std::memcpy(&value, data, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        value = byte_swap(value);
+#endif
+        return static_cast<T>(value);
+    }
+
+    static inline std::uint32_t byte_swap(std::uint32_t value) {
+        return __builtin_bswap32(value);
+    }
+
+    static inline std::uint64_t byte_swap(std::uint64_t value) {
+        return __builtin_bswap64(value);
+    }
+
+    static inline void encode_vertex(const vertex_uid_t& vertex, char* data) {
+        encode_type(vertex.first, data);
+        encode_id(vertex.second, data + sizeof(vertex_t));
+    }
+
+    static inline void decode_vertex(const char* data, vertex_uid_t& vertex) {
+        vertex.first = decode_type(data);
+        vertex.second = decode_id(data + sizeof(vertex_t));
+    }
 };
 
 }  // namespace basalt
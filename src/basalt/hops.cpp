@@ -0,0 +1,17 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <basalt/hops.hpp>
+
+namespace basalt {
+
+void Hops::clear() {
+    std::vector<std::size_t>().swap(offsets);
+    std::vector<vertex_t>().swap(types);
+    std::vector<vertex_id_t>().swap(ids);
+}
+
+}  // namespace basalt
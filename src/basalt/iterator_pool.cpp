@@ -0,0 +1,210 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <array>
+#include <limits>
+
+#include "iterator_pool.hpp"
+
+namespace basalt {
+
+constexpr std::size_t IteratorPool::max_idle_iterators;
+constexpr std::chrono::milliseconds IteratorPool::max_idle_time;
+
+/**
+ * \return upper bound of the keys starting with the given byte, \a nullptr if there is none
+ */
+static const rocksdb::Slice* byte_upper_bound(char prefix) {
+    static const std::array<char, 256> bytes = []() {
+        std::array<char, 256> result{};
+        for (auto i = 0u; i < result.size(); ++i) {
+            result[i] = static_cast<char>(i + 1);
+        }
+        return result;
+    }();
+    static const std::array<rocksdb::Slice, 256> bounds = []() {
+        std::array<rocksdb::Slice, 256> result{};
+        for (auto i = 0u; i < result.size(); ++i) {
+            result[i] = rocksdb::Slice(&bytes[i], 1);
+        }
+        return result;
+    }();
+    const auto byte = static_cast<unsigned char>(prefix);
+    if (byte == std::numeric_limits<unsigned char>::max()) {
+        return nullptr;
+    }
+    return &bounds[byte];
+}
+
+ManagedIterator::ManagedIterator(rocksdb::Iterator* iterator,
+                                 std::shared_ptr<rocksdb::ColumnFamilyHandle> column,
+                                 char prefix,
+                                 std::weak_ptr<IteratorPool> pool,
+                                 snapshot_ptr_t snapshot,
+                                 std::unique_ptr<Bound> bound)
+    : column_(std::move(column))
+    , iterator_(iterator)
+    , prefix_(prefix)
+    , pool_(std::move(pool))
+    , snapshot_(std::move(snapshot))
+    , bound_(std::move(bound)) {}
+
+ManagedIterator::~ManagedIterator() {
+    if (iterator_) {
+        const auto pool = pool_.lock();
+        if (pool) {
+            pool->release(std::make_pair(column_.get(), prefix_), std::move(iterator_));
+        }
+    }
+}
+
+IteratorPool::IteratorPool(std::shared_ptr<rocksdb::DB> db)
+    : db_(std::move(db)) {}
+
+void IteratorPool::add_column(std::shared_ptr<rocksdb::ColumnFamilyHandle> column,
+                              std::size_t prefix_length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto key = column.get();
+    columns_[key] = {std::move(column), prefix_length};
+}
+
+IteratorPool::Column IteratorPool::find_column(rocksdb::ColumnFamilyHandle* column) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto result = columns_.find(column);
+    if (result == columns_.end()) {
+        return {nullptr, 0};
+    }
+    return result->second;
+}
+
+ManagedIterator IteratorPool::iterate(rocksdb::ColumnFamilyHandle* column,
+                                      char prefix,
+                                      const snapshot_ptr_t& snapshot) {
+    auto handle = find_column(column).handle;
+    if (!snapshot) {
+        // declared first so that expired iterators are deleted once the mutex is unlocked
+        std::vector<std::unique_ptr<rocksdb::Iterator>> expired;
+        std::unique_lock<std::mutex> lock(mutex_);
+        expire(expired);
+        auto& idle = idle_[std::make_pair(column, prefix)];
+        while (!idle.empty()) {
+            // the most recently released iterator is the cheapest to refresh
+            std::unique_ptr<rocksdb::Iterator> iterator(std::move(idle.back().iterator));
+            idle.pop_back();
+            lock.unlock();
+            if (iterator->Refresh().ok()) {
+                return {iterator.release(),
+                        std::move(handle),
+                        prefix,
+                        shared_from_this(),
+                        {},
+                        nullptr};
+            }
+            iterator.reset();
+            lock.lock();
+        }
+    }
+    rocksdb::ReadOptions read_options;
+    read_options.iterate_upper_bound = byte_upper_bound(prefix);
+    read_options.snapshot = snapshot.get();
+    // iterators pinning a snapshot are not recycled since they cannot be refreshed
+    std::weak_ptr<IteratorPool> pool;
+    if (!snapshot) {
+        pool = shared_from_this();
+    }
+    return {db_->NewIterator(read_options, column),
+            std::move(handle),
+            prefix,
+            pool,
+            snapshot,
+            nullptr};
+}
+
+ManagedIterator IteratorPool::iterate(rocksdb::ColumnFamilyHandle* column,
+                                      const rocksdb::Slice& prefix,
+                                      const snapshot_ptr_t& snapshot) {
+    const auto declared = find_column(column);
+    const auto prefix_length = declared.prefix_length;
+    std::unique_ptr<ManagedIterator::Bound> bound(new ManagedIterator::Bound);
+    // smallest key greater than all keys starting with the prefix
+    bound->key = prefix.ToString();
+    while (!bound->key.empty() &&
+           static_cast<unsigned char>(bound->key.back()) ==
+               std::numeric_limits<unsigned char>::max()) {
+        bound->key.pop_back();
+    }
+    rocksdb::ReadOptions read_options;
+    if (!bound->key.empty()) {
+        ++bound->key.back();
+        bound->slice = rocksdb::Slice(bound->key);
+        read_options.iterate_upper_bound = &bound->slice;
+    }
+    // only valid if all keys sharing the extracted prefix also share the given one
+    read_options.prefix_same_as_start = prefix_length > 0 && prefix_length <= prefix.size();
+    read_options.snapshot = snapshot.get();
+    return {db_->NewIterator(read_options, column),
+            declared.handle,
+            prefix.empty() ? '\0' : prefix[0],
+            {},
+            snapshot,
+            std::move(bound)};
+}
+
+ManagedIterator IteratorPool::iterate_until(rocksdb::ColumnFamilyHandle* column,
+                                            const rocksdb::Slice& upper_bound,
+                                            const snapshot_ptr_t& snapshot) {
+    std::unique_ptr<ManagedIterator::Bound> bound(new ManagedIterator::Bound);
+    rocksdb::ReadOptions read_options;
+    if (!upper_bound.empty()) {
+        bound->key = upper_bound.ToString();
+        bound->slice = rocksdb::Slice(bound->key);
+        read_options.iterate_upper_bound = &bound->slice;
+    }
+    read_options.snapshot = snapshot.get();
+    // the iterated range is arbitrary, the iterator is not recycled
+    return {db_->NewIterator(read_options, column),
+            find_column(column).handle,
+            upper_bound.empty() ? '\0' : upper_bound[0],
+            {},
+            snapshot,
+            std::move(bound)};
+}
+
+snapshot_ptr_t IteratorPool::snapshot() {
+    // the snapshot keeps the database open until it is released
+    const auto db = db_;
+    return {db->GetSnapshot(), [db](const rocksdb::Snapshot* snapshot) {
+                db->ReleaseSnapshot(snapshot);
+            }};
+}
+
+void IteratorPool::release(const scope_t& scope, std::unique_ptr<rocksdb::Iterator> iterator) {
+    // declared first so that expired iterators are deleted once the mutex is unlocked
+    std::vector<std::unique_ptr<rocksdb::Iterator>> expired;
+    std::lock_guard<std::mutex> lock(mutex_);
+    expire(expired);
+    auto& idle = idle_[scope];
+    if (idle.size() < max_idle_iterators) {
+        // the iterator is refreshed when handed out again, not while idle
+        idle.push_back({std::move(iterator), clock_type::now()});
+    }
+}
+
+void IteratorPool::expire(std::vector<std::unique_ptr<rocksdb::Iterator>>& expired) {
+    const auto deadline = clock_type::now() - max_idle_time;
+    for (auto& scope: idle_) {
+        auto& idle = scope.second;
+        // iterators are appended as they are released, the oldest come first
+        auto last = idle.begin();
+        while (last != idle.end() && last->released < deadline) {
+            expired.push_back(std::move(last->iterator));
+            ++last;
+        }
+        idle.erase(idle.begin(), last);
+    }
+}
+
+}  // namespace basalt
@@ -0,0 +1,179 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rocksdb/db.h>
+
+namespace basalt {
+
+/// RocksDB snapshot released when the last reference goes away
+using snapshot_ptr_t = std::shared_ptr<const rocksdb::Snapshot>;
+
+class IteratorPool;
+
+/**
+ * Owning handle of a RocksDB iterator. The iterator is given back to the pool
+ * it comes from, or deleted, when the handle goes out of scope. The handle
+ * shares the ownership of the iterated column family, and so of the database,
+ * so that it may outlive the graph it comes from.
+ */
+class ManagedIterator {
+  public:
+    ManagedIterator(ManagedIterator&& other) noexcept = default;
+    ManagedIterator(const ManagedIterator&) = delete;
+    ManagedIterator& operator=(const ManagedIterator&) = delete;
+    ManagedIterator& operator=(ManagedIterator&&) = delete;
+    ~ManagedIterator();
+
+    inline rocksdb::Iterator* get() const noexcept {
+        return iterator_.get();
+    }
+    inline rocksdb::Iterator* operator->() const noexcept {
+        return iterator_.get();
+    }
+    inline rocksdb::Iterator& operator*() const noexcept {
+        return *iterator_;
+    }
+
+  private:
+    friend class IteratorPool;
+
+    /// upper bound of the iterated keys, referenced by the iterator read options
+    struct Bound {
+        std::string key;
+        rocksdb::Slice slice;
+    };
+
+    ManagedIterator(rocksdb::Iterator* iterator,
+                    std::shared_ptr<rocksdb::ColumnFamilyHandle> column,
+                    char prefix,
+                    std::weak_ptr<IteratorPool> pool,
+                    snapshot_ptr_t snapshot,
+                    std::unique_ptr<Bound> bound);
+
+    /// declared first so that the column family is released after the iterator
+    std::shared_ptr<rocksdb::ColumnFamilyHandle> column_;
+    std::unique_ptr<rocksdb::Iterator> iterator_;
+    /// first byte of the iterated keys
+    char prefix_;
+    /// pool to give the iterator back to, empty if the iterator is not recyclable
+    std::weak_ptr<IteratorPool> pool_;
+    snapshot_ptr_t snapshot_;
+    std::unique_ptr<Bound> bound_;
+};
+
+/**
+ * Create bounded RocksDB iterators, and recycle those visiting a whole column
+ * family. Recycled iterators are refreshed when handed out again so that they
+ * do not see stale data. An idle iterator still pins the memtables and SST
+ * files it last read, so iterators idle for longer than \a max_idle_time are
+ * deleted at the next acquisition or release of an iterator.
+ */
+class IteratorPool: public std::enable_shared_from_this<IteratorPool> {
+  public:
+    /// maximum number of idle iterators kept per column family
+    static constexpr std::size_t max_idle_iterators = 4;
+    /// idle iterators unused for longer than this duration are deleted
+    static constexpr std::chrono::milliseconds max_idle_time{1000};
+
+    explicit IteratorPool(std::shared_ptr<rocksdb::DB> db);
+
+    /**
+     * \brief declare a column family to iterate over. The iterators share its ownership.
+     * \param column column family, it must keep the database open until its deletion
+     * \param prefix_length length of the prefixes extracted from the keys of the column family,
+     * 0 if there is no prefix extractor. It lets prefix iterations restrict themselves to the
+     * prefix of their seek key.
+     */
+    void add_column(std::shared_ptr<rocksdb::ColumnFamilyHandle> column,
+                    std::size_t prefix_length);
+
+    /**
+     * \brief iterate over a whole column family whose keys all start with the same byte
+     * \param column column family
+     * \param prefix first byte of all keys of the column family
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    ManagedIterator iterate(rocksdb::ColumnFamilyHandle* column,
+                            char prefix,
+                            const snapshot_ptr_t& snapshot = {});
+
+    /**
+     * \brief iterate over the keys starting with a given prefix
+     * \param column column family
+     * \param prefix prefix of the iterated keys, the iterator is not positioned
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    ManagedIterator iterate(rocksdb::ColumnFamilyHandle* column,
+                            const rocksdb::Slice& prefix,
+                            const snapshot_ptr_t& snapshot = {});
+
+    /**
+     * \brief iterate over the keys lower than a given bound
+     * \param column column family
+     * \param upper_bound exclusive upper bound of the iterated keys, copied by the iterator.
+     * The keys are not bounded if empty.
+     * \param snapshot snapshot to read from, the latest state of the database if empty
+     */
+    ManagedIterator iterate_until(rocksdb::ColumnFamilyHandle* column,
+                                  const rocksdb::Slice& upper_bound,
+                                  const snapshot_ptr_t& snapshot = {});
+
+    /// \brief create a snapshot of the database released with its last reference
+    snapshot_ptr_t snapshot();
+
+  private:
+    friend class ManagedIterator;
+
+    using clock_type = std::chrono::steady_clock;
+    /// column family and first byte of the keys visited by an iterator
+    using scope_t = std::pair<rocksdb::ColumnFamilyHandle*, char>;
+
+    /// iterator kept for reuse
+    struct IdleIterator {
+        std::unique_ptr<rocksdb::Iterator> iterator;
+        /// time the iterator was given back to the pool
+        clock_type::time_point released;
+    };
+
+    /// column family declared with \a add_column
+    struct Column {
+        std::shared_ptr<rocksdb::ColumnFamilyHandle> handle;
+        std::size_t prefix_length;
+    };
+
+    /// \return the declared column family, an empty one if unknown
+    Column find_column(rocksdb::ColumnFamilyHandle* column);
+
+    /// \brief keep an iterator for reuse, delete it if the pool is full
+    void release(const scope_t& scope, std::unique_ptr<rocksdb::Iterator> iterator);
+
+    /**
+     * \brief take the iterators idle for longer than \a max_idle_time out of the pool,
+     * the mutex must be locked
+     * \param expired where the iterators are moved, to be deleted once the mutex is unlocked
+     */
+    void expire(std::vector<std::unique_ptr<rocksdb::Iterator>>& expired);
+
+    // members are declared so that idle iterators are deleted before the
+    // column families, themselves released before the database
+    const std::shared_ptr<rocksdb::DB> db_;
+    std::mutex mutex_;
+    std::map<rocksdb::ColumnFamilyHandle*, Column> columns_;
+    std::map<scope_t, std::vector<IdleIterator>> idle_;
+};
+
+}  // namespace basalt
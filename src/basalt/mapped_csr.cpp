@@ -0,0 +1,263 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <basalt/csr.hpp>
+
+#include "mapped_csr.hpp"
+
+namespace basalt {
+
+const char* const MappedCSR::filename = "topology.csr";
+constexpr std::uint32_t MappedCSR::format_version;
+
+struct MappedCSR::Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t orientation;
+    std::uint64_t sequence;
+    std::uint64_t num_vertices;
+    std::uint64_t num_edges;
+};
+
+static const char csr_magic[8] = {'B', 'A', 'S', 'A', 'L', 'T', 'C', 'S'};
+
+/// \return size in bytes of the vertex types, padded to keep the next arrays aligned
+static std::size_t types_size(std::uint64_t num_vertices) {
+    return (num_vertices * sizeof(vertex_t) + 7) / 8 * 8;
+}
+
+/// \return expected size of a file
+static std::size_t file_size(std::uint64_t num_vertices, std::uint64_t num_edges) {
+    return sizeof(MappedCSR::Header) + types_size(num_vertices) +
+           num_vertices * sizeof(vertex_id_t) +
+           (num_vertices + 1 + num_edges) * sizeof(std::int64_t);
+}
+
+template <typename T>
+static void write_array(std::ofstream& ostr, const std::vector<T>& array) {
+    ostr.write(reinterpret_cast<const char*>(array.data()),
+               static_cast<std::streamsize>(array.size() * sizeof(T)));
+}
+
+rocksdb::Status MappedCSR::write(const std::string& path,
+                                 const CSR& csr,
+                                 EdgeOrientation orientation,
+                                 std::uint64_t sequence) {
+    Header header{};
+    std::memcpy(header.magic, csr_magic, sizeof(csr_magic));
+    header.version = format_version;
+    header.orientation = static_cast<std::uint32_t>(orientation);
+    header.sequence = sequence;
+    header.num_vertices = csr.num_vertices();
+    header.num_edges = csr.num_edges();
+
+    // readers never see a partially written file
+    const auto tmp_path = path + ".tmp";
+    std::ofstream ostr(tmp_path, std::ios::binary | std::ios::trunc);
+    ostr.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_array(ostr, csr.types);
+    const std::vector<char> padding(types_size(header.num_vertices) -
+                                    header.num_vertices * sizeof(vertex_t));
+    write_array(ostr, padding);
+    write_array(ostr, csr.ids);
+    write_array(ostr, csr.offsets);
+    write_array(ostr, csr.indices);
+    ostr.close();
+    if (!ostr) {
+        std::remove(tmp_path.c_str());
+        return rocksdb::Status::IOError("Could not write CSR file", tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        const auto error = errno;
+        std::remove(tmp_path.c_str());
+        return rocksdb::Status::IOError("Could not rename CSR file " + tmp_path,
+                                        std::strerror(error));
+    }
+    return rocksdb::Status::OK();
+}
+
+rocksdb::Status MappedCSR::open(const std::string& path, std::unique_ptr<MappedCSR>& csr) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return rocksdb::Status::NotFound(path);
+        }
+        return rocksdb::Status::IOError(path, std::strerror(errno));
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        const auto error = errno;
+        close(fd);
+        return rocksdb::Status::IOError(path, std::strerror(error));
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (size < sizeof(Header)) {
+        close(fd);
+        return rocksdb::Status::Corruption("Truncated CSR file", path);
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping remains valid after the file is closed
+    close(fd);
+    if (data == MAP_FAILED) {
+        return rocksdb::Status::IOError(path, std::strerror(errno));
+    }
+    std::unique_ptr<MappedCSR> mapped(new MappedCSR(data, size));
+    const auto& header = *mapped->header_;
+    if (std::memcmp(header.magic, csr_magic, sizeof(csr_magic)) != 0) {
+        return rocksdb::Status::Corruption("Not a CSR file", path);
+    }
+    if (header.version != format_version) {
+        return rocksdb::Status::NotSupported("Unsupported CSR file version", path);
+    }
+    if (file_size(header.num_vertices, header.num_edges) != size) {
+        return rocksdb::Status::Corruption("Unexpected size of CSR file", path);
+    }
+    csr = std::move(mapped);
+    return rocksdb::Status::OK();
+}
+
+MappedCSR::MappedCSR(void* data, std::size_t size)
+    : data_(data)
+    , size_(size)
+    , header_(static_cast<const Header*>(data)) {
+    const auto* arrays = static_cast<const char*>(data) + sizeof(Header);
+    types_ = reinterpret_cast<const vertex_t*>(arrays);
+    arrays += types_size(header_->num_vertices);
+    ids_ = reinterpret_cast<const vertex_id_t*>(arrays);
+    arrays += header_->num_vertices * sizeof(vertex_id_t);
+    offsets_ = reinterpret_cast<const std::int64_t*>(arrays);
+    indices_ = offsets_ + header_->num_vertices + 1;
+}
+
+MappedCSR::~MappedCSR() {
+    munmap(data_, size_);
+}
+
+EdgeOrientation MappedCSR::orientation() const noexcept {
+    return static_cast<EdgeOrientation>(header_->orientation);
+}
+
+std::uint64_t MappedCSR::sequence() const noexcept {
+    return header_->sequence;
+}
+
+std::int64_t MappedCSR::lower_bound(vertex_t type, vertex_id_t id) const {
+    const auto types_end = types_ + header_->num_vertices;
+    const auto type_range = std::equal_range(types_, types_end, type);
+    const auto first = ids_ + (type_range.first - types_);
+    const auto last = ids_ + (type_range.second - types_);
+    return std::lower_bound(first, last, id) - ids_;
+}
+
+std::int64_t MappedCSR::index(const vertex_uid_t& vertex) const {
+    const auto index = lower_bound(vertex.first, vertex.second);
+    if (static_cast<std::uint64_t>(index) == header_->num_vertices ||
+        types_[index] != vertex.first || ids_[index] != vertex.second) {
+        return -1;
+    }
+    return index;
+}
+
+MappedCSR::range_t MappedCSR::neighbours(const vertex_uid_t& vertex) const {
+    const auto index = this->index(vertex);
+    if (index < 0) {
+        return {indices_, indices_};
+    }
+    return {indices_ + offsets_[index], indices_ + offsets_[index + 1]};
+}
+
+MappedCSR::range_t MappedCSR::neighbours(const vertex_uid_t& vertex,
+                                         std::int64_t first,
+                                         std::int64_t last) const {
+    // neighbours are sorted like the vertices
+    const auto all = neighbours(vertex);
+    const auto begin = std::lower_bound(all.first, all.second, first);
+    return {begin, std::lower_bound(begin, all.second, last)};
+}
+
+MappedCSR::range_t MappedCSR::neighbours(const vertex_uid_t& vertex, vertex_t filter) const {
+    const auto type_range = std::equal_range(types_, types_ + header_->num_vertices, filter);
+    return neighbours(vertex, type_range.first - types_, type_range.second - types_);
+}
+
+void MappedCSR::append(const range_t& range, vertex_uids_t& edges) const {
+    edges.reserve(edges.size() + static_cast<std::size_t>(range.second - range.first));
+    for (auto neighbour = range.first; neighbour != range.second; ++neighbour) {
+        edges.emplace_back(types_[*neighbour], ids_[*neighbour]);
+    }
+}
+
+bool MappedCSR::has(const vertex_uid_t& vertex1, const vertex_uid_t& vertex2) const {
+    const auto target = index(vertex2);
+    if (target < 0) {
+        return false;
+    }
+    const auto range = neighbours(vertex1);
+    return std::binary_search(range.first, range.second, target);
+}
+
+void MappedCSR::get(const vertex_uid_t& vertex, vertex_uids_t& edges) const {
+    append(neighbours(vertex), edges);
+}
+
+void MappedCSR::get(const vertex_uid_t& vertex, vertex_t filter, vertex_uids_t& edges) const {
+    append(neighbours(vertex, filter), edges);
+}
+
+void MappedCSR::get(const vertex_uid_t& vertex,
+                    vertex_t filter,
+                    vertex_id_t first,
+                    vertex_id_t last,
+                    vertex_uids_t& edges) const {
+    if (first < last) {
+        append(neighbours(vertex, lower_bound(filter, first), lower_bound(filter, last)), edges);
+    }
+}
+
+void MappedCSR::get(const vertex_uid_t& vertex,
+                    vertex_t filter,
+                    std::vector<vertex_id_t>& ids) const {
+    const auto range = neighbours(vertex, filter);
+    ids.reserve(ids.size() + static_cast<std::size_t>(range.second - range.first));
+    for (auto neighbour = range.first; neighbour != range.second; ++neighbour) {
+        ids.push_back(ids_[*neighbour]);
+    }
+}
+
+void MappedCSR::get(const vertex_uid_t& vertex,
+                    std::vector<vertex_t>& types,
+                    std::vector<vertex_id_t>& ids) const {
+    const auto range = neighbours(vertex);
+    const auto count = static_cast<std::size_t>(range.second - range.first);
+    types.reserve(types.size() + count);
+    ids.reserve(ids.size() + count);
+    for (auto neighbour = range.first; neighbour != range.second; ++neighbour) {
+        types.push_back(types_[*neighbour]);
+        ids.push_back(ids_[*neighbour]);
+    }
+}
+
+std::size_t MappedCSR::degree(const vertex_uid_t& vertex) const {
+    const auto range = neighbours(vertex);
+    return static_cast<std::size_t>(range.second - range.first);
+}
+
+std::size_t MappedCSR::degree(const vertex_uid_t& vertex, vertex_t filter) const {
+    const auto range = neighbours(vertex, filter);
+    return static_cast<std::size_t>(range.second - range.first);
+}
+
+}  // namespace basalt
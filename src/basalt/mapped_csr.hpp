@@ -0,0 +1,127 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rocksdb/status.h>
+
+#include <basalt/fwd.hpp>
+
+namespace basalt {
+
+/**
+ * Immutable compressed sparse row file mapped in memory, answering neighbour
+ * queries of read-only graphs without looking up the database. Processes
+ * opening the same file share its pages.
+ *
+ * The file is made of a header followed by the arrays of a \a CSR structure,
+ * in native byte order and aligned on 8 bytes:
+ * - the vertex types as 32-bit integers, padded to a multiple of 8 bytes
+ * - the vertex identifiers as 64-bit integers
+ * - the offsets and the neighbour indices as 64-bit integers
+ *
+ * The header records the sequence number of the database snapshot the file
+ * was exported from, so that a file outdated by later writes can be detected.
+ */
+class MappedCSR {
+  public:
+    /// name of the file in the graph directory
+    static const char* const filename;
+    /// version of the file layout
+    constexpr static std::uint32_t format_version = 1;
+    /// beginning of the file
+    struct Header;
+
+    /**
+     * \brief write a CSR file, atomically replacing an existing one
+     * \param path file to write
+     * \param csr topology of the graph
+     * \param orientation orientation of the edges of the graph
+     * \param sequence sequence number of the snapshot \a csr was built from
+     * \return information whether operation succeeded or not
+     */
+    static rocksdb::Status write(const std::string& path,
+                                 const CSR& csr,
+                                 EdgeOrientation orientation,
+                                 std::uint64_t sequence);
+
+    /**
+     * \brief map a CSR file in memory
+     * \param csr set to the mapped file
+     * \return \a rocksdb::Status::NotFound if the file does not exist,
+     * \a rocksdb::Status::Corruption if it is not a valid CSR file
+     */
+    static rocksdb::Status open(const std::string& path, std::unique_ptr<MappedCSR>& csr);
+
+    ~MappedCSR();
+
+    MappedCSR(const MappedCSR&) = delete;
+    MappedCSR& operator=(const MappedCSR&) = delete;
+
+    /// \return orientation of the edges of the exported graph
+    EdgeOrientation orientation() const noexcept;
+    /// \return sequence number of the database snapshot the file was exported from
+    std::uint64_t sequence() const noexcept;
+
+    /// \return true if the edge (vertex1, vertex2) exists
+    bool has(const vertex_uid_t& vertex1, const vertex_uid_t& vertex2) const;
+
+    /// \brief append all neighbours of a vertex to \a edges
+    void get(const vertex_uid_t& vertex, vertex_uids_t& edges) const;
+    /// \brief append the neighbours of a vertex of a certain type to \a edges
+    void get(const vertex_uid_t& vertex, vertex_t filter, vertex_uids_t& edges) const;
+    /// \brief append the neighbours of a vertex of a certain type whose identifiers
+    /// are in [first, last) to \a edges
+    void get(const vertex_uid_t& vertex,
+             vertex_t filter,
+             vertex_id_t first,
+             vertex_id_t last,
+             vertex_uids_t& edges) const;
+    /// \brief append the identifiers of the neighbours of a vertex of a certain type to \a ids
+    void get(const vertex_uid_t& vertex, vertex_t filter, std::vector<vertex_id_t>& ids) const;
+    /// \brief append the types and identifiers of all neighbours of a vertex
+    void get(const vertex_uid_t& vertex,
+             std::vector<vertex_t>& types,
+             std::vector<vertex_id_t>& ids) const;
+
+    /// \return number of neighbours of a vertex
+    std::size_t degree(const vertex_uid_t& vertex) const;
+    /// \return number of neighbours of a vertex of a certain type
+    std::size_t degree(const vertex_uid_t& vertex, vertex_t filter) const;
+
+  private:
+    using range_t = std::pair<const std::int64_t*, const std::int64_t*>;
+
+    MappedCSR(void* data, std::size_t size);
+
+    /// \return dense index of a vertex, -1 if missing
+    std::int64_t index(const vertex_uid_t& vertex) const;
+    /// \return dense index of the first vertex greater or equal to (type, id)
+    std::int64_t lower_bound(vertex_t type, vertex_id_t id) const;
+    /// \return neighbours of a vertex
+    range_t neighbours(const vertex_uid_t& vertex) const;
+    /// \return neighbours of a vertex whose dense index is in [first, last)
+    range_t neighbours(const vertex_uid_t& vertex, std::int64_t first, std::int64_t last) const;
+    /// \return neighbours of a vertex of a certain type
+    range_t neighbours(const vertex_uid_t& vertex, vertex_t filter) const;
+    void append(const range_t& range, vertex_uids_t& edges) const;
+
+    void* data_;
+    const std::size_t size_;
+    const Header* header_;
+    const vertex_t* types_;
+    const vertex_id_t* ids_;
+    const std::int64_t* offsets_;
+    const std::int64_t* indices_;
+};
+
+}  // namespace basalt
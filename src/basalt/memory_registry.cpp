@@ -0,0 +1,63 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <map>
+#include <mutex>
+
+#include "memory_registry.hpp"
+
+namespace basalt {
+
+namespace {
+
+/**
+ * Weak references of named objects, guarded by a mutex
+ */
+template <typename T>
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::weak_ptr<T>> entries;
+
+    template <typename Factory>
+    std::shared_ptr<T> get(const std::string& name, const Factory& factory) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = entries[name];
+        auto result = entry.lock();
+        if (!result) {
+            result = factory();
+            entry = result;
+        }
+        return result;
+    }
+};
+
+Registry<rocksdb::Cache>& block_caches() {
+    static Registry<rocksdb::Cache> registry;
+    return registry;
+}
+
+Registry<rocksdb::WriteBufferManager>& write_buffer_managers() {
+    static Registry<rocksdb::WriteBufferManager> registry;
+    return registry;
+}
+
+}  // namespace
+
+std::shared_ptr<rocksdb::Cache> MemoryRegistry::block_cache(const std::string& name,
+                                                            const cache_factory_t& factory) {
+    return block_caches().get(name, factory);
+}
+
+std::shared_ptr<rocksdb::WriteBufferManager> MemoryRegistry::write_buffer_manager(
+    const std::string& name,
+    std::size_t buffer_size,
+    const std::shared_ptr<rocksdb::Cache>& cache) {
+    return write_buffer_managers().get(name, [buffer_size, &cache]() {
+        return std::make_shared<rocksdb::WriteBufferManager>(buffer_size, cache);
+    });
+}
+
+}  // namespace basalt
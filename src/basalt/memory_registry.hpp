@@ -0,0 +1,50 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <rocksdb/cache.h>
+#include <rocksdb/write_buffer_manager.h>
+
+namespace basalt {
+
+/**
+ * Process-wide registry of the RocksDB memory pools shared by name between
+ * every database opened in the process. A pool lives as long as one database
+ * uses it, the first configuration registering a name decides its size.
+ */
+class MemoryRegistry {
+  public:
+    using cache_factory_t = std::function<std::shared_ptr<rocksdb::Cache>()>;
+
+    /**
+     * \brief Get a block cache shared by name
+     * \param name cache name
+     * \param factory function creating the cache if not registered yet
+     * \return the shared block cache
+     */
+    static std::shared_ptr<rocksdb::Cache> block_cache(const std::string& name,
+                                                       const cache_factory_t& factory);
+
+    /**
+     * \brief Get a write buffer manager shared by name
+     * \param name manager name
+     * \param buffer_size memory budget of all memtables, in bytes
+     * \param cache block cache memtables are charged to, may be \a nullptr
+     * \return the shared write buffer manager
+     */
+    static std::shared_ptr<rocksdb::WriteBufferManager> write_buffer_manager(
+        const std::string& name,
+        std::size_t buffer_size,
+        const std::shared_ptr<rocksdb::Cache>& cache);
+};
+
+}  // namespace basalt
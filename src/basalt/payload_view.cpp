@@ -0,0 +1,50 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <utility>
+
+#include <rocksdb/slice.h>
+
+#include <basalt/payload_view.hpp>
+
+namespace basalt {
+
+PayloadView::PayloadView()
+    : slice_(new rocksdb::PinnableSlice) {}
+
+PayloadView::PayloadView(PayloadView&& other) noexcept = default;
+
+PayloadView& PayloadView::operator=(PayloadView&& other) noexcept = default;
+
+PayloadView::~PayloadView() = default;
+
+const char* PayloadView::data() const noexcept {
+    return slice_ ? slice_->data() : nullptr;
+}
+
+std::size_t PayloadView::size() const noexcept {
+    return slice_ ? slice_->size() : 0;
+}
+
+void PayloadView::reset() {
+    if (slice_) {
+        slice_->Reset();
+    }
+    owner_.reset();
+}
+
+rocksdb::PinnableSlice& PayloadView::slice() {
+    if (!slice_) {
+        slice_.reset(new rocksdb::PinnableSlice);
+    }
+    return *slice_;
+}
+
+void PayloadView::keep_alive(std::shared_ptr<const void> owner) {
+    owner_ = std::move(owner);
+}
+
+}  // namespace basalt
@@ -20,7 +20,7 @@ uint64_t available_memory_bytes() {
         throw std::runtime_error(std::string("Could not get total available RAM: ") +
                                  std::strerror(errno));
     }
-    return info.totalram;
+    return static_cast<uint64_t>(info.totalram) * info.mem_unit;
 }
 
 }  // namespace system
@@ -0,0 +1,81 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <algorithm>
+
+#include "thread_pool.hpp"
+
+namespace basalt {
+
+ThreadPool::ThreadPool(std::size_t num_threads)
+    : stopping_(false) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(num_threads);
+    for (auto i = 0ul; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker: workers_) {
+        worker.join();
+    }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> packaged(std::move(task));
+    auto result = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(packaged));
+    }
+    condition_.notify_one();
+    return result;
+}
+
+void ThreadPool::parallel_for(std::size_t count,
+                              const std::function<void(std::size_t)>& function) {
+    if (count == 1) {
+        function(0);
+        return;
+    }
+    std::vector<std::future<void>> results;
+    results.reserve(count);
+    for (auto i = 0ul; i < count; ++i) {
+        results.push_back(submit([&function, i]() { function(i); }));
+    }
+    for (auto& result: results) {
+        result.wait();
+    }
+    for (auto& result: results) {
+        result.get();
+    }
+}
+
+void ThreadPool::run() {
+    for (;;) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+}  // namespace basalt
@@ -0,0 +1,64 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace basalt {
+
+/**
+ * Fixed-size pool of worker threads executing tasks in submission order.
+ */
+class ThreadPool {
+  public:
+    /**
+     * \param num_threads number of workers, 0 means one per hardware thread
+     */
+    explicit ThreadPool(std::size_t num_threads);
+
+    /// wait for the pending tasks then join the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// \return number of workers
+    inline std::size_t size() const noexcept {
+        return workers_.size();
+    }
+
+    /**
+     * \brief schedule a task
+     * \return future becoming ready when the task is done,
+     * and holding the exception it may have thrown
+     */
+    std::future<void> submit(std::function<void()> task);
+
+    /**
+     * \brief call a function for every index in [0, count) on the workers
+     * and wait for all calls to complete. The first exception thrown, if any,
+     * is rethrown once all calls are done.
+     */
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& function);
+
+  private:
+    void run();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::packaged_task<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_;
+};
+
+}  // namespace basalt
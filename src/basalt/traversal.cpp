@@ -0,0 +1,26 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <basalt/traversal.hpp>
+
+namespace basalt {
+
+Traversal& Traversal::out() {
+    steps_.push_back({Operation::out, false, 0});
+    return *this;
+}
+
+Traversal& Traversal::out(vertex_t type) {
+    steps_.push_back({Operation::out, true, type});
+    return *this;
+}
+
+Traversal& Traversal::distinct() {
+    steps_.push_back({Operation::distinct, false, 0});
+    return *this;
+}
+
+}  // namespace basalt
@@ -24,6 +24,14 @@ VertexIterator::VertexIterator(const basalt::GraphImpl<Orientation>& pimpl, size
     }
 }
 
+template <EdgeOrientation Orientation>
+VertexIterator::VertexIterator(const basalt::GraphImpl<Orientation>& pimpl,
+                               const vertex_uid_t& from)
+    : pimpl_(pimpl.vertex_iterator(from)) {}
+
+VertexIterator::VertexIterator(std::shared_ptr<VertexIteratorImpl> pimpl)
+    : pimpl_(std::move(pimpl)) {}
+
 VertexIterator::VertexIterator(const basalt::VertexIterator& other)
     : pimpl_(other.pimpl_) {}
 
@@ -58,9 +66,20 @@ const VertexIterator::value_type& VertexIterator::operator*() {
     return **pimpl_;
 }
 
+std::string VertexIterator::token() const {
+    if (!pimpl_) {
+        return {};
+    }
+    return pimpl_->token();
+}
+
 template VertexIterator::VertexIterator(const basalt::GraphImpl<EdgeOrientation::directed>& pimpl,
                                         size_t from);
 template VertexIterator::VertexIterator(const basalt::GraphImpl<EdgeOrientation::undirected>& pimpl,
                                         size_t from);
+template VertexIterator::VertexIterator(const basalt::GraphImpl<EdgeOrientation::directed>& pimpl,
+                                        const vertex_uid_t& from);
+template VertexIterator::VertexIterator(const basalt::GraphImpl<EdgeOrientation::undirected>& pimpl,
+                                        const vertex_uid_t& from);
 
 }  // namespace basalt
@@ -14,13 +14,23 @@
 
 namespace basalt {
 
-VertexIteratorImpl::VertexIteratorImpl(const basalt::db_t& db,
-                                       rocksdb::ColumnFamilyHandle* vertices,
-                                       const std::string& /*prefix*/,
-                                       std::size_t position)
-    : position_(position) {
-    iter_ = db->NewIterator(rocksdb::ReadOptions(), vertices);
+VertexIteratorImpl::VertexIteratorImpl(ManagedIterator iterator, std::size_t position)
+    : iter_(std::move(iterator))
+    , position_(position) {
     iter_->SeekToFirst();
+    check_valid();
+}
+
+VertexIteratorImpl::VertexIteratorImpl(ManagedIterator iterator, const vertex_uid_t& from)
+    : iter_(std::move(iterator))
+    , position_() {
+    GraphKV::vertex_key_t key;
+    GraphKV::encode(from, key);
+    iter_->Seek(rocksdb::Slice(key.data(), key.size()));
+    check_valid();
+}
+
+void VertexIteratorImpl::check_valid() {
     if (!iter_->Valid()) {
         position_ = std::numeric_limits<std::size_t>::max();
     }
@@ -28,7 +38,7 @@ VertexIteratorImpl::VertexIteratorImpl(const basalt::db_t& db,
 }
 
 bool VertexIteratorImpl::operator==(const basalt::VertexIteratorImpl& rhs) const {
-    return this->iter_ == rhs.iter_ and this->position_ == rhs.position_;
+    return this->iter_.get() == rhs.iter_.get() and this->position_ == rhs.position_;
 }
 
 VertexIteratorImpl& VertexIteratorImpl::operator++() {
@@ -55,4 +65,11 @@ bool VertexIteratorImpl::end_reached() const {
     return position_ == std::numeric_limits<std::size_t>::max();
 }
 
+std::string VertexIteratorImpl::token() const {
+    if (end_reached()) {
+        return {};
+    }
+    return iter_->key().ToString();
+}
+
 }  // namespace basalt
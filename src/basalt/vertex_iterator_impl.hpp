@@ -11,16 +11,23 @@
 #include <basalt/vertex_iterator.hpp>
 
 #include "fwd.hpp"
+#include "iterator_pool.hpp"
 
 namespace basalt {
 
 class VertexIteratorImpl {
   public:
     using value_type = VertexIterator::value_type;
-    explicit VertexIteratorImpl(const db_t& db,
-                                rocksdb::ColumnFamilyHandle* vertices,
-                                const std::string& prefix,
-                                std::size_t position);
+    /**
+     * \param iterator iterator over the vertices column family
+     * \param position index of the first vertex
+     */
+    VertexIteratorImpl(ManagedIterator iterator, std::size_t position);
+    /**
+     * \param iterator iterator over the vertices column family
+     * \param from first vertex to visit, or the next one if missing
+     */
+    VertexIteratorImpl(ManagedIterator iterator, const vertex_uid_t& from);
 
     inline std::size_t position_get() const {
         return position_;
@@ -33,8 +40,14 @@ class VertexIteratorImpl {
 
     bool end_reached() const;
 
+    /// \return the key of the current vertex
+    std::string token() const;
+
   private:
-    rocksdb::Iterator* iter_;
+    /// \brief mark the end of the iteration if the underlying iterator is exhausted
+    void check_valid();
+
+    ManagedIterator iter_;
     std::size_t position_;
     std::remove_const<value_type>::type value;
 };
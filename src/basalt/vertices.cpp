@@ -5,11 +5,13 @@
  * Lesser General Public License. See top-level LICENSE file for details.
  *************************************************************************/
 #include <limits>
+#include <stdexcept>
 
 #include <basalt/vertex_iterator.hpp>
 #include <basalt/vertices.hpp>
 
 #include "graph_impl.hpp"
+#include "graph_kv.hpp"
 
 namespace basalt {
 
@@ -52,11 +54,31 @@ Status Vertices<Orientation>::has(const vertex_uid_t& vertex, bool& result) cons
     return pimpl_.vertices_has(vertex, result);
 }
 
+template <EdgeOrientation Orientation>
+Status Vertices<Orientation>::has(const vertex_uid_t* vertices,
+                                  std::size_t num_vertices,
+                                  bool* results) const {
+    return pimpl_.vertices_has({vertices, num_vertices}, {results, num_vertices});
+}
+
 template <EdgeOrientation Orientation>
 Status Vertices<Orientation>::get(const basalt::vertex_uid_t& vertex, std::string* value) const {
     return pimpl_.vertices_get(vertex, value);
 }
 
+template <EdgeOrientation Orientation>
+Status Vertices<Orientation>::get(const vertex_uid_t& vertex, PayloadView& value) const {
+    return pimpl_.vertices_get(vertex, value);
+}
+
+template <EdgeOrientation Orientation>
+Status Vertices<Orientation>::range(vertex_t type,
+                                    vertex_id_t first,
+                                    vertex_id_t last,
+                                    vertex_uids_t& vertices) const {
+    return pimpl_.vertices_range(type, first, last, vertices);
+}
+
 template <EdgeOrientation Orientation>
 Status Vertices<Orientation>::erase(const vertex_uid_t& vertex, bool commit) {
     return pimpl_.vertices_erase(vertex, commit);
@@ -67,6 +89,13 @@ Status Vertices<Orientation>::count(std::size_t& count) const {
     return pimpl_.vertices_count(count);
 }
 
+template <EdgeOrientation Orientation>
+Status Vertices<Orientation>::parallel_for_each(
+    const std::function<void(std::size_t, const vertex_uid_t&)>& visitor,
+    std::size_t num_partitions) const {
+    return pimpl_.vertices_parallel_for_each(num_partitions, visitor);
+}
+
 template <EdgeOrientation Orientation>
 Status Vertices<Orientation>::count(vertex_t type, std::size_t& count) const {
     return pimpl_.vertices_count(type, count);
@@ -77,6 +106,34 @@ VertexIterator Vertices<Orientation>::begin(size_t position) const {
     return {pimpl_, position};
 }
 
+template <EdgeOrientation Orientation>
+VertexIterator Vertices<Orientation>::begin(const vertex_uid_t& from) const {
+    return {pimpl_, from};
+}
+
+template <EdgeOrientation Orientation>
+VertexIterator Vertices<Orientation>::resume(const std::string& token) const {
+    if (token.empty()) {
+        return end();
+    }
+    if (token.size() != std::tuple_size<GraphKV::vertex_key_t>::value || token[0] != 'N') {
+        throw std::runtime_error("Invalid vertex iterator token");
+    }
+    vertex_uid_t from;
+    GraphKV::decode_vertex(token.data(), token.size(), from);
+    return begin(from);
+}
+
+template <EdgeOrientation Orientation>
+VertexIterator Vertices<Orientation>::begin_type(vertex_t type) const {
+    return VertexIterator(pimpl_.vertex_type_iterator(type));
+}
+
+template <EdgeOrientation Orientation>
+VertexIterator Vertices<Orientation>::end_type(vertex_t /* type */) const {
+    return end();
+}
+
 template <EdgeOrientation Orientation>
 VertexIterator Vertices<Orientation>::end() const {
     return {pimpl_, std::numeric_limits<std::size_t>::max()};
@@ -17,9 +17,14 @@
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 
+#include "basalt/bulk_loader.hpp"
+#include "basalt/csr.hpp"
+#include "basalt/hops.hpp"
+#include "basalt/traversal.hpp"
 #include "basalt/version.hpp"
 #include "config.hpp"
 #include "graph_impl.hpp"
+#include "py_bulk_loader.hpp"
 #include "py_graph_edges.hpp"
 #include "py_graph_vertices.hpp"
 #include "py_helpers.hpp"
@@ -150,6 +155,29 @@ static const char* graph_commit = R"(
     >>> graph.commit()
 )";
 
+static const char* graph_recount = R"(
+    Recompute the number of vertices and edges of the graph by iterating
+    over the whole database. Counters are otherwise kept up to date along
+    every insertion and removal.
+
+    Raises:
+        RuntimeException: uppon error
+
+    >>> graph.recount()
+)";
+
+static const char* graph_bulk_loader = R"(
+    Create a loader to insert a large number of vertices and edges
+
+    Args:
+        max_memory(int): approximative number of bytes the loader buffers in memory
+        num_threads(int): number of threads sorting and writing vertices and edges,
+        0 means one per hardware thread
+
+    Returns:
+        instance of :py:class:`BulkLoader`
+)";
+
 static const char* graph_edges = R"(
     Get wrapper around the edges of the graph
 
@@ -164,6 +192,145 @@ static const char* graph_vertices = R"(
         instance of :py:class:`Vertices`
 )";
 
+static const char* csr = R"(
+    Compressed sparse row representation of the topology of a graph,
+    returned by the ``snapshot_csr`` method of the graphs.
+
+    Vertices are indexed densely, sorted by type then identifier. The neighbours
+    of the vertex at index ``i`` are ``indices[offsets[i]:offsets[i + 1]]``.
+    The arrays are read-only views of the structure, shared without copy.
+
+    Attributes:
+        types(np.array(dtype=np.int32)): type of every vertex
+        ids(np.array(dtype=np.uint64)): identifier of every vertex
+        offsets(np.array(dtype=np.int64)): position of the neighbours of every vertex
+            in ``indices``, followed by the number of edges
+        indices(np.array(dtype=np.int64)): dense index of the neighbours of every vertex
+
+    >>> csr = graph.snapshot_csr()
+    >>> matrix = scipy.sparse.csr_matrix(
+    ...     (np.ones(len(csr.indices)), csr.indices, csr.offsets),
+    ...     shape=(len(csr.types), len(csr.types)))
+)";
+
+static const char* csr_index = R"(
+    Get the dense index of a vertex
+
+    Args:
+        vertex(tuple): vertex to look for
+
+    Returns:
+        index of the vertex, -1 if it is not in the snapshot
+)";
+
+static const char* csr_connected_components = R"(
+    Label the weakly connected components of the graph, in parallel
+
+    Args:
+        num_threads(int): number of threads, 0 means one per hardware thread
+
+    Returns:
+        `np.array(dtype=np.int64)` holding the component of every vertex,
+        i.e. the smallest dense index of the vertices of its component
+)";
+
+static const char* csr_pagerank = R"(
+    Compute the PageRank of every vertex by power iteration, in parallel.
+    Ranks of the vertices without neighbours are distributed among all vertices.
+
+    Args:
+        damping(float): probability to follow an edge rather than jump to any vertex
+        tolerance(float): iterations stop once the L1 norm of the change of ranks
+        is below this value
+        max_iterations(int): maximum number of iterations
+        num_threads(int): number of threads, 0 means one per hardware thread
+
+    Returns:
+        `np.array(dtype=np.float64)` holding the rank of every vertex, summing to 1
+)";
+
+static const char* graph_snapshot_csr = R"(
+    Build the compressed sparse row representation of the graph topology from a
+    consistent snapshot of the database, in one parallel pass over the vertices
+    then the edges.
+
+    Args:
+        num_partitions(int): maximum number of ranges of vertices and edges visited
+        concurrently, 0 means one per hardware thread
+
+    Returns:
+        instance of :py:class:`CSR`
+)";
+
+static const char* graph_export_csr = R"(
+    Write the compressed sparse row representation of the graph topology in the
+    graph directory. Graphs later opened with the ``read_only`` configuration
+    map this file in memory to answer neighbour and degree queries, unless the
+    database was modified after the export.
+
+    Args:
+        num_partitions(int): maximum number of ranges of vertices and edges visited
+        concurrently, 0 means one per hardware thread
+)";
+
+static const char* graph_k_hop = R"(
+    Visit the graph breadth-first from a set of vertices. Every hop expands the
+    whole frontier at once in C++, and all hops read the same snapshot of the database.
+
+    Args:
+        types(np.array(dtype=np.int32)): types of the seed vertices.
+        ids(np.array(dtype=np.uint64)): identifiers of the seed vertices.
+        num_hops(int): number of hops
+        type_filters(list of int): type of the vertices reached at every hop,
+        empty to follow edges to vertices of any type
+
+    Returns:
+        list of `num_hops` tuples of arrays, the types as `np.array(dtype=np.int32)`
+        and the identifiers as `np.array(dtype=np.uint64)` of the vertices first
+        reached at every hop, sorted
+)";
+
+static const char* traversal = R"(
+    Sequence of steps transforming a multiset of vertices, executed at once
+    in C++ by :py:meth:`UndirectedGraph.traverse`. Steps are recorded in order,
+    and every method returns the instance so that calls can be chained:
+
+    >>> traversal = basalt.Traversal().out(1).out(2).distinct()
+    >>> len(traversal)
+    3
+)";
+
+static const char* traversal_out = R"(
+    Replace every vertex by its neighbours
+
+    Args:
+        type(int): type of the neighbours to follow, all types if not specified
+
+    Returns:
+        this instance
+)";
+
+static const char* traversal_distinct = R"(
+    Remove duplicate vertices
+
+    Returns:
+        this instance
+)";
+
+static const char* graph_traverse = R"(
+    Execute a traversal from a set of vertices. Every step is applied to all
+    vertices at once in C++, and all steps read the same snapshot of the database.
+
+    Args:
+        types(np.array(dtype=np.int32)): types of the seed vertices.
+        ids(np.array(dtype=np.uint64)): identifiers of the seed vertices.
+        traversal(Traversal): steps to execute
+
+    Returns:
+        tuple of 2 arrays, the types as `np.array(dtype=np.int32)` and
+        the identifiers as `np.array(dtype=np.uint64)` of the resulting vertices
+)";
+
 static const char* graph_statistics = R"(
     Get RocksDB usage statistics as a string
 )";
@@ -171,6 +338,64 @@ static const char* graph_statistics = R"(
 }  // namespace docstring
 
 
+template <basalt::EdgeOrientation Orientation>
+static py::list graph_k_hop(const basalt::Graph<Orientation>& graph,
+                            py::array_t<basalt::vertex_t> types,
+                            py::array_t<basalt::vertex_id_t> ids,
+                            std::size_t num_hops,
+                            const std::vector<basalt::vertex_t>& type_filters) {
+    if (types.ndim() != 1 || ids.ndim() != 1) {
+        throw std::runtime_error("Number of dimensions of arrays must be one");
+    }
+    if (ids.size() != types.size()) {
+        throw std::runtime_error("Number of types and ids differ");
+    }
+    basalt::vertex_uids_t seeds;
+    seeds.reserve(static_cast<std::size_t>(ids.size()));
+    for (auto i = 0l; i < ids.size(); ++i) {
+        seeds.emplace_back(types.data()[i], ids.data()[i]);
+    }
+    basalt::Hops hops;
+    {
+        py::gil_scoped_release release;
+        graph.k_hop(seeds, num_hops, type_filters, hops).raise_on_error();
+    }
+    py::list result;
+    for (auto hop = 1ul; hop <= hops.num_hops(); ++hop) {
+        const auto first = hops.offsets[hop - 1];
+        result.append(py::make_tuple(
+            py::array_t<basalt::vertex_t>(hops.size(hop), hops.types.data() + first),
+            py::array_t<basalt::vertex_id_t>(hops.size(hop), hops.ids.data() + first)));
+    }
+    return result;
+}
+
+template <basalt::EdgeOrientation Orientation>
+static py::tuple graph_traverse(const basalt::Graph<Orientation>& graph,
+                                py::array_t<basalt::vertex_t> types,
+                                py::array_t<basalt::vertex_id_t> ids,
+                                const basalt::Traversal& traversal) {
+    if (types.ndim() != 1 || ids.ndim() != 1) {
+        throw std::runtime_error("Number of dimensions of arrays must be one");
+    }
+    if (ids.size() != types.size()) {
+        throw std::runtime_error("Number of types and ids differ");
+    }
+    basalt::vertex_uids_t seeds;
+    seeds.reserve(static_cast<std::size_t>(ids.size()));
+    for (auto i = 0l; i < ids.size(); ++i) {
+        seeds.emplace_back(types.data()[i], ids.data()[i]);
+    }
+    std::vector<basalt::vertex_t> result_types;
+    std::vector<basalt::vertex_id_t> result_ids;
+    {
+        py::gil_scoped_release release;
+        graph.traverse(seeds, traversal, result_types, result_ids).raise_on_error();
+    }
+    return py::make_tuple(basalt::to_py_array(std::move(result_types)),
+                          basalt::to_py_array(std::move(result_ids)));
+}
+
 #if defined(__clang__)
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wmissing-prototypes"
@@ -210,6 +435,78 @@ PYBIND11_MODULE(_basalt, m) {  // NOLINT
             return oss.str();
         });
 
+    py::class_<basalt::CSR, std::shared_ptr<basalt::CSR>>(m, "CSR", docstring::csr)
+        .def_property_readonly("types",
+                               [](py::object self) {
+                                   return basalt::to_py_array(self.cast<const basalt::CSR&>().types,
+                                                              self);
+                               })
+        .def_property_readonly("ids",
+                               [](py::object self) {
+                                   return basalt::to_py_array(self.cast<const basalt::CSR&>().ids,
+                                                              self);
+                               })
+        .def_property_readonly("offsets",
+                               [](py::object self) {
+                                   return basalt::to_py_array(
+                                       self.cast<const basalt::CSR&>().offsets, self);
+                               })
+        .def_property_readonly("indices",
+                               [](py::object self) {
+                                   return basalt::to_py_array(
+                                       self.cast<const basalt::CSR&>().indices, self);
+                               })
+        .def("index", &basalt::CSR::index, "vertex"_a, docstring::csr_index)
+        .def("connected_components",
+             [](const basalt::CSR& csr, std::size_t num_threads) {
+                 std::vector<std::int64_t> components;
+                 {
+                     py::gil_scoped_release release;
+                     csr.connected_components(components, num_threads);
+                 }
+                 return basalt::to_py_array(std::move(components));
+             },
+             "num_threads"_a = 0,
+             docstring::csr_connected_components)
+        .def("pagerank",
+             [](const basalt::CSR& csr,
+                double damping,
+                double tolerance,
+                std::size_t max_iterations,
+                std::size_t num_threads) {
+                 std::vector<double> ranks;
+                 {
+                     py::gil_scoped_release release;
+                     csr.pagerank(ranks, damping, tolerance, max_iterations, num_threads);
+                 }
+                 return basalt::to_py_array(std::move(ranks));
+             },
+             "damping"_a = 0.85,
+             "tolerance"_a = 1e-6,
+             "max_iterations"_a = 100,
+             "num_threads"_a = 0,
+             docstring::csr_pagerank);
+
+    py::class_<basalt::Traversal>(m, "Traversal", docstring::traversal)
+        .def(py::init<>())
+        .def("out",
+             [](basalt::Traversal& traversal) -> basalt::Traversal& { return traversal.out(); },
+             py::return_value_policy::reference_internal,
+             docstring::traversal_out)
+        .def("out",
+             [](basalt::Traversal& traversal, basalt::vertex_t type) -> basalt::Traversal& {
+                 return traversal.out(type);
+             },
+             "type"_a,
+             py::return_value_policy::reference_internal,
+             docstring::traversal_out)
+        .def("distinct",
+             &basalt::Traversal::distinct,
+             py::return_value_policy::reference_internal,
+             docstring::traversal_distinct)
+        .def("__len__",
+             [](const basalt::Traversal& traversal) { return traversal.steps().size(); });
+
     py::class_<basalt::UndirectedGraph>(m, "UndirectedGraph", docstring::graph)
         .def(py::init<const std::string&>(), "path"_a, docstring::graph_init)
         .def(py::init<const std::string&, const std::string&>(),
@@ -223,6 +520,46 @@ PYBIND11_MODULE(_basalt, m) {  // NOLINT
         .def("commit",
              [](basalt::UndirectedGraph& graph) { graph.commit().raise_on_error(); },
              docstring::graph_commit)
+        .def("recount",
+             [](basalt::UndirectedGraph& graph) { graph.recount().raise_on_error(); },
+             docstring::graph_recount)
+        .def("bulk_loader",
+             &basalt::UndirectedGraph::bulk_loader,
+             "max_memory"_a = 256ul * 1024 * 1024,
+             "num_threads"_a = 0,
+             py::keep_alive<0, 1>(),
+             docstring::graph_bulk_loader)
+        .def("snapshot_csr",
+             [](const basalt::UndirectedGraph& graph, std::size_t num_partitions) {
+                 auto csr = std::make_shared<basalt::CSR>();
+                 {
+                     py::gil_scoped_release release;
+                     graph.snapshot_csr(*csr, num_partitions).raise_on_error();
+                 }
+                 return csr;
+             },
+             "num_partitions"_a = 0,
+             docstring::graph_snapshot_csr)
+        .def("export_csr",
+             [](const basalt::UndirectedGraph& graph, std::size_t num_partitions) {
+                 py::gil_scoped_release release;
+                 graph.export_csr(num_partitions).raise_on_error();
+             },
+             "num_partitions"_a = 0,
+             docstring::graph_export_csr)
+        .def("k_hop",
+             &graph_k_hop<basalt::EdgeOrientation::undirected>,
+             "types"_a,
+             "ids"_a,
+             "num_hops"_a,
+             "type_filters"_a = std::vector<basalt::vertex_t>(),
+             docstring::graph_k_hop)
+        .def("traverse",
+             &graph_traverse<basalt::EdgeOrientation::undirected>,
+             "types"_a,
+             "ids"_a,
+             "traversal"_a,
+             docstring::graph_traverse)
         .def("statistics", &basalt::UndirectedGraph::statistics, docstring::graph_statistics);
 
     py::class_<basalt::DirectedGraph>(m, "DirectedGraph", docstring::directed_graph)
@@ -238,8 +575,49 @@ PYBIND11_MODULE(_basalt, m) {  // NOLINT
         .def("commit",
              [](basalt::DirectedGraph& graph) { graph.commit().raise_on_error(); },
              docstring::graph_commit)
+        .def("recount",
+             [](basalt::DirectedGraph& graph) { graph.recount().raise_on_error(); },
+             docstring::graph_recount)
+        .def("bulk_loader",
+             &basalt::DirectedGraph::bulk_loader,
+             "max_memory"_a = 256ul * 1024 * 1024,
+             "num_threads"_a = 0,
+             py::keep_alive<0, 1>(),
+             docstring::graph_bulk_loader)
+        .def("snapshot_csr",
+             [](const basalt::DirectedGraph& graph, std::size_t num_partitions) {
+                 auto csr = std::make_shared<basalt::CSR>();
+                 {
+                     py::gil_scoped_release release;
+                     graph.snapshot_csr(*csr, num_partitions).raise_on_error();
+                 }
+                 return csr;
+             },
+             "num_partitions"_a = 0,
+             docstring::graph_snapshot_csr)
+        .def("export_csr",
+             [](const basalt::DirectedGraph& graph, std::size_t num_partitions) {
+                 py::gil_scoped_release release;
+                 graph.export_csr(num_partitions).raise_on_error();
+             },
+             "num_partitions"_a = 0,
+             docstring::graph_export_csr)
+        .def("k_hop",
+             &graph_k_hop<basalt::EdgeOrientation::directed>,
+             "types"_a,
+             "ids"_a,
+             "num_hops"_a,
+             "type_filters"_a = std::vector<basalt::vertex_t>(),
+             docstring::graph_k_hop)
+        .def("traverse",
+             &graph_traverse<basalt::EdgeOrientation::directed>,
+             "types"_a,
+             "ids"_a,
+             "traversal"_a,
+             docstring::graph_traverse)
         .def("statistics", &basalt::DirectedGraph::statistics, docstring::graph_vertices);
 
+    basalt::register_bulk_loader(m);
     basalt::register_graph_edges(m);
     basalt::register_graph_vertices(m);
 }
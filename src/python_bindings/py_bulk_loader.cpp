@@ -0,0 +1,215 @@
+/*************************************************************************
+ * Copyright (C) 2019 Blue Brain Project
+ *
+ * This file is part of Basalt distributed under the terms of the GNU
+ * Lesser General Public License. See top-level LICENSE file for details.
+ *************************************************************************/
+#include <vector>
+
+#include <pybind11/numpy.h>
+
+#include "basalt/bulk_loader.hpp"
+#include "py_bulk_loader.hpp"
+
+namespace py = pybind11;
+using pybind11::literals::operator""_a;
+
+namespace basalt {
+
+namespace docstring {
+
+static const char* bulk_loader_class = R"(
+    Load a large number of vertices and edges in a graph
+
+    Vertices and edges are sorted on disk, written in SST files, and
+    eventually ingested all at once in the database. Unlike `graph.edges.add`,
+    both ends of an edge do not need to be in the graph. Nothing is visible
+    in the graph before `ingest` is called.
+
+    >>> graph.vertices.clear()
+    >>> loader = graph.bulk_loader()
+    >>> loader.add_vertices(np.full(3, 1, dtype=np.int32), np.arange(3, dtype=np.uint64))
+    >>> loader.add_vertex((0, 0))
+    >>> loader.add_edges((0, 0), 1, np.arange(3, dtype=np.uint64))
+    >>> loader.ingest()
+    >>> graph.edges.get((0, 0))
+    [(1, 0), (1, 1), (1, 2)]
+
+)";
+
+static const char* add_vertex = R"(
+    Add a vertex to load
+
+    Args:
+        vertex(tuple): vertex unique identifier
+        data(numpy.array): optional vertex payload
+
+)";
+
+static const char* add_vertices = R"(
+    Add vertices to load. Vertices are encoded and sorted on several threads.
+
+    Args:
+        types(numpy.ndarray): vertex types
+        ids(numpy.ndarray): vertex identifiers
+        payloads(list): optional list of numpy.ndarray, one payload per vertex
+
+)";
+
+static const char* add_edge = R"(
+    Add an edge to load
+
+    Args:
+        vertex1(tuple): one end of the edge
+        vertex2(tuple): second end of the edge
+        data(numpy.array): optional edge payload
+
+)";
+
+static const char* add_edges = R"(
+    Add edges between a vertex and several vertices of the same type.
+    Edges are encoded and sorted on several threads.
+
+    Args:
+        vertex(tuple): the vertex to connect to others
+        type(int): type of the target vertices
+        ids(numpy.ndarray): identifiers of the target vertices
+
+)";
+
+static const char* ingest = R"(
+    Write the added vertices and edges in SST files and ingest them
+    atomically in the graph. The loader can be reused afterward.
+
+    Raises:
+        RuntimeException: uppon error
+
+)";
+
+}  // namespace docstring
+
+template <EdgeOrientation Orientation>
+void register_bulk_loader_class(py::module& m, const std::string& class_prefix = "") {
+    py::class_<basalt::BulkLoader<Orientation>>(m,
+                                               (class_prefix + "BulkLoader").c_str(),
+                                               docstring::bulk_loader_class)
+        .def("add_vertex",
+             [](basalt::BulkLoader<Orientation>& loader, const basalt::vertex_uid_t& vertex) {
+                 loader.insert_vertex(vertex).raise_on_error();
+             },
+             "vertex"_a,
+             docstring::add_vertex)
+
+        .def("add_vertex",
+             [](basalt::BulkLoader<Orientation>& loader,
+                const basalt::vertex_uid_t& vertex,
+                py::array_t<char> data) {
+                 if (data.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions must be one");
+                 }
+                 loader.insert_vertex(vertex, data.data(), static_cast<std::size_t>(data.size()))
+                     .raise_on_error();
+             },
+             "vertex"_a,
+             "data"_a,
+             docstring::add_vertex)
+
+        .def("add_vertices",
+             [](basalt::BulkLoader<Orientation>& loader,
+                py::array_t<basalt::vertex_t> types,
+                py::array_t<basalt::vertex_id_t> ids,
+                py::list payloads) {
+                 if (ids.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions of array 'ids' must be one");
+                 }
+                 if (types.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions of array 'types' must be one");
+                 }
+                 if (ids.size() != types.size()) {
+                     throw std::runtime_error("Number of types and ids differ");
+                 }
+                 if (payloads.size() != 0) {
+                     if (static_cast<std::size_t>(ids.size()) != payloads.size()) {
+                         throw std::runtime_error("Number of ids and payloads differ");
+                     }
+                 }
+                 std::vector<const char*> payloads_data;
+                 std::vector<std::size_t> payloads_sizes;
+                 payloads_data.reserve(payloads.size());
+                 payloads_sizes.reserve(payloads.size());
+                 for (py::handle list_item: payloads) {
+                     py::array_t<char> payload = py::cast<py::array_t<char>>(list_item);
+                     payloads_data.push_back(payload.data());
+                     payloads_sizes.push_back(static_cast<std::size_t>(payload.size()));
+                 }
+                 loader
+                     .insert_vertices(types.data(),
+                                      ids.data(),
+                                      payloads_data.empty() ? nullptr : payloads_data.data(),
+                                      payloads_sizes.empty() ? nullptr : payloads_sizes.data(),
+                                      static_cast<std::size_t>(ids.size()))
+                     .raise_on_error();
+             },
+             "types"_a,
+             "ids"_a,
+             "payloads"_a = py::list(),
+             docstring::add_vertices)
+
+        .def("add_edge",
+             [](basalt::BulkLoader<Orientation>& loader,
+                const basalt::vertex_uid_t& vertex1,
+                const basalt::vertex_uid_t& vertex2) {
+                 loader.insert_edge(vertex1, vertex2).raise_on_error();
+             },
+             "vertex1"_a,
+             "vertex2"_a,
+             docstring::add_edge)
+
+        .def("add_edge",
+             [](basalt::BulkLoader<Orientation>& loader,
+                const basalt::vertex_uid_t& vertex1,
+                const basalt::vertex_uid_t& vertex2,
+                py::array_t<char> data) {
+                 if (data.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions must be one");
+                 }
+                 loader
+                     .insert_edge(vertex1,
+                                  vertex2,
+                                  data.data(),
+                                  static_cast<std::size_t>(data.size()))
+                     .raise_on_error();
+             },
+             "vertex1"_a,
+             "vertex2"_a,
+             "data"_a,
+             docstring::add_edge)
+
+        .def("add_edges",
+             [](basalt::BulkLoader<Orientation>& loader,
+                const basalt::vertex_uid_t& vertex,
+                basalt::vertex_t type,
+                py::array_t<basalt::vertex_id_t> ids) {
+                 if (ids.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions of array 'ids' must be one");
+                 }
+                 loader
+                     .insert_edges(vertex, type, ids.data(), static_cast<std::size_t>(ids.size()))
+                     .raise_on_error();
+             },
+             "vertex"_a,
+             "type"_a,
+             "ids"_a,
+             docstring::add_edges)
+
+        .def("ingest",
+             [](basalt::BulkLoader<Orientation>& loader) { loader.ingest().raise_on_error(); },
+             docstring::ingest);
+}
+
+void register_bulk_loader(py::module& m) {
+    register_bulk_loader_class<EdgeOrientation::directed>(m, "Directed");
+    register_bulk_loader_class<EdgeOrientation::undirected>(m);
+}
+
+}  // namespace basalt
@@ -165,6 +165,307 @@ static const char* get_edges_filter = R"(
 
 )";
 
+static const char* get_edges_range = R"(
+    Get vertices of a certain type connected to one vertex
+    whose identifiers are in a given range
+
+    Args:
+        vertex(tuple): vertex unique identifier.
+        filter(int): vertex type.
+        first(int): lower bound of the identifiers, inclusive.
+        last(int): upper bound of the identifiers, exclusive.
+
+    Returns:
+        vector of vertices sorted by identifier (usable like a list).
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (0, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v2)
+    >>> graph.edges.add(v1, v3)
+    >>> for v in graph.edges.get(v1, 0, 3, 10):
+    ...   print(v)
+    (0, 3)
+
+)";
+
+static const char* neighbours = R"(
+    Get all vertices connected to one vertex as NumPy arrays
+
+    Args:
+        vertex(tuple): vertex unique identifier.
+
+    Returns:
+        tuple of 2 arrays, the types as `np.array(dtype=np.int32)` and the
+        identifiers as `np.array(dtype=np.uint64)` of the connected vertices
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (1, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v2)
+    >>> graph.edges.add(v1, v3)
+    >>> types, ids = graph.edges.neighbours(v1)
+    >>> types.tolist(), ids.tolist()
+    ([0, 1], [2, 3])
+
+)";
+
+static const char* neighbours_filter = R"(
+    Get identifiers of the vertices of a certain type connected to one vertex
+
+    Args:
+        vertex(tuple): vertex unique identifier.
+        filter(int): vertex type.
+
+    Returns:
+        `np.array(dtype=np.uint64)` of the identifiers of the connected vertices
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (1, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v2)
+    >>> graph.edges.add(v1, v3)
+    >>> graph.edges.neighbours(v1, 0).tolist()
+    [2]
+
+)";
+
+static const char* get_with_payloads = R"(
+    Get all vertices connected to one vertex along with the payloads of the edges,
+    read in a single pass over the edges of the vertex
+
+    Args:
+        vertex(tuple): vertex unique identifier.
+
+    Returns:
+        tuple of the connected vertices (usable like a list), all payloads
+        concatenated in a `np.array(dtype=np.byte)` and their offsets in a
+        `np.array(dtype=np.uint64)`. The payload of the i-th vertex is
+        `payloads[offsets[i]:offsets[i + 1]]`, empty if the edge has none.
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (1, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v2, np.arange(2, dtype=np.byte))
+    >>> graph.edges.add(v1, v3)
+    >>> vertices, payloads, offsets = graph.edges.get_with_payloads(v1)
+    >>> list(vertices), payloads.tolist(), offsets.tolist()
+    ([(0, 2), (1, 3)], [0, 1], [0, 2, 2])
+
+)";
+
+static const char* get_with_payloads_filter = R"(
+    Get identifiers of the vertices of a certain type connected to one vertex
+    along with the payloads of the edges
+
+    Args:
+        vertex(tuple): vertex unique identifier.
+        filter(int): vertex type.
+
+    Returns:
+        tuple of the identifiers of the connected vertices as a
+        `np.array(dtype=np.uint64)`, the payloads and their offsets
+        like :py:meth:`get_with_payloads`
+
+)";
+
+static const char* degree = R"(
+    Get number of vertices connected to one vertex
+
+    Args:
+        vertex(tuple): vertex unique identifier.
+
+    Returns:
+        number of connected vertices
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (1, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v2)
+    >>> graph.edges.add(v1, v3)
+    >>> graph.edges.degree(v1)
+    2
+
+)";
+
+static const char* degree_filter = R"(
+    Get number of vertices of a certain type connected to one vertex
+
+    Args:
+        vertex(tuple): vertex unique identifier.
+        filter(int): vertex type.
+
+    Returns:
+        number of connected vertices of the given type
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (1, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v2)
+    >>> graph.edges.add(v1, v3)
+    >>> graph.edges.degree(v1, 1)
+    1
+
+)";
+
+static const char* degree_bulk = R"(
+    Get number of vertices connected to several vertices
+
+    Args:
+        types(np.array(dtype=np.int32)): types of the vertices.
+        ids(np.array(dtype=np.uint64)): identifiers of the vertices.
+
+    Returns:
+        np.array(dtype=np.uint64) of the number of connected vertices
+
+)";
+
+static const char* get_many = R"(
+    Get identifiers of the vertices of a certain type connected to several vertices,
+    in compressed sparse row format
+
+    Args:
+        types(np.array(dtype=np.int32)): types of the vertices.
+        ids(np.array(dtype=np.uint64)): identifiers of the vertices.
+        filter(int): type of the connected vertices.
+        num_threads(int): maximum number of threads visiting the vertices,
+            0 means one per hardware thread.
+
+    Returns:
+        tuple of 2 `np.array(dtype=np.uint64)`, the offsets and the neighbours.
+        The neighbours of the i-th vertex are `neighbours[offsets[i]:offsets[i + 1]]`
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (1, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v3)
+    >>> graph.edges.add(v2, v3)
+    >>> offsets, neighbours = graph.edges.get_many(
+    ...     np.array([0, 1, 0], dtype=np.int32), np.array([2, 3, 1], dtype=np.uint64), 0)
+    >>> offsets.tolist(), neighbours.tolist()
+    ([0, 0, 2, 2], [1, 2])
+    >>> offsets, neighbours = graph.edges.get_many(
+    ...     np.array([0, 1, 0], dtype=np.int32), np.array([2, 3, 1], dtype=np.uint64), 1)
+    >>> offsets.tolist(), neighbours.tolist()
+    ([0, 1, 1, 2], [3, 3])
+
+)";
+
+static const char* common = R"(
+    Get the vertices connected to two vertices as NumPy arrays
+
+    Args:
+        vertex1(tuple): first vertex unique identifier.
+        vertex2(tuple): second vertex unique identifier.
+
+    Returns:
+        tuple of 2 arrays, the types as `np.array(dtype=np.int32)` and the
+        identifiers as `np.array(dtype=np.uint64)` of the common neighbours
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3, v4 = [(0, 1), (0, 2), (1, 3), (1, 4)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3, v4]]
+    >>> _ = [graph.edges.add(*edge) for edge in [(v1, v3), (v1, v4), (v2, v3)]]
+    >>> types, ids = graph.edges.common(v1, v2)
+    >>> types.tolist(), ids.tolist()
+    ([1], [3])
+
+)";
+
+static const char* common_filter = R"(
+    Get identifiers of the vertices of a certain type connected to two vertices
+
+    Args:
+        vertex1(tuple): first vertex unique identifier.
+        vertex2(tuple): second vertex unique identifier.
+        filter(int): vertex type.
+
+    Returns:
+        `np.array(dtype=np.uint64)` of the identifiers of the common neighbours
+
+    >>> graph.edges.common(v1, v2, 1).tolist()
+    [3]
+
+)";
+
+static const char* intersection = R"(
+    Get identifiers of the vertices of a certain type connected to all given vertices
+
+    Args:
+        vertices(list of tuple): vertices unique identifiers.
+        filter(int): vertex type.
+
+    Returns:
+        `np.array(dtype=np.uint64)` of the sorted identifiers
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3, v4 = [(0, 1), (0, 2), (1, 3), (1, 4)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3, v4]]
+    >>> _ = [graph.edges.add(*edge) for edge in [(v1, v3), (v1, v4), (v2, v3)]]
+    >>> graph.edges.intersection([v1, v2], 1).tolist()
+    [3]
+
+)";
+
+static const char* union_ = R"(
+    Get identifiers of the vertices of a certain type connected to any given vertex
+
+    Args:
+        vertices(list of tuple): vertices unique identifiers.
+        filter(int): vertex type.
+
+    Returns:
+        `np.array(dtype=np.uint64)` of the sorted identifiers
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3, v4 = [(0, 1), (0, 2), (1, 3), (1, 4)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3, v4]]
+    >>> _ = [graph.edges.add(*edge) for edge in [(v1, v3), (v1, v4), (v2, v3)]]
+    >>> graph.edges.union([v1, v2], 1).tolist()
+    [3, 4]
+
+)";
+
+static const char* difference = R"(
+    Get identifiers of the vertices of a certain type connected to the first given
+    vertex but none of the others
+
+    Args:
+        vertices(list of tuple): vertices unique identifiers.
+        filter(int): vertex type.
+
+    Returns:
+        `np.array(dtype=np.uint64)` of the sorted identifiers
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3, v4 = [(0, 1), (0, 2), (1, 3), (1, 4)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3, v4]]
+    >>> _ = [graph.edges.add(*edge) for edge in [(v1, v3), (v1, v4), (v2, v3)]]
+    >>> graph.edges.difference([v1, v2], 1).tolist()
+    [4]
+
+)";
+
+static const char* count_types = R"(
+    Get number of edges between vertices of certain types
+
+    Args:
+        head(int): type of the vertices where the edges start.
+        tail(int): type of the vertices where the edges end.
+
+    Returns:
+        Number of edges between vertices of the given types
+
+    >>> graph.vertices.clear()
+    >>> v1, v2, v3 = [(0, 1), (0, 2), (1, 3)]
+    >>> _ = [graph.vertices.add(v) for v in [v1, v2, v3]]
+    >>> graph.edges.add(v1, v2)
+    >>> graph.edges.add(v1, v3)
+    >>> graph.edges.count(0, 1)
+    1
+
+)";
+
 static const char* add_edge = R"(
     Add or overwrite an edge
 
@@ -225,8 +526,33 @@ static const char* add_bulk_payload = R"(
 
 )";
 
+static const char* unique = R"(
+    Iterate over the edges of the graph, every undirected edge only once
+
+    Iterating over the edges of an undirected graph yields both directions
+    of every edge. This iteration only yields the direction whose source is the
+    smaller vertex and skips the other ones in the database, at about half the
+    cost of a full pass. All edges of a directed graph are visited.
+
+    Returns:
+        iterator over (source, target) tuples, source <= target if undirected
+
+)";
+
 }  // namespace docstring
 
+/**
+ * \brief combine the neighbours of a specific type of several vertices
+ * \return identifiers of the resulting vertices
+ */
+template <EdgeOrientation Orientation, SetOperation Operation>
+static py::array_t<vertex_id_t> edges_combine(const Edges<Orientation>& edges,
+                                              const vertex_uids_t& vertices,
+                                              vertex_t filter) {
+    std::vector<vertex_id_t> ids;
+    edges.combine(Operation, vertices, filter, ids).raise_on_error();
+    return to_py_array(std::move(ids));
+}
 
 template <EdgeOrientation Orientation>
 py::class_<basalt::Edges<Orientation>> register_graph_edges_class(
@@ -241,6 +567,13 @@ py::class_<basalt::Edges<Orientation>> register_graph_edges_class(
              },
              py::keep_alive<0, 1>())
 
+        .def("unique",
+             [](const basalt::Edges<Orientation>& edges) {
+                 return py::make_iterator(edges.begin_unique(), edges.end_unique());
+             },
+             py::keep_alive<0, 1>(),
+             docstring::unique)
+
         .def("__len__",
              [](const basalt::Edges<Orientation>& edges) {
                  std::size_t count{};
@@ -248,6 +581,150 @@ py::class_<basalt::Edges<Orientation>> register_graph_edges_class(
                  return count;
              })
 
+        .def("degree",
+             [](const basalt::Edges<Orientation>& edges, const basalt::vertex_uid_t& vertex) {
+                 std::size_t degree;
+                 edges.degree(vertex, degree).raise_on_error();
+                 return degree;
+             },
+             "vertex"_a,
+             docstring::degree)
+
+        .def("degree",
+             [](const basalt::Edges<Orientation>& edges,
+                const basalt::vertex_uid_t& vertex,
+                basalt::vertex_t filter) {
+                 std::size_t degree;
+                 edges.degree(vertex, filter, degree).raise_on_error();
+                 return degree;
+             },
+             "vertex"_a,
+             "filter"_a,
+             docstring::degree_filter)
+
+        .def("degree",
+             [](const basalt::Edges<Orientation>& edges,
+                py::array_t<basalt::vertex_t> types,
+                py::array_t<basalt::vertex_id_t> ids) {
+                 if (types.ndim() != 1 || ids.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions of arrays must be one");
+                 }
+                 if (ids.size() != types.size()) {
+                     throw std::runtime_error("Number of types and ids differ");
+                 }
+                 py::array_t<std::size_t> degrees(ids.size());
+                 edges
+                     .degree(types.data(),
+                             ids.data(),
+                             static_cast<std::size_t>(ids.size()),
+                             degrees.mutable_data())
+                     .raise_on_error();
+                 return degrees;
+             },
+             "types"_a,
+             "ids"_a,
+             docstring::degree_bulk)
+
+        .def("get_many",
+             [](const basalt::Edges<Orientation>& edges,
+                py::array_t<basalt::vertex_t> types,
+                py::array_t<basalt::vertex_id_t> ids,
+                basalt::vertex_t filter,
+                std::size_t num_threads) {
+                 if (types.ndim() != 1 || ids.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions of arrays must be one");
+                 }
+                 if (ids.size() != types.size()) {
+                     throw std::runtime_error("Number of types and ids differ");
+                 }
+                 std::vector<std::size_t> offsets;
+                 std::vector<basalt::vertex_id_t> neighbours;
+                 {
+                     py::gil_scoped_release release;
+                     edges
+                         .get_many(types.data(),
+                                   ids.data(),
+                                   static_cast<std::size_t>(ids.size()),
+                                   filter,
+                                   offsets,
+                                   neighbours,
+                                   num_threads)
+                         .raise_on_error();
+                 }
+                 return py::make_tuple(basalt::to_py_array(std::move(offsets)),
+                                       basalt::to_py_array(std::move(neighbours)));
+             },
+             "types"_a,
+             "ids"_a,
+             "filter"_a,
+             "num_threads"_a = 1,
+             docstring::get_many)
+
+        .def("common",
+             [](const basalt::Edges<Orientation>& edges,
+                const basalt::vertex_uid_t& vertex1,
+                const basalt::vertex_uid_t& vertex2) {
+                 basalt::vertex_uids_t vertices;
+                 edges.common(vertex1, vertex2, vertices).raise_on_error();
+                 std::vector<basalt::vertex_t> types;
+                 std::vector<basalt::vertex_id_t> ids;
+                 types.reserve(vertices.size());
+                 ids.reserve(vertices.size());
+                 for (const auto& vertex: vertices) {
+                     types.push_back(vertex.first);
+                     ids.push_back(vertex.second);
+                 }
+                 return py::make_tuple(basalt::to_py_array(std::move(types)),
+                                       basalt::to_py_array(std::move(ids)));
+             },
+             "vertex1"_a,
+             "vertex2"_a,
+             docstring::common)
+
+        .def("common",
+             [](const basalt::Edges<Orientation>& edges,
+                const basalt::vertex_uid_t& vertex1,
+                const basalt::vertex_uid_t& vertex2,
+                basalt::vertex_t filter) {
+                 std::vector<basalt::vertex_id_t> ids;
+                 edges.common(vertex1, vertex2, filter, ids).raise_on_error();
+                 return basalt::to_py_array(std::move(ids));
+             },
+             "vertex1"_a,
+             "vertex2"_a,
+             "filter"_a,
+             docstring::common_filter)
+
+        .def("intersection",
+             edges_combine<Orientation, basalt::SetOperation::set_intersection>,
+             "vertices"_a,
+             "filter"_a,
+             docstring::intersection)
+
+        .def("union",
+             edges_combine<Orientation, basalt::SetOperation::set_union>,
+             "vertices"_a,
+             "filter"_a,
+             docstring::union_)
+
+        .def("difference",
+             edges_combine<Orientation, basalt::SetOperation::set_difference>,
+             "vertices"_a,
+             "filter"_a,
+             docstring::difference)
+
+        .def("count",
+             [](const basalt::Edges<Orientation>& edges,
+                basalt::vertex_t head,
+                basalt::vertex_t tail) {
+                 std::size_t count{};
+                 edges.count(head, tail, count).raise_on_error();
+                 return count;
+             },
+             "head"_a,
+             "tail"_a,
+             docstring::count_types)
+
         .def("add",
              [](basalt::Edges<Orientation>& edges,
                 const basalt::vertex_uid_t& vertex1,
@@ -363,8 +840,8 @@ py::class_<basalt::Edges<Orientation>> register_graph_edges_class(
         .def("get",
              [](const basalt::Edges<Orientation>& edges,
                 const basalt::edge_uid_t& edge) -> py::object {
-                 std::string data;
-                 const auto& status = edges.get(edge, &data);
+                 basalt::PayloadView data;
+                 const auto& status = edges.get(edge, data);
                  if (status.code == basalt::Status::missing_edge_code) {
                      throw py::key_error();
                  }
@@ -372,7 +849,7 @@ py::class_<basalt::Edges<Orientation>> register_graph_edges_class(
                  if (data.empty()) {
                      return py::none();
                  }
-                 return std::move(basalt::to_py_array(data));
+                 return std::move(basalt::to_py_array(std::move(data)));
              },
              "edge"_a,
              docstring::get_data)
@@ -398,6 +875,74 @@ py::class_<basalt::Edges<Orientation>> register_graph_edges_class(
              "filter"_a,
              docstring::get_edges_filter)
 
+        .def("get",
+             [](const basalt::Edges<Orientation>& edges,
+                const basalt::vertex_uid_t& vertex,
+                basalt::vertex_t filter,
+                basalt::vertex_id_t first,
+                basalt::vertex_id_t last) {
+                 basalt::vertex_uids_t eax;
+                 edges.get(vertex, filter, first, last, eax).raise_on_error();
+                 return eax;
+             },
+             "vertex"_a,
+             "filter"_a,
+             "first"_a,
+             "last"_a,
+             docstring::get_edges_range)
+
+        .def("neighbours",
+             [](const basalt::Edges<Orientation>& edges, const basalt::vertex_uid_t& vertex) {
+                 std::vector<basalt::vertex_t> types;
+                 std::vector<basalt::vertex_id_t> ids;
+                 edges.get(vertex, types, ids).raise_on_error();
+                 return py::make_tuple(basalt::to_py_array(std::move(types)),
+                                       basalt::to_py_array(std::move(ids)));
+             },
+             "vertex"_a,
+             docstring::neighbours)
+
+        .def("neighbours",
+             [](const basalt::Edges<Orientation>& edges,
+                const basalt::vertex_uid_t& vertex,
+                basalt::vertex_t filter) {
+                 std::vector<basalt::vertex_id_t> ids;
+                 edges.get(vertex, filter, ids).raise_on_error();
+                 return basalt::to_py_array(std::move(ids));
+             },
+             "vertex"_a,
+             "filter"_a,
+             docstring::neighbours_filter)
+
+        .def("get_with_payloads",
+             [](const basalt::Edges<Orientation>& edges, const basalt::vertex_uid_t& vertex) {
+                 basalt::vertex_uids_t eax;
+                 std::string payloads;
+                 std::vector<std::size_t> offsets;
+                 edges.get_with_payloads(vertex, eax, payloads, offsets).raise_on_error();
+                 return py::make_tuple(std::move(eax),
+                                       basalt::to_py_array(payloads),
+                                       basalt::to_py_array(std::move(offsets)));
+             },
+             "vertex"_a,
+             docstring::get_with_payloads)
+
+        .def("get_with_payloads",
+             [](const basalt::Edges<Orientation>& edges,
+                const basalt::vertex_uid_t& vertex,
+                basalt::vertex_t filter) {
+                 std::vector<basalt::vertex_id_t> ids;
+                 std::string payloads;
+                 std::vector<std::size_t> offsets;
+                 edges.get_with_payloads(vertex, filter, ids, payloads, offsets).raise_on_error();
+                 return py::make_tuple(basalt::to_py_array(std::move(ids)),
+                                       basalt::to_py_array(payloads),
+                                       basalt::to_py_array(std::move(offsets)));
+             },
+             "vertex"_a,
+             "filter"_a,
+             docstring::get_with_payloads_filter)
+
         .def("discard",
              [](basalt::Edges<Orientation>& edges,
                 const basalt::edge_uid_t& edge,
@@ -159,6 +159,58 @@ static const char* getitem = R"(
 
 )";
 
+static const char* has = R"(
+    Check presence of several vertices in the graph with batched lookups
+
+    Args:
+        types(np.array(dtype=np.int32)): types of the vertices.
+        ids(np.array(dtype=np.uint64)): identifiers of the vertices.
+
+    Returns:
+        np.array(dtype=bool) telling whether every vertex is in the graph
+
+    >>> graph.vertices.clear()
+    >>> graph.vertices.add((1, 2))
+    >>> graph.vertices.has(np.array([1, 1], dtype=np.int32), np.array([2, 3], dtype=np.uint64))
+    array([ True, False])
+
+)";
+
+static const char* range = R"(
+    Get vertices of a certain type whose identifiers are in a given range
+
+    Args:
+        type(int): vertex type.
+        first(int): lower bound of the identifiers, inclusive.
+        last(int): upper bound of the identifiers, exclusive.
+
+    Returns:
+        vector of vertices sorted by identifier (usable like a list)
+
+    >>> graph.vertices.clear()
+    >>> _ = [graph.vertices.add((1, i)) for i in range(10)]
+    >>> graph.vertices.range(1, 3, 6)
+    [(1, 3), (1, 4), (1, 5)]
+
+)";
+
+static const char* of_type = R"(
+    Iterate over the vertices of a certain type only, without reading
+    the vertices of the other types
+
+    Args:
+        type(int): vertex type.
+
+    Returns:
+        iterator over the vertices of this type, sorted by identifier
+
+    >>> graph.vertices.clear()
+    >>> _ = [graph.vertices.add((t, i)) for t in range(3) for i in range(2)]
+    >>> list(graph.vertices.of_type(1))
+    [(1, 0), (1, 1)]
+
+)";
+
 }  // namespace docstring
 
 template <EdgeOrientation Orientation>
@@ -174,6 +226,14 @@ py::class_<basalt::Vertices<Orientation>> register_graph_vertices_class(
              },
              py::keep_alive<0, 1>())
 
+        .def("of_type",
+             [](const basalt::Vertices<Orientation>& vertices, basalt::vertex_t type) {
+                 return py::make_iterator(vertices.begin_type(type), vertices.end_type(type));
+             },
+             "type"_a,
+             py::keep_alive<0, 1>(),
+             docstring::of_type)
+
         .def("__len__",
              [](const basalt::Vertices<Orientation>& vertices) {
                  std::size_t count;
@@ -192,6 +252,20 @@ py::class_<basalt::Vertices<Orientation>> register_graph_vertices_class(
              "type"_a,
              docstring::count_type)
 
+        .def("range",
+             [](const basalt::Vertices<Orientation>& vertices,
+                basalt::vertex_t type,
+                basalt::vertex_id_t first,
+                basalt::vertex_id_t last) {
+                 basalt::vertex_uids_t eax;
+                 vertices.range(type, first, last, eax).raise_on_error();
+                 return eax;
+             },
+             "type"_a,
+             "first"_a,
+             "last"_a,
+             docstring::range)
+
         .def("add",
              [](basalt::Vertices<Orientation>& vertices,
                 basalt::vertex_uid_t vertex,
@@ -281,8 +355,8 @@ py::class_<basalt::Vertices<Orientation>> register_graph_vertices_class(
         .def("get",
              [](basalt::Vertices<Orientation>& vertices,
                 const basalt::vertex_uid_t& vertex) -> py::object {
-                 std::string data;
-                 auto const& status = vertices.get(vertex, &data);
+                 basalt::PayloadView data;
+                 auto const& status = vertices.get(vertex, data);
                  if (status.code == basalt::Status::missing_vertex_code) {
                      return py::none();
                  }
@@ -290,7 +364,7 @@ py::class_<basalt::Vertices<Orientation>> register_graph_vertices_class(
                  if (data.empty()) {
                      return py::none();
                  }
-                 return std::move(basalt::to_py_array(data));
+                 return std::move(basalt::to_py_array(std::move(data)));
              },
              "vertex"_a,
              docstring::get)
@@ -298,8 +372,8 @@ py::class_<basalt::Vertices<Orientation>> register_graph_vertices_class(
         .def("__getitem__",
              [](basalt::Vertices<Orientation>& vertices,
                 const basalt::vertex_uid_t& vertex) -> py::object {
-                 std::string data;
-                 auto const& status = vertices.get(vertex, &data);
+                 basalt::PayloadView data;
+                 auto const& status = vertices.get(vertex, data);
                  if (status.code == basalt::Status::missing_vertex_code) {
                      throw py::key_error();
                  }
@@ -307,7 +381,7 @@ py::class_<basalt::Vertices<Orientation>> register_graph_vertices_class(
                  if (data.empty()) {
                      return py::none();
                  }
-                 return std::move(basalt::to_py_array(data));
+                 return std::move(basalt::to_py_array(std::move(data)));
              },
              "vertex"_a,
              docstring::getitem)
@@ -330,6 +404,29 @@ py::class_<basalt::Vertices<Orientation>> register_graph_vertices_class(
              "Check presence of a vertex in the graph",
              "vertex"_a)
 
+        .def("has",
+             [](const basalt::Vertices<Orientation>& vertices,
+                py::array_t<basalt::vertex_t> types,
+                py::array_t<basalt::vertex_id_t> ids) {
+                 if (types.ndim() != 1 || ids.ndim() != 1) {
+                     throw std::runtime_error("Number of dimensions of arrays must be one");
+                 }
+                 if (ids.size() != types.size()) {
+                     throw std::runtime_error("Number of types and ids differ");
+                 }
+                 basalt::vertex_uids_t uids;
+                 uids.reserve(static_cast<std::size_t>(ids.size()));
+                 for (auto i = 0; i < ids.size(); ++i) {
+                     uids.emplace_back(types.at(i), ids.at(i));
+                 }
+                 py::array_t<bool> results(ids.size());
+                 vertices.has(uids.data(), uids.size(), results.mutable_data()).raise_on_error();
+                 return results;
+             },
+             "types"_a,
+             "ids"_a,
+             docstring::has)
+
         .def("discard",
              [](basalt::Vertices<Orientation>& vertices,
                 const basalt::vertex_uid_t& vertex,
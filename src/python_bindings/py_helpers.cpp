@@ -34,4 +34,13 @@ imemstream::imemstream(pybind11::array_t<char>& data)
     : membuf(data)
     , std::istream(this) {}
 
+pybind11::array_t<char> to_py_array(PayloadView&& view) {
+    const auto owner = new PayloadView(std::move(view));
+    const pybind11::capsule base(owner,
+                                 [](void* ptr) { delete static_cast<PayloadView*>(ptr); });
+    pybind11::array_t<char> array(owner->size(), owner->data(), base);
+    array.attr("setflags")(pybind11::arg("write") = false);
+    return array;
+}
+
 }  // namespace basalt
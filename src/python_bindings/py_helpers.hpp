@@ -22,6 +22,7 @@
 
 #include <pybind11/numpy.h>
 
+#include <basalt/payload_view.hpp>
 #include <basalt/settings.hpp>
 
 namespace basalt {
@@ -92,6 +93,43 @@ inline pybind11::array_t<char> to_py_array(const std::string& str) {
     return array;
 }
 
+/**
+ * Expose a payload as a read-only NumPy array without copying it.
+ * The array keeps the payload pinned until it is garbage collected.
+ * \param view payload to expose
+ * \return new NumPY array
+ */
+pybind11::array_t<char> to_py_array(PayloadView&& view);
+
+/**
+ * Expose a vector as a read-only NumPy array without copying it
+ * \tparam T vector value type
+ * \param data vector to expose
+ * \param owner Python object keeping \a data alive as long as the array
+ * \return new NumPY array
+ */
+template <typename T>
+pybind11::array_t<T> to_py_array(const std::vector<T>& data, pybind11::handle owner) {
+    pybind11::array_t<T> array(data.size(), data.data(), owner);
+    array.attr("setflags")(pybind11::arg("write") = false);
+    return array;
+}
+
+/**
+ * Expose a vector as a NumPy array without copying it.
+ * The array takes ownership of the vector content.
+ * \tparam T vector value type
+ * \param data vector to move into the array
+ * \return new NumPY array
+ */
+template <typename T>
+pybind11::array_t<T> to_py_array(std::vector<T>&& data) {
+    const auto owner = new std::vector<T>(std::move(data));
+    const pybind11::capsule base(owner,
+                                 [](void* ptr) { delete static_cast<std::vector<T>*>(ptr); });
+    return pybind11::array_t<T>(owner->size(), owner->data(), base);
+}
+
 /**
  * Write a standard vector to a string stream
  * \tparam T vector value type
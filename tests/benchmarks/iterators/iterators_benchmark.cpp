@@ -0,0 +1,94 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <basalt/basalt.hpp>
+#include <benchmark/benchmark.h>
+
+static const auto NUM_VERTICES = 1024ul;
+
+inline static std::string create_db_path() {
+    char db_path[] = "/tmp/basalt-bench-XXXXXX";
+    if (mkdtemp(static_cast<char*>(db_path)) == nullptr) {
+        throw std::runtime_error(strerror(errno));
+    }
+    return static_cast<char*>(db_path);
+}
+
+/// \return graph shared by all benchmarks, with vertices connected to the first one
+static basalt::DirectedGraph& graph() {
+    static basalt::DirectedGraph result(create_db_path());
+    static const bool populated = []() {
+        std::vector<basalt::vertex_t> types(NUM_VERTICES, 1);
+        std::vector<basalt::vertex_id_t> ids(NUM_VERTICES);
+        for (auto i = 0ul; i < ids.size(); ++i) {
+            ids[i] = i;
+        }
+        result.vertices()
+            .insert(types.data(), ids.data(), nullptr, nullptr, ids.size())
+            .raise_on_error();
+        result.edges()
+            .insert(basalt::make_id(1, 0), 1, ids.data(), ids.size())
+            .raise_on_error();
+        return true;
+    }();
+    static_cast<void>(populated);
+    return result;
+}
+
+/// \return resident set size of the process, in MB
+inline static double resident_memory_mb() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+    statm >> pages >> resident;
+    return static_cast<double>(resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE))) /
+           (1 << 20);
+}
+
+// create many iterators reading only their first element, resident memory
+// reported at the end must not grow with the number of creations
+
+static void vertex_iterator_creation(benchmark::State& state) {
+    const auto& vertices = graph().vertices();
+    for (auto _: state) {
+        for (auto i = 0; i < state.range(0); ++i) {
+            auto iter = vertices.begin();
+            benchmark::DoNotOptimize(*iter);
+        }
+    }
+    state.counters["rss_mb"] = resident_memory_mb();
+}
+BENCHMARK(vertex_iterator_creation)->RangeMultiplier(4)->Range(1 << 12, 1 << 22);
+
+static void edge_iterator_creation(benchmark::State& state) {
+    const auto& edges = graph().edges();
+    for (auto _: state) {
+        for (auto i = 0; i < state.range(0); ++i) {
+            auto iter = edges.begin();
+            benchmark::DoNotOptimize(*iter);
+        }
+    }
+    state.counters["rss_mb"] = resident_memory_mb();
+}
+BENCHMARK(edge_iterator_creation)->RangeMultiplier(4)->Range(1 << 12, 1 << 22);
+
+// full iteration, the iterator being recycled at every loop
+
+static void vertex_iteration(benchmark::State& state) {
+    const auto& vertices = graph().vertices();
+    for (auto _: state) {
+        benchmark::DoNotOptimize(std::distance(vertices.begin(), vertices.end()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * NUM_VERTICES));
+    state.counters["rss_mb"] = resident_memory_mb();
+}
+BENCHMARK(vertex_iteration);
+
+BENCHMARK_MAIN();
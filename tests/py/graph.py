@@ -1,3 +1,4 @@
+import gc
 import json
 import os
 import os.path as osp
@@ -6,7 +7,7 @@ import unittest
 
 import numpy as np
 
-from basalt import UndirectedGraph, make_id, default_config_file
+from basalt import UndirectedGraph, Traversal, make_id, default_config_file
 
 N42 = (0, 42)
 
@@ -39,6 +40,15 @@ class TestUndirectedGraph(unittest.TestCase):
             count += 1
         self.assertEqual(count, 1)
 
+    def test_typed_iteration(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        ids = np.arange(3, dtype=np.uint64)
+        for type in [-1, 0, 1]:
+            g.vertices.add(np.full(len(ids), fill_value=type, dtype=np.int32), ids)
+        self.assertEqual(list(g.vertices.of_type(0)), [(0, 0), (0, 1), (0, 2)])
+        self.assertEqual(list(g.vertices.of_type(-1)), [(-1, 0), (-1, 1), (-1, 2)])
+        self.assertEqual(list(g.vertices.of_type(2)), [])
+
     def test_deletion(self):
         path = tempfile.mkdtemp()
 
@@ -109,6 +119,226 @@ class TestUndirectedGraph(unittest.TestCase):
         self.assertEqual(len(g.edges.get(A, 3)), 2)
         self.assertEqual(len(g.edges.get(A, 2)), 1)
 
+    def test_unique_edges(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        ids = np.arange(4, dtype=np.uint64)
+        g.vertices.add(np.full(len(ids), fill_value=0, dtype=np.int32), ids)
+        g.edges.add((0, 2), 0, ids)
+        unique = list(g.edges.unique())
+        self.assertEqual(unique, [(A, B) for A, B in g.edges if A <= B])
+        self.assertEqual(len(unique), 4)
+
+    def test_snapshot_csr(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        ids = np.arange(4, dtype=np.uint64)
+        g.vertices.add(np.full(len(ids), fill_value=1, dtype=np.int32), ids)
+        g.edges.add((1, 0), 1, ids[1:])
+        csr = g.snapshot_csr()
+        np.testing.assert_array_equal(csr.types, [1, 1, 1, 1])
+        np.testing.assert_array_equal(csr.ids, ids)
+        np.testing.assert_array_equal(csr.offsets, [0, 3, 4, 5, 6])
+        np.testing.assert_array_equal(csr.indices, [1, 2, 3, 0, 0, 0])
+        self.assertEqual(csr.index((1, 2)), 2)
+        self.assertEqual(csr.index((2, 0)), -1)
+        self.assertFalse(csr.indices.flags.writeable)
+        # the arrays keep the snapshot alive
+        indices = csr.indices
+        del csr
+        self.assertEqual(indices.sum(), 6)
+
+    def test_csr_algorithms(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        ids = np.arange(6, dtype=np.uint64)
+        g.vertices.add(np.full(len(ids), fill_value=1, dtype=np.int32), ids)
+        g.edges.add((1, 0), 1, ids[1:3])
+        g.edges.add((1, 3), 1, ids[4:5])
+        csr = g.snapshot_csr()
+        components = csr.connected_components(num_threads=2)
+        self.assertEqual(components.dtype, np.int64)
+        np.testing.assert_array_equal(components, [0, 0, 0, 3, 3, 5])
+        ranks = csr.pagerank(tolerance=1e-9, num_threads=2)
+        self.assertEqual(ranks.dtype, np.float64)
+        self.assertAlmostEqual(ranks.sum(), 1)
+        self.assertGreater(ranks[0], ranks[1])
+        self.assertAlmostEqual(ranks[1], ranks[2])
+        self.assertAlmostEqual(ranks[3], ranks[4])
+
+    def test_id_ranges(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        ids = np.array([0, 1, 255, 256, 65536], dtype=np.uint64)
+        g.vertices.add(np.full(len(ids), fill_value=-1, dtype=np.int32), ids)
+        g.vertices.add(np.full(len(ids), fill_value=1, dtype=np.int32), ids)
+        self.assertEqual(list(g.vertices), sorted(g.vertices))
+        self.assertEqual(g.vertices.range(1, 1, 65536), [(1, 1), (1, 255), (1, 256)])
+        self.assertEqual(g.vertices.range(-1, 256, 1 << 40), [(-1, 256), (-1, 65536)])
+        A = make_id(-1, 0)
+        g.edges.add(A, 1, ids)
+        self.assertEqual(g.edges.get(A, 1, 255, 65537), [(1, 255), (1, 256), (1, 65536)])
+        self.assertEqual(g.edges.get(A, 1, 2, 2), [])
+
+    def test_counters(self):
+        path = tempfile.mkdtemp()
+        g = UndirectedGraph(path)
+        A = make_id(0, 1)
+        g.vertices.add(A)
+        g.vertices.add(A)
+        g.edges.add(A, 1, np.array([1, 2, 2], dtype=np.uint64), create_vertices=True)
+        self.assertEqual(len(g.vertices), 3)
+        self.assertEqual(g.vertices.count(1), 2)
+        self.assertEqual(len(g.edges), 2)
+        self.assertEqual(g.edges.count(0, 1), 2)
+        self.assertEqual(g.edges.count(1, 0), 2)
+        g.edges.discard((A, (1, 2)))
+        self.assertEqual(g.edges.count(1, 0), 1)
+        g.recount()
+        self.assertEqual(len(g.vertices), 3)
+        self.assertEqual(len(g.edges), 1)
+
+    def test_bulk_loader(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        loader = g.bulk_loader(max_memory=1024)
+        loader.add_vertex(A, np.arange(4, dtype=np.byte))
+        ids = np.arange(100, dtype=np.uint64)
+        loader.add_vertices(np.full(len(ids), 1, dtype=np.int32), ids)
+        loader.add_edges(A, 1, ids[::-1])
+        loader.add_edge((1, 0), (1, 1), np.arange(2, dtype=np.byte))
+        self.assertEqual(len(g.vertices), 0)
+        loader.ingest()
+        self.assertEqual(len(g.vertices), 101)
+        self.assertEqual(len(g.edges), 101)
+        self.assertEqual(g.edges.degree(A), 100)
+        self.assertEqual(list(g.vertices.get(A)), [0, 1, 2, 3])
+        self.assertEqual(g.edges.get(A, 1, 0, 3), [(1, 0), (1, 1), (1, 2)])
+
+    def test_parallel_bulk_loader(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        ids = np.random.permutation(20000).astype(np.uint64)
+        types = np.full(len(ids), 1, dtype=np.int32)
+        loader = g.bulk_loader(max_memory=1 << 20, num_threads=4)
+        loader.add_vertices(types, ids, [np.full(1, i % 128, dtype=np.byte) for i in ids])
+        loader.add_edges(A, 1, ids)
+        loader.ingest()
+        self.assertEqual(g.vertices.count(1), len(ids))
+        self.assertEqual(g.edges.degree(A), len(ids))
+        self.assertEqual(list(g.vertices.get((1, 200))), [200 % 128])
+
+    def test_vertices_has(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        g.vertices.add(np.full(3, 1, dtype=np.int32), np.array([5, 1, 3], dtype=np.uint64), [])
+        present = g.vertices.has(
+            np.array([1, 1, 0, 1], dtype=np.int32), np.array([3, 2, 1, 5], dtype=np.uint64)
+        )
+        self.assertEqual(list(present), [True, False, False, True])
+        with self.assertRaises(RuntimeError):
+            g.edges.add((1, 1), 1, np.array([3, 4], dtype=np.uint64))
+
+    def test_readonly_payload(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        g.vertices.add(A, np.arange(4, dtype=np.byte))
+        payload = g.vertices.get(A)
+        self.assertFalse(payload.flags.writeable)
+        with self.assertRaises(ValueError):
+            payload[0] = 42
+        g.vertices.add(A, np.arange(2, dtype=np.byte))
+        self.assertEqual(list(payload), [0, 1, 2, 3])
+        self.assertEqual(list(g.vertices[A]), [0, 1])
+        # payloads keep the database open after the graph is destroyed
+        del g
+        gc.collect()
+        self.assertEqual(list(payload), [0, 1, 2, 3])
+
+    def test_degree(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        g.vertices.add(A)
+        g.edges.add(A, 1, np.array([1, 2, 3], dtype=np.uint64), create_vertices=True)
+        g.edges.add(A, 2, np.array([1], dtype=np.uint64), create_vertices=True)
+        self.assertEqual(g.edges.degree(A), 4)
+        self.assertEqual(g.edges.degree(A, 1), 3)
+        self.assertEqual(g.edges.degree(A, 3), 0)
+        degrees = g.edges.degree(
+            np.array([0, 1, 2, 3], dtype=np.int32), np.array([1, 2, 1, 1], dtype=np.uint64)
+        )
+        self.assertEqual(list(degrees), [4, 1, 1, 0])
+
+    def test_get_many(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        g.vertices.add(A)
+        g.edges.add(A, 1, np.array([3, 2, 1], dtype=np.uint64), create_vertices=True)
+        types = np.array([0, 1, 2, 1], dtype=np.int32)
+        ids = np.array([1, 3, 0, 2], dtype=np.uint64)
+        offsets, neighbours = g.edges.get_many(types, ids, 1)
+        np.testing.assert_array_equal(offsets, [0, 3, 3, 3, 3])
+        np.testing.assert_array_equal(neighbours, [1, 2, 3])
+        offsets, neighbours = g.edges.get_many(types, ids, 0, num_threads=0)
+        np.testing.assert_array_equal(offsets, [0, 0, 1, 1, 2])
+        np.testing.assert_array_equal(neighbours, [1, 1])
+
+    def test_k_hop(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        g.vertices.add(A)
+        g.edges.add(A, 1, np.array([1, 2], dtype=np.uint64), create_vertices=True)
+        g.edges.add((1, 2), 2, np.array([7], dtype=np.uint64), create_vertices=True)
+        hops = g.k_hop(np.array([0], dtype=np.int32), np.array([1], dtype=np.uint64), 3)
+        self.assertEqual(len(hops), 3)
+        types, ids = hops[0]
+        np.testing.assert_array_equal(types, [1, 1])
+        np.testing.assert_array_equal(ids, [1, 2])
+        np.testing.assert_array_equal(hops[1][0], [2])
+        np.testing.assert_array_equal(hops[1][1], [7])
+        self.assertEqual(len(hops[2][0]), 0)
+        hops = g.k_hop(
+            np.array([0], dtype=np.int32), np.array([1], dtype=np.uint64), 2, [1, 0]
+        )
+        np.testing.assert_array_equal(hops[0][1], [1, 2])
+        self.assertEqual(len(hops[1][1]), 0)
+
+    def test_traverse(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        g.vertices.add(A)
+        g.edges.add(A, 1, np.array([1, 2], dtype=np.uint64), create_vertices=True)
+        g.edges.add((1, 2), 2, np.array([7], dtype=np.uint64), create_vertices=True)
+        seed_types = np.array([0], dtype=np.int32)
+        seed_ids = np.array([1], dtype=np.uint64)
+        types, ids = g.traverse(seed_types, seed_ids, Traversal().out(1).out())
+        self.assertEqual(types.dtype, np.int32)
+        self.assertEqual(ids.dtype, np.uint64)
+        np.testing.assert_array_equal(types, [0, 0, 2])
+        np.testing.assert_array_equal(ids, [1, 1, 7])
+        types, ids = g.traverse(seed_types, seed_ids, Traversal().out(1).out().distinct())
+        np.testing.assert_array_equal(types, [0, 2])
+        np.testing.assert_array_equal(ids, [1, 7])
+        # every copy of a seed is expanded
+        types, ids = g.traverse(
+            np.array([0, 0], dtype=np.int32),
+            np.array([1, 1], dtype=np.uint64),
+            Traversal().out(1),
+        )
+        np.testing.assert_array_equal(ids, [1, 2, 1, 2])
+        types, ids = g.traverse(seed_types, seed_ids, Traversal())
+        np.testing.assert_array_equal(ids, [1])
+
+    def test_neighbours(self):
+        g = UndirectedGraph(tempfile.mkdtemp())
+        A = make_id(0, 1)
+        g.vertices.add(A)
+        g.edges.add(A, 1, np.array([3, 2, 1], dtype=np.uint64), create_vertices=True)
+        g.edges.add(A, 2, np.array([1], dtype=np.uint64), create_vertices=True)
+        ids = g.edges.neighbours(A, 1)
+        self.assertEqual(ids.dtype, np.uint64)
+        np.testing.assert_array_equal(ids, [1, 2, 3])
+        self.assertEqual(len(g.edges.neighbours(A, 3)), 0)
+        types, ids = g.edges.neighbours(A)
+        self.assertEqual(types.dtype, np.int32)
+        np.testing.assert_array_equal(types, [1, 1, 1, 2])
+        np.testing.assert_array_equal(ids, [1, 2, 3, 1])
+
     def test_node_removal(self):
         g = UndirectedGraph(tempfile.mkdtemp())
         A = make_id(0, 1)
@@ -162,6 +392,182 @@ class TestConfig(unittest.TestCase):
             config = json.load(istr)
         self.assertEqual(config["read_only"], False)
         self.assertEqual(config["statistics"], True)
+        self.assertEqual(config["key_format"], 1)
+        self.assertEqual(config["edge_storage"], "keys")
+        self.assertEqual(config["edge_payloads"], "canonical")
+
+    def test_packed_edges(self):
+        fd, config_path = tempfile.mkstemp(suffix=".json")
+        os.close(fd)
+        default_config_file(config_path)
+        with open(config_path) as istr:
+            config = json.load(istr)
+        config["edge_storage"] = "packed"
+        with open(config_path, "w") as ostr:
+            json.dump(config, ostr)
+        path = osp.join(tempfile.mkdtemp(), "db")
+        g = UndirectedGraph(path, config_path)
+        A = make_id(0, 1)
+        ids = np.array([3, 2, 42], dtype=np.uint64)
+        g.vertices.add(A)
+        g.vertices.add(np.full(len(ids), fill_value=1, dtype=np.int32), ids)
+        g.edges.add(A, 1, ids)
+        g.edges.add(A, (1, 2))
+        self.assertEqual(len(g.edges), 3)
+        self.assertEqual(g.edges.get(A, 1), [(1, 2), (1, 3), (1, 42)])
+        self.assertEqual(g.edges.get(A, 1, 3, 43), [(1, 3), (1, 42)])
+        np.testing.assert_array_equal(g.edges.neighbours(A, 1), [2, 3, 42])
+        types, ids = g.edges.neighbours(A)
+        np.testing.assert_array_equal(types, [1, 1, 1])
+        np.testing.assert_array_equal(ids, [2, 3, 42])
+        self.assertEqual(g.edges.get((1, 42)), [A])
+        self.assertTrue(((1, 3), A) in g.edges)
+        g.edges.discard((A, (1, 3)))
+        self.assertNotIn(((1, 3), A), g.edges)
+        self.assertEqual(len(g.edges), 2)
+        del g
+
+        # packed storage is read back from the database configuration
+        g = UndirectedGraph(path)
+        self.assertEqual(g.edges.get(A), [(1, 2), (1, 42)])
+        g.vertices.discard(A)
+        self.assertEqual(len(g.edges), 0)
+        self.assertEqual(g.edges.get((1, 2)), [])
+
+    def test_common_neighbours(self):
+        fd, config_path = tempfile.mkstemp(suffix=".json")
+        os.close(fd)
+        default_config_file(config_path)
+        with open(config_path) as istr:
+            config = json.load(istr)
+        A, B, C = make_id(0, 1), make_id(0, 2), make_id(0, 3)
+        for storage in ["keys", "packed"]:
+            config["edge_storage"] = storage
+            with open(config_path, "w") as ostr:
+                json.dump(config, ostr)
+            g = UndirectedGraph(osp.join(tempfile.mkdtemp(), "db"), config_path)
+            g.edges.add(A, 1, np.arange(0, 100, dtype=np.uint64), create_vertices=True)
+            g.edges.add(B, 1, np.array([5, 50, 500], dtype=np.uint64), create_vertices=True)
+            g.edges.add(C, 1, np.array([50, 51], dtype=np.uint64), create_vertices=True)
+            g.edges.add(A, B)
+            g.edges.add(C, B)
+            np.testing.assert_array_equal(g.edges.common(A, B, 1), [5, 50])
+            types, ids = g.edges.common(A, C)
+            np.testing.assert_array_equal(types, [0, 1, 1])
+            np.testing.assert_array_equal(ids, [2, 50, 51])
+            self.assertEqual(g.edges.intersection([A, B, C], 1).tolist(), [50])
+            self.assertEqual(g.edges.intersection([A, B, C], 0).tolist(), [])
+            self.assertEqual(g.edges.union([B, C], 1).tolist(), [5, 50, 51, 500])
+            self.assertEqual(g.edges.difference([B, A, C], 1).tolist(), [500])
+            self.assertEqual(g.edges.difference([A], 0).tolist(), [2])
+            self.assertEqual(g.edges.union([], 1).tolist(), [])
+
+    def test_edge_payloads(self):
+        fd, config_path = tempfile.mkstemp(suffix=".json")
+        os.close(fd)
+        default_config_file(config_path)
+        with open(config_path) as istr:
+            config = json.load(istr)
+        A = make_id(0, 1)
+        B = make_id(0, 2)
+        for storage in ["keys", "packed"]:
+            for payloads in ["both", "canonical"]:
+                config["edge_storage"] = storage
+                config["edge_payloads"] = payloads
+                with open(config_path, "w") as ostr:
+                    json.dump(config, ostr)
+                g = UndirectedGraph(osp.join(tempfile.mkdtemp(), "db"), config_path)
+                g.vertices.add(A)
+                g.vertices.add(B)
+                g.edges.add(B, A, np.arange(3, dtype=np.byte))
+                for edge in [(A, B), (B, A)]:
+                    self.assertEqual(list(g.edges.get(edge)), [0, 1, 2])
+                self.assertEqual(g.edges.get(A), [B])
+                self.assertEqual(g.edges.get(B), [A])
+                for vertex, target in [(A, B), (B, A)]:
+                    targets, payloads, offsets = g.edges.get_with_payloads(vertex)
+                    self.assertEqual(list(targets), [target])
+                    self.assertEqual(payloads.tolist(), [0, 1, 2])
+                    self.assertEqual(offsets.tolist(), [0, 3])
+                ids, payloads, offsets = g.edges.get_with_payloads(B, 0)
+                self.assertEqual(ids.tolist(), [1])
+                self.assertEqual(payloads.tolist(), [0, 1, 2])
+        config["edge_payloads"] = "twice"
+        with open(config_path, "w") as ostr:
+            json.dump(config, ostr)
+        with self.assertRaises(RuntimeError):
+            UndirectedGraph(osp.join(tempfile.mkdtemp(), "db"), config_path)
+
+    def test_table_options(self):
+        fd, config_path = tempfile.mkstemp(suffix=".json")
+        os.close(fd)
+        default_config_file(config_path)
+        with open(config_path) as istr:
+            config = json.load(istr)
+        edges = [cf for cf in config["column_families"] if cf["name"] == "edges"][0]
+        table = edges["config"]["table_factory"]["config"]
+        self.assertEqual(table["index_type"], "binary_search")
+        self.assertIn("filter_policy", table)
+        table["index_type"] = "two_level_index_search"
+        table["partition_filters"] = True
+        table["filter_policy"]["config"]["use_block_based_builder"] = False
+        with open(config_path, "w") as ostr:
+            json.dump(config, ostr)
+        g = UndirectedGraph(osp.join(tempfile.mkdtemp(), "db"), config_path)
+        g.vertices.add(make_id(0, 1))
+        del g
+
+        table["block-size"] = 4096
+        with open(config_path, "w") as ostr:
+            json.dump(config, ostr)
+        with self.assertRaises(RuntimeError):
+            UndirectedGraph(osp.join(tempfile.mkdtemp(), "db"), config_path)
+
+    def test_shared_memory_budget(self):
+        fd, config_path = tempfile.mkstemp(suffix=".json")
+        os.close(fd)
+        default_config_file(config_path)
+        with open(config_path) as istr:
+            config = json.load(istr)
+        self.assertEqual(config["block_cache"]["name"], "basalt")
+        config["block_cache"]["name"] = "test_shared_memory_budget"
+        config["block_cache"]["config"]["capacity"] = "40%"
+        config["write_buffer_manager"]["name"] = "test_shared_memory_budget"
+        config["write_buffer_manager"]["buffer_size"] = "10%"
+        with open(config_path, "w") as ostr:
+            json.dump(config, ostr)
+        graphs = [
+            UndirectedGraph(osp.join(tempfile.mkdtemp(), "db"), config_path) for _ in range(3)
+        ]
+        for i, g in enumerate(graphs):
+            g.vertices.add(make_id(0, i))
+        for i, g in enumerate(graphs):
+            self.assertEqual(len(g.vertices), 1)
+            self.assertIn(make_id(0, i), g.vertices)
+
+    def test_export_csr(self):
+        path = osp.join(tempfile.mkdtemp(), "db")
+        g = UndirectedGraph(path)
+        A = make_id(0, 0)
+        ids = np.arange(3, dtype=np.uint64)
+        g.vertices.add(np.full(len(ids), fill_value=0, dtype=np.int32), ids)
+        g.edges.add(A, 0, ids[1:])
+        g.export_csr()
+        del g
+        self.assertTrue(osp.exists(osp.join(path, "topology.csr")))
+
+        # read-only instances answer neighbour queries from the exported file
+        config_path = osp.join(path, "config.json")
+        with open(config_path) as istr:
+            config = json.load(istr)
+        config["read_only"] = True
+        with open(config_path, "w") as ostr:
+            json.dump(config, ostr)
+        g = UndirectedGraph(path)
+        self.assertEqual(g.edges.get(A), [(0, 1), (0, 2)])
+        self.assertEqual(g.edges.get((0, 2)), [A])
+        self.assertIn((A, (0, 1)), g.edges)
+        self.assertNotIn(((0, 1), (0, 2)), g.edges)
 
 
 if __name__ == '__main__':
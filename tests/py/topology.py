@@ -196,6 +196,23 @@ class TestPLGraph(unittest.TestCase):
                     work.append(influenced)
         self.assertEqual(len(c_rec_influenced), 134)
 
+        # authors of the languages directly inspired from C, in a single traversal
+        types, ids = (
+            g.traverse(PLInfluence.Vertex.LANGUAGE, [g.C])
+            .out(PLInfluence.Vertex.LANGUAGE)
+            .out(PLInfluence.Vertex.DEVELOPER)
+            .distinct()
+            .execute()
+        )
+        authors = set(dev.id for pl in c.influenced for dev in pl.authors)
+        self.assertEqual(len(ids), len(authors))
+        self.assertEqual(set(ids), authors)
+        self.assertTrue(np.all(types == PLInfluence.Vertex.DEVELOPER.value))
+
+        # the schema does not declare edges from licenses
+        with self.assertRaises(ValueError):
+            g.traverse(PLInfluence.Vertex.LICENSE, [0]).out(PLInfluence.Vertex.DEVELOPER)
+
 
 class TestSkillGraph(unittest.TestCase):
     @tempdir
@@ -1,5 +1,13 @@
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
+#include <sys/stat.h>
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
@@ -277,3 +285,865 @@ TEST_CASE("create simple GraphKV and check entities", "[GraphKV]") {
         REQUIRE(edges_set == expected);
     }
 }
+
+TEST_CASE("vertices and edges ordered by type and identifier", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const std::vector<vertex_t> types{-2, 0, 1};
+    const std::vector<vertex_id_t> ids{0, 1, 255, 256, 65536, 1ul << 40u};
+    for (auto type: types) {
+        for (auto id: ids) {
+            checked_insert(g, type, id);
+        }
+    }
+    {
+        // iteration follows numerical order, including negative types
+        vertex_uids_t vertices;
+        for (const auto& vertex: g.vertices()) {
+            vertices.push_back(vertex);
+        }
+        REQUIRE(vertices.size() == types.size() * ids.size());
+        REQUIRE(std::is_sorted(vertices.begin(), vertices.end()));
+    }
+    {
+        vertex_uids_t vertices;
+        g.vertices().range(0, 1, 65536, vertices).raise_on_error();
+        REQUIRE(vertices == vertex_uids_t{make_id(0, 1), make_id(0, 255), make_id(0, 256)});
+        vertices.clear();
+        g.vertices().range(-2, 256, std::numeric_limits<vertex_id_t>::max(), vertices)
+            .raise_on_error();
+        REQUIRE(vertices ==
+                vertex_uids_t{make_id(-2, 256), make_id(-2, 65536), make_id(-2, 1ul << 40u)});
+        vertices.clear();
+        g.vertices().range(1, 2, 2, vertices).raise_on_error();
+        REQUIRE(vertices.empty());
+    }
+    {
+        const auto vertex = make_id(0, 0);
+        check_is_ok(g.edges().insert(vertex, 1, ids.data(), ids.size()));
+        check_is_ok(g.edges().insert(vertex, make_id(-2, 255)));
+        vertex_uids_t edges;
+        check_is_ok(g.edges().get(vertex, 1, 255, 1ul << 40u, edges));
+        REQUIRE(edges == vertex_uids_t{make_id(1, 255), make_id(1, 256), make_id(1, 65536)});
+        edges.clear();
+        check_is_ok(g.edges().get(vertex, edges));
+        REQUIRE(edges.size() == ids.size() + 1);
+        REQUIRE(std::is_sorted(edges.begin(), edges.end()));
+        REQUIRE(edges.front() == make_id(-2, 255));
+    }
+}
+
+TEST_CASE("vertices and edges counters", "[GraphKV]") {
+    const auto path = new_db_path();
+    const auto check_counts = [](DirectedGraph& g,
+                                 std::size_t vertices,
+                                 std::size_t type_1_vertices,
+                                 std::size_t edges,
+                                 std::size_t edges_0_1) {
+        std::size_t count;
+        check_is_ok(g.vertices().count(count));
+        REQUIRE(count == vertices);
+        check_is_ok(g.vertices().count(1, count));
+        REQUIRE(count == type_1_vertices);
+        check_is_ok(g.edges().count(count));
+        REQUIRE(count == edges);
+        check_is_ok(g.edges().count(0, 1, count));
+        REQUIRE(count == edges_0_1);
+    };
+    {
+        DirectedGraph g(path);
+        const auto vertex = make_id(0, 0);
+        // vertices inserted twice are counted once
+        check_is_ok(g.vertices().insert(vertex));
+        check_is_ok(g.vertices().insert(vertex));
+        const std::vector<vertex_id_t> ids{3, 1, 2, 1};
+        check_is_ok(g.edges().insert(vertex, 1, ids.data(), ids.size(), true));
+        check_is_ok(g.edges().insert(vertex, make_id(1, 2)));
+        check_is_ok(g.edges().insert(make_id(1, 2), vertex));
+        check_counts(g, 4, 3, 4, 3);
+
+        check_is_ok(g.edges().erase(vertex, make_id(1, 3)));
+        check_is_ok(g.edges().erase(vertex, make_id(1, 3)));
+        check_counts(g, 4, 3, 3, 2);
+
+        // also removes the reverse edge (1:2) -> (0:0)
+        check_is_ok(g.vertices().erase(vertex));
+        check_counts(g, 3, 3, 0, 0);
+    }
+    {
+        // counters are persistent and in sync with the database content
+        DirectedGraph g(path);
+        check_counts(g, 3, 3, 0, 0);
+        check_is_ok(g.recount());
+        check_counts(g, 3, 3, 0, 0);
+    }
+}
+
+TEST_CASE("degree of vertices", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto vertex = make_id(0, 0);
+    const std::vector<vertex_id_t> ids{1, 2, 3};
+    check_is_ok(g.edges().insert(vertex, 1, ids.data(), ids.size(), true));
+    check_is_ok(g.edges().insert(vertex, 2, ids.data(), 1, true));
+
+    std::size_t degree;
+    check_is_ok(g.edges().degree(vertex, degree));
+    REQUIRE(degree == 4);
+    check_is_ok(g.edges().degree(vertex, 1, degree));
+    REQUIRE(degree == 3);
+    check_is_ok(g.edges().degree(make_id(1, 4), degree));
+    REQUIRE(degree == 0);
+
+    const std::vector<vertex_t> types{0, 1, 2, 2};
+    const std::vector<vertex_id_t> vertices{0, 2, 1, 2};
+    std::vector<std::size_t> degrees(types.size());
+    check_is_ok(g.edges().degree(types.data(), vertices.data(), types.size(), degrees.data()));
+    REQUIRE(degrees == std::vector<std::size_t>{4, 1, 1, 0});
+}
+
+TEST_CASE("neighbours as structure of arrays", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto vertex = make_id(0, 0);
+    const std::vector<vertex_id_t> ids{3, 1, 256};
+    check_is_ok(g.edges().insert(vertex, 1, ids.data(), ids.size(), true));
+    check_is_ok(g.edges().insert(vertex, -1, ids.data(), 1, true));
+
+    std::vector<vertex_id_t> neighbours{42};
+    check_is_ok(g.edges().get(vertex, 1, neighbours));
+    REQUIRE(neighbours == std::vector<vertex_id_t>{42, 1, 3, 256});
+    neighbours.clear();
+    check_is_ok(g.edges().get(vertex, 2, neighbours));
+    REQUIRE(neighbours.empty());
+
+    std::vector<vertex_t> types;
+    check_is_ok(g.edges().get(vertex, types, neighbours));
+    REQUIRE(types == std::vector<vertex_t>{-1, 1, 1, 1});
+    REQUIRE(neighbours == std::vector<vertex_id_t>{3, 1, 3, 256});
+}
+
+TEST_CASE("neighbours with edge payloads", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto vertex = make_id(1, 5);
+    const std::vector<vertex_id_t> ids{1, 2, 8, 9};
+    check_is_ok(g.vertices().insert(vertex));
+    for (const auto id: ids) {
+        check_is_ok(g.vertices().insert(make_id(1, id)));
+    }
+    check_is_ok(g.vertices().insert(make_id(2, 0)));
+    // payloads of edges to smaller vertices are stored under the other key
+    check_is_ok(g.edges().insert(make_id(1, 1), vertex, "ab", 2));
+    check_is_ok(g.edges().insert(vertex, make_id(1, 2)));
+    check_is_ok(g.edges().insert(vertex, make_id(1, 8), "cde", 3));
+    check_is_ok(g.edges().insert(make_id(1, 9), vertex));
+    check_is_ok(g.edges().insert(vertex, make_id(2, 0), "f", 1));
+
+    vertex_uids_t edges;
+    std::string payloads;
+    std::vector<std::size_t> offsets;
+    check_is_ok(g.edges().get_with_payloads(vertex, edges, payloads, offsets));
+    REQUIRE(edges == vertex_uids_t{{1, 1}, {1, 2}, {1, 8}, {1, 9}, {2, 0}});
+    REQUIRE(payloads == "abcdef");
+    REQUIRE(offsets == std::vector<std::size_t>{0, 2, 2, 5, 5, 6});
+
+    std::vector<vertex_id_t> neighbours;
+    payloads = "_";
+    offsets.clear();
+    check_is_ok(g.edges().get_with_payloads(vertex, 1, neighbours, payloads, offsets));
+    REQUIRE(neighbours == ids);
+    REQUIRE(payloads == "_abcde");
+    REQUIRE(offsets == std::vector<std::size_t>{1, 3, 3, 6, 6});
+}
+
+TEST_CASE("neighbours of several vertices", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const vertex_id_t num_vertices = 10000;
+    std::vector<vertex_id_t> ids(num_vertices);
+    std::iota(ids.begin(), ids.end(), 0);
+    const auto hub = make_id(0, 0);
+    const auto other = make_id(0, 1);
+    check_is_ok(g.vertices().insert(hub));
+    check_is_ok(g.vertices().insert(other));
+    check_is_ok(g.edges().insert(hub, 1, ids.data(), ids.size(), true));
+    check_is_ok(g.edges().insert(other, 1, ids.data(), 3));
+
+    // unsorted vertices, with a duplicate and a missing one
+    const std::vector<vertex_t> types{1, 1, 0, 1, 2, 1};
+    const std::vector<vertex_id_t> vertices{9999, 1, 0, 5000, 0, 1};
+    std::vector<std::size_t> offsets;
+    std::vector<vertex_id_t> neighbours;
+    check_is_ok(g.edges().get_many(
+        types.data(), vertices.data(), types.size(), 0, offsets, neighbours));
+    REQUIRE(offsets == std::vector<std::size_t>{0, 1, 3, 3, 4, 4, 6});
+    REQUIRE(neighbours == std::vector<vertex_id_t>{0, 0, 1, 0, 0, 1});
+
+    check_is_ok(g.edges().get_many(
+        types.data(), vertices.data(), types.size(), 1, offsets, neighbours));
+    REQUIRE(offsets[2] == 0);
+    REQUIRE(offsets[3] == num_vertices);
+    REQUIRE(offsets.back() == num_vertices);
+    REQUIRE(neighbours == ids);
+
+    // a chunk of vertices per thread gives the same result
+    std::vector<vertex_t> all_types(num_vertices, 1);
+    std::vector<std::size_t> sequential_offsets;
+    std::vector<vertex_id_t> sequential_neighbours;
+    check_is_ok(g.edges().get_many(all_types.data(),
+                                   ids.data(),
+                                   num_vertices,
+                                   0,
+                                   sequential_offsets,
+                                   sequential_neighbours));
+    check_is_ok(g.edges().get_many(
+        all_types.data(), ids.data(), num_vertices, 0, offsets, neighbours, 4));
+    REQUIRE(offsets == sequential_offsets);
+    REQUIRE(neighbours == sequential_neighbours);
+    REQUIRE(offsets[4] == 7);
+    REQUIRE(neighbours.size() == num_vertices + 3);
+}
+
+TEST_CASE("bulk loading of vertices and edges", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto vertex = make_id(0, 0);
+    {
+        // tiny memory budget to spill sorted runs on disk
+        auto loader = g.bulk_loader(256);
+        const std::vector<vertex_id_t> ids{5, 3, 1, 4, 2, 3};
+        const std::vector<vertex_t> types(ids.size(), 1);
+        check_is_ok(loader.insert_vertex(vertex, "root", 4));
+        check_is_ok(loader.insert_vertices(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+        check_is_ok(loader.insert_edges(vertex, 1, ids.data(), ids.size()));
+        check_is_ok(loader.insert_edge(make_id(1, 1), make_id(1, 2), "payload", 7));
+        check_is_ok(loader.ingest());
+    }
+    std::size_t count;
+    check_is_ok(g.vertices().count(count));
+    REQUIRE(count == 6);
+    check_is_ok(g.edges().count(count));
+    REQUIRE(count == 6);
+    std::string payload;
+    check_is_ok(g.vertices().get(vertex, &payload));
+    REQUIRE(payload == "root");
+    check_is_ok(g.edges().get({make_id(1, 2), make_id(1, 1)}, &payload));
+    REQUIRE(payload == "payload");
+    vertex_uids_t edges;
+    check_is_ok(g.edges().get(vertex, edges));
+    REQUIRE(edges.size() == 5);
+    REQUIRE(std::is_sorted(edges.begin(), edges.end()));
+
+    {
+        // loading in a non-empty graph only counts the new records
+        auto loader = g.bulk_loader();
+        check_is_ok(loader.insert_vertex(make_id(1, 3)));
+        check_is_ok(loader.insert_vertex(make_id(1, 6)));
+        check_is_ok(loader.insert_edge(vertex, make_id(1, 1)));
+        check_is_ok(loader.insert_edge(vertex, make_id(1, 6)));
+        check_is_ok(loader.ingest());
+    }
+    check_is_ok(g.vertices().count(count));
+    REQUIRE(count == 7);
+    check_is_ok(g.edges().count(count));
+    REQUIRE(count == 7);
+    check_is_ok(g.edges().degree(vertex, count));
+    REQUIRE(count == 6);
+}
+
+TEST_CASE("parallel bulk loading", "[GraphKV]") {
+    DirectedGraph g(new_db_path());
+    const auto vertex = make_id(0, 0);
+    const std::size_t num_vertices = 50000;
+    std::vector<vertex_id_t> ids(num_vertices);
+    for (auto i = 0ul; i < num_vertices; ++i) {
+        ids[i] = (i * 7919) % num_vertices;
+    }
+    const std::vector<vertex_t> types(num_vertices, 1);
+    std::vector<const char*> payloads(num_vertices, "xy");
+    std::vector<std::size_t> sizes(num_vertices, 2);
+    payloads[42] = "last";
+    sizes[42] = 4;
+    {
+        auto loader = g.bulk_loader(1 << 20, 4);
+        check_is_ok(loader.insert_vertices(
+            types.data(), ids.data(), nullptr, nullptr, num_vertices));
+        // the last value of a vertex inserted twice wins
+        check_is_ok(loader.insert_vertices(
+            types.data(), ids.data(), payloads.data(), sizes.data(), num_vertices));
+        check_is_ok(loader.insert_edges(vertex, 1, ids.data(), num_vertices));
+        check_is_ok(loader.ingest());
+    }
+    std::size_t count;
+    check_is_ok(g.vertices().count(1, count));
+    REQUIRE(count == num_vertices);
+    check_is_ok(g.edges().count(count));
+    REQUIRE(count == num_vertices);
+    std::string payload;
+    check_is_ok(g.vertices().get(make_id(1, ids[42]), &payload));
+    REQUIRE(payload == "last");
+    vertex_uids_t edges;
+    check_is_ok(g.edges().get(vertex, edges));
+    REQUIRE(edges.size() == num_vertices);
+    REQUIRE(std::is_sorted(edges.begin(), edges.end()));
+}
+
+TEST_CASE("batched presence of vertices", "[GraphKV]") {
+    DirectedGraph g(new_db_path());
+    const std::vector<vertex_id_t> ids{5, 1, 3};
+    const std::vector<vertex_t> types(ids.size(), 1);
+    check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    const vertex_uids_t vertices{make_id(1, 3), make_id(1, 2), make_id(0, 1), make_id(1, 5)};
+    bool results[4];
+    check_is_ok(g.vertices().has(vertices.data(), vertices.size(), results));
+    REQUIRE(results[0]);
+    REQUIRE_FALSE(results[1]);
+    REQUIRE_FALSE(results[2]);
+    REQUIRE(results[3]);
+
+    // first missing vertex is reported
+    const std::vector<vertex_id_t> targets{3, 4, 2};
+    const auto status = g.edges().insert(make_id(1, 1), 1, targets.data(), targets.size());
+    REQUIRE(status.code == basalt::Status::missing_vertex_code);
+    REQUIRE(status.message.find("(1:4)") != std::string::npos);
+}
+
+TEST_CASE("pinned payload views", "[GraphKV]") {
+    DirectedGraph g(new_db_path());
+    const std::string payload{"pinned"};
+    const auto vertex = make_id(1, 1);
+    check_is_ok(g.vertices().insert(vertex, payload.data(), payload.size()));
+    check_is_ok(g.vertices().insert(make_id(1, 2)));
+
+    basalt::PayloadView view;
+    check_is_ok(g.vertices().get(vertex, view));
+    REQUIRE(std::string(view.data(), view.size()) == payload);
+    // the view outlives subsequent writes
+    check_is_ok(g.vertices().insert(vertex, "new", 3));
+    REQUIRE(std::string(view.data(), view.size()) == payload);
+
+    check_is_ok(g.vertices().get(make_id(1, 2), view));
+    REQUIRE(view.empty());
+    REQUIRE(g.vertices().get(make_id(1, 3), view).code == basalt::Status::missing_vertex_code);
+
+    const edge_uid_t edge{vertex, make_id(1, 2)};
+    check_is_ok(g.edges().insert(edge.first, edge.second, payload.data(), payload.size()));
+    basalt::PayloadView edge_view(std::move(view));
+    check_is_ok(g.edges().get(edge, edge_view));
+    REQUIRE(std::string(edge_view.data(), edge_view.size()) == payload);
+    REQUIRE(g.edges().get({edge.second, edge.first}, edge_view).code ==
+            basalt::Status::missing_edge_code);
+
+    // the view keeps the database open after the graph is destroyed
+    basalt::PayloadView outliving;
+    {
+        DirectedGraph other(new_db_path());
+        check_is_ok(other.vertices().insert(vertex, payload.data(), payload.size()));
+        check_is_ok(other.vertices().get(vertex, outliving));
+    }
+    REQUIRE(std::string(outliving.data(), outliving.size()) == payload);
+}
+
+TEST_CASE("undirected edge payloads stored once", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto vertex1 = make_id(1, 1);
+    const auto vertex2 = make_id(1, 2);
+    const auto vertex3 = make_id(1, 3);
+    for (const auto& vertex: {vertex1, vertex2, vertex3}) {
+        check_is_ok(g.vertices().insert(vertex));
+    }
+    // payload given with the greater vertex first
+    check_is_ok(g.edges().insert(vertex2, vertex1, "21", 2));
+    check_is_ok(g.edges().insert(vertex1, {vertex3}, {"13"}, {2}));
+    std::string payload;
+    for (const auto& edge: {edge_uid_t{vertex1, vertex2}, edge_uid_t{vertex2, vertex1}}) {
+        check_is_ok(g.edges().get(edge, &payload));
+        REQUIRE(payload == "21");
+    }
+    basalt::PayloadView view;
+    check_is_ok(g.edges().get({vertex3, vertex1}, view));
+    REQUIRE(std::string(view.data(), view.size()) == "13");
+
+    // overwritten from the other side
+    check_is_ok(g.edges().insert(vertex1, vertex2, "12", 2));
+    check_is_ok(g.edges().get({vertex2, vertex1}, &payload));
+    REQUIRE(payload == "12");
+    vertex_uids_t edges;
+    check_is_ok(g.edges().get(vertex2, edges));
+    REQUIRE(edges == vertex_uids_t{vertex1});
+}
+
+TEST_CASE("iterators are released and see latest writes", "[GraphKV]") {
+    DirectedGraph g(new_db_path());
+    const std::vector<vertex_id_t> ids{1, 2, 3};
+    const std::vector<vertex_t> types(ids.size(), 1);
+    check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    check_is_ok(g.edges().insert(make_id(1, 1), 1, ids.data(), ids.size()));
+    for (auto i = 0; i < 1000; ++i) {
+        REQUIRE(*g.vertices().begin() == make_id(1, 1));
+        REQUIRE(*g.edges().begin() == edge_uid_t{make_id(1, 1), make_id(1, 1)});
+    }
+    // recycled iterators do not read stale data
+    check_is_ok(g.vertices().insert(make_id(0, 42)));
+    REQUIRE(*g.vertices().begin() == make_id(0, 42));
+    REQUIRE(std::distance(g.vertices().begin(), g.vertices().end()) == 4);
+    check_is_ok(g.edges().insert(make_id(0, 42), make_id(1, 2)));
+    REQUIRE(std::distance(g.edges().begin(), g.edges().end()) == 4);
+
+    // iteration of a vertex edges stops at the end of its key prefix
+    check_is_ok(g.edges().insert(make_id(1, 2), make_id(1, 3)));
+    vertex_uids_t targets;
+    check_is_ok(g.edges().get(make_id(1, 1), targets));
+    REQUIRE(targets.size() == 3);
+    std::size_t degree;
+    check_is_ok(g.edges().degree(make_id(1, 1), 1, degree));
+    REQUIRE(degree == 3);
+}
+
+TEST_CASE("iterators outliving their graph", "[GraphKV]") {
+    std::unique_ptr<basalt::VertexIterator> vertices;
+    std::unique_ptr<basalt::EdgeIterator> edges;
+    {
+        DirectedGraph g(new_db_path());
+        const std::vector<vertex_id_t> ids{1, 2, 3};
+        const std::vector<vertex_t> types(ids.size(), 1);
+        check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+        check_is_ok(g.edges().insert(make_id(1, 1), 1, ids.data(), ids.size()));
+        vertices.reset(new basalt::VertexIterator(g.vertices().begin()));
+        edges.reset(new basalt::EdgeIterator(g.edges().begin()));
+    }
+    // the iterators keep the database open after the graph is destroyed
+    const basalt::VertexIterator vertices_end(nullptr);
+    std::size_t count = 0;
+    for (; *vertices != vertices_end; ++*vertices) {
+        ++count;
+    }
+    REQUIRE(count == 3);
+    REQUIRE(**edges == edge_uid_t{make_id(1, 1), make_id(1, 1)});
+    vertices.reset();
+    edges.reset();
+}
+
+TEST_CASE("seekable iterators", "[GraphKV]") {
+    DirectedGraph g(new_db_path());
+    const std::vector<vertex_id_t> ids{1, 2, 3, 5};
+    const std::vector<vertex_t> types(ids.size(), 1);
+    check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    check_is_ok(g.edges().insert(make_id(1, 1), 1, ids.data(), ids.size()));
+
+    REQUIRE(*g.vertices().begin(make_id(1, 2)) == make_id(1, 2));
+    REQUIRE(*g.vertices().begin(make_id(1, 4)) == make_id(1, 5));
+    REQUIRE(g.vertices().begin(make_id(1, 6)) == g.vertices().end());
+    REQUIRE(std::distance(g.vertices().begin(make_id(1, 3)), g.vertices().end()) == 2);
+
+    const edge_uid_t edge{make_id(1, 1), make_id(1, 4)};
+    REQUIRE(*g.edges().begin(edge) == edge_uid_t{make_id(1, 1), make_id(1, 5)});
+
+    // resume an iteration where it stopped
+    auto it = g.vertices().begin();
+    ++it;
+    const auto token = it.token();
+    REQUIRE(*g.vertices().resume(token) == make_id(1, 2));
+    REQUIRE(g.vertices().resume(g.vertices().end().token()) == g.vertices().end());
+    REQUIRE_THROWS(g.vertices().resume("invalid"));
+
+    auto edges = g.edges().begin();
+    ++edges;
+    const auto edge_token = edges.token();
+    const auto expected = *edges;
+    check_is_ok(g.edges().erase(expected.first, expected.second));
+    // resumed at the next edge when the current one is removed
+    REQUIRE(*g.edges().resume(edge_token) == edge_uid_t{make_id(1, 1), make_id(1, 3)});
+    REQUIRE(std::distance(g.edges().resume(edge_token), g.edges().end()) ==
+            std::distance(g.edges().begin(), g.edges().end()) - 1);
+}
+
+TEST_CASE("vertex iteration by type", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const std::vector<vertex_id_t> ids{0, 1, 2};
+    for (const vertex_t type: {-1, 0, 1}) {
+        const std::vector<vertex_t> types(ids.size(), type);
+        check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    }
+    for (const vertex_t type: {-1, 0, 1}) {
+        vertex_uids_t vertices(g.vertices().begin_type(type), g.vertices().end_type(type));
+        REQUIRE(vertices ==
+                vertex_uids_t{make_id(type, 0), make_id(type, 1), make_id(type, 2)});
+        std::size_t count;
+        check_is_ok(g.vertices().count(type, count));
+        REQUIRE(count == ids.size());
+    }
+    REQUIRE(g.vertices().begin_type(2) == g.vertices().end_type(2));
+}
+
+TEST_CASE("unique iteration over undirected edges", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const std::vector<vertex_id_t> ids{0, 1, 2, 3};
+    for (const vertex_t type: {0, 1}) {
+        const std::vector<vertex_t> types(ids.size(), type);
+        check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    }
+    check_is_ok(g.edges().insert(make_id(1, 2), 0, ids.data(), ids.size()));
+    check_is_ok(g.edges().insert(make_id(1, 2), 1, ids.data(), ids.size()));
+    check_is_ok(g.edges().insert(make_id(0, 3), make_id(0, 1)));
+
+    const std::vector<edge_uid_t> all(g.edges().begin(), g.edges().end());
+    const std::vector<edge_uid_t> unique(g.edges().begin_unique(), g.edges().end_unique());
+    std::vector<edge_uid_t> expected;
+    std::copy_if(all.begin(), all.end(), std::back_inserter(expected), [](const edge_uid_t& e) {
+        return !(e.second < e.first);
+    });
+    REQUIRE(unique == expected);
+    // 9 edges including the self-loop on (1, 2), stored once
+    REQUIRE(unique.size() == 9);
+    REQUIRE(all.size() == 17);
+}
+
+TEST_CASE("parallel scans", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    std::vector<vertex_id_t> ids(100);
+    std::iota(ids.begin(), ids.end(), 0);
+    const std::vector<vertex_t> types(ids.size(), 1);
+    check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    for (const auto id: {0, 7, 42}) {
+        check_is_ok(g.edges().insert(make_id(1, id), 1, ids.data(), ids.size()));
+    }
+
+    std::size_t vertices = 0;
+    check_is_ok(g.vertices().parallel_for_each(
+        vertices,
+        [](std::size_t& count, const vertex_uid_t& /* vertex */) { ++count; },
+        [](std::size_t& result, std::size_t count) { result += count; },
+        4));
+    REQUIRE(vertices == ids.size());
+
+    // degree of every vertex
+    using degrees_t = std::map<vertex_uid_t, std::size_t>;
+    degrees_t degrees;
+    check_is_ok(g.edges().parallel_for_each(
+        degrees,
+        [](degrees_t& state, const edge_uid_t& edge) { ++state[edge.first]; },
+        [](degrees_t& result, const degrees_t& state) {
+            for (const auto& degree: state) {
+                result[degree.first] += degree.second;
+            }
+        }));
+    REQUIRE(degrees.size() == ids.size());
+    for (const auto& degree: degrees) {
+        std::size_t expected;
+        check_is_ok(g.edges().degree(degree.first, expected));
+        REQUIRE(degree.second == expected);
+    }
+
+    // every partition is visited by a single thread, in order
+    std::vector<vertex_uids_t> partitions(3);
+    check_is_ok(g.vertices().parallel_for_each(
+        [&partitions](std::size_t partition, const vertex_uid_t& vertex) {
+            partitions[partition].push_back(vertex);
+        },
+        partitions.size()));
+    vertex_uids_t visited;
+    for (const auto& partition: partitions) {
+        visited.insert(visited.end(), partition.begin(), partition.end());
+    }
+    REQUIRE(visited == vertex_uids_t(g.vertices().begin(), g.vertices().end()));
+    // keys still in memtables are split at sampled keys
+    REQUIRE(std::count_if(partitions.begin(),
+                          partitions.end(),
+                          [](const vertex_uids_t& partition) { return !partition.empty(); }) > 1);
+}
+
+TEST_CASE("compressed sparse row snapshot", "[GraphKV]") {
+    DirectedGraph g(new_db_path());
+    std::vector<vertex_id_t> ids(50);
+    std::iota(ids.begin(), ids.end(), 0);
+    for (const vertex_t type: {0, 1}) {
+        const std::vector<vertex_t> types(ids.size(), type);
+        check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    }
+    for (const vertex_id_t id: {0, 3, 49}) {
+        check_is_ok(g.edges().insert(make_id(1, id), 0, ids.data(), id + 1));
+        check_is_ok(g.edges().insert(make_id(0, id), make_id(1, 49 - id)));
+    }
+
+    basalt::CSR csr;
+    check_is_ok(g.snapshot_csr(csr, 3));
+    REQUIRE(csr.num_vertices() == 2 * ids.size());
+    REQUIRE(csr.offsets.size() == csr.num_vertices() + 1);
+    std::size_t count;
+    check_is_ok(g.edges().count(count));
+    REQUIRE(csr.num_edges() == count);
+    REQUIRE(csr.index(make_id(1, 0)) == static_cast<std::int64_t>(ids.size()));
+    REQUIRE(csr.index(make_id(2, 0)) == -1);
+    for (std::size_t i = 0; i < csr.num_vertices(); ++i) {
+        const auto vertex = csr.vertex(i);
+        REQUIRE(csr.index(vertex) == static_cast<std::int64_t>(i));
+        vertex_uids_t expected;
+        check_is_ok(g.edges().get(vertex, expected));
+        vertex_uids_t neighbours;
+        for (auto j = csr.offsets[i]; j < csr.offsets[i + 1]; ++j) {
+            neighbours.push_back(csr.vertex(static_cast<std::size_t>(csr.indices[j])));
+        }
+        REQUIRE(neighbours == expected);
+    }
+}
+
+TEST_CASE("connected components and PageRank of a CSR snapshot", "[GraphKV]") {
+    DirectedGraph g(new_db_path());
+    std::vector<vertex_id_t> ids(7);
+    std::iota(ids.begin(), ids.end(), 0);
+    const std::vector<vertex_t> types(ids.size(), 0);
+    check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    for (const auto& edge: std::vector<std::pair<vertex_id_t, vertex_id_t>>{
+             {0, 1}, {2, 1}, {3, 4}, {4, 3}, {6, 5}}) {
+        check_is_ok(g.edges().insert(make_id(0, edge.first), make_id(0, edge.second)));
+    }
+    basalt::CSR csr;
+    check_is_ok(g.snapshot_csr(csr));
+
+    for (const std::size_t num_threads: {1, 3}) {
+        // components ignore the direction of the edges
+        std::vector<std::int64_t> components;
+        csr.connected_components(components, num_threads);
+        REQUIRE(components == std::vector<std::int64_t>{0, 0, 0, 3, 3, 5, 5});
+
+        std::vector<double> ranks;
+        REQUIRE(csr.pagerank(ranks, 0.85, 1e-10, 1000, num_threads) > 1);
+        REQUIRE(ranks.size() == csr.num_vertices());
+        REQUIRE(std::accumulate(ranks.begin(), ranks.end(), 0.) == Approx(1.));
+        REQUIRE(ranks[1] > ranks[0]);
+        REQUIRE(ranks[0] == Approx(ranks[2]));
+        REQUIRE(ranks[3] == Approx(ranks[4]));
+        REQUIRE(ranks[5] > ranks[6]);
+    }
+    std::vector<double> ranks;
+    REQUIRE(csr.pagerank(ranks, 0.85, 0., 2) == 2);
+    REQUIRE(basalt::CSR().pagerank(ranks) == 0);
+    REQUIRE(ranks.empty());
+}
+
+/**
+ * \brief Helper function changing the "read_only" entry of the configuration of a graph
+ */
+static void set_read_only(const std::string& path, bool read_only) {
+    std::ifstream istr(path + "/config.json");
+    std::string config((std::istreambuf_iterator<char>(istr)), std::istreambuf_iterator<char>());
+    const std::string entry = R"("read_only": )";
+    const auto position = config.find(entry);
+    REQUIRE(position != std::string::npos);
+    const auto end = config.find_first_of(",\n}", position);
+    config.replace(position, end - position, entry + (read_only ? "true" : "false"));
+    std::ofstream(path + "/config.json") << config;
+}
+
+TEST_CASE("key format recorded in the database", "[GraphKV]") {
+    const auto path = new_db_path();
+    {
+        DirectedGraph g(path);
+        check_is_ok(g.vertices().insert(make_id(1, 1)));
+    }
+    // the database can be opened without its JSON config
+    REQUIRE(std::remove((path + "/config.json").c_str()) == 0);
+    {
+        DirectedGraph g(path);
+        bool present;
+        check_is_ok(g.vertices().has(make_id(1, 1), present));
+        REQUIRE(present);
+    }
+    // but not with a config declaring another key format
+    std::ifstream istr(path + "/config.json");
+    std::string config((std::istreambuf_iterator<char>(istr)), std::istreambuf_iterator<char>());
+    const std::string entry = R"("key_format": 1)";
+    const auto position = config.find(entry);
+    REQUIRE(position != std::string::npos);
+    config.replace(position, entry.size(), R"("key_format": 0)");
+    std::ofstream(path + "/config.json") << config;
+    REQUIRE_THROWS_AS(DirectedGraph(path), std::runtime_error);
+}
+
+TEST_CASE("memory-mapped CSR file of read-only graphs", "[GraphKV]") {
+    const auto path = new_db_path();
+    const auto A = make_id(0, 0);
+    const auto B = make_id(1, 9);
+    {
+        UndirectedGraph g(path);
+        std::vector<vertex_id_t> ids(10);
+        std::iota(ids.begin(), ids.end(), 0);
+        for (const vertex_t type: {0, 1}) {
+            const std::vector<vertex_t> types(ids.size(), type);
+            check_is_ok(
+                g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+        }
+        check_is_ok(g.edges().insert(A, 1, ids.data(), 5));
+        check_is_ok(g.edges().insert(A, B));
+        check_is_ok(g.edges().insert(B, make_id(0, 3)));
+        check_is_ok(g.export_csr(2));
+    }
+    struct stat info {};
+    REQUIRE(stat((path + "/topology.csr").c_str(), &info) == 0);
+
+    const auto check_queries = [&](UndirectedGraph& g) {
+        vertex_uids_t edges;
+        check_is_ok(g.edges().get(A, edges));
+        REQUIRE(edges == vertex_uids_t{{1, 0}, {1, 1}, {1, 2}, {1, 3}, {1, 4}, B});
+        edges.clear();
+        check_is_ok(g.edges().get(B, 0, edges));
+        REQUIRE(edges == vertex_uids_t{A, {0, 3}});
+        edges.clear();
+        check_is_ok(g.edges().get(A, 1, 2, 4, edges));
+        REQUIRE(edges == vertex_uids_t{{1, 2}, {1, 3}});
+        edges.clear();
+        check_is_ok(g.edges().get(make_id(2, 0), edges));
+        REQUIRE(edges.empty());
+        bool result;
+        check_is_ok(g.edges().has(B, A, result));
+        REQUIRE(result);
+        check_is_ok(g.edges().has(A, make_id(1, 5), result));
+        REQUIRE_FALSE(result);
+        std::size_t degree;
+        check_is_ok(g.edges().degree(A, degree));
+        REQUIRE(degree == 6);
+        check_is_ok(g.edges().degree(B, 1, degree));
+        REQUIRE(degree == 0);
+        const vertex_t types[] = {0, 1, 1};
+        const vertex_id_t ids[] = {0, 9, 5};
+        std::size_t degrees[3];
+        check_is_ok(g.edges().degree(types, ids, 3, degrees));
+        REQUIRE(degrees[0] == 6);
+        REQUIRE(degrees[1] == 2);
+        REQUIRE(degrees[2] == 0);
+    };
+
+    set_read_only(path, true);
+    {
+        UndirectedGraph g(path);
+        check_queries(g);
+    }
+
+    // an outdated file is ignored
+    set_read_only(path, false);
+    {
+        UndirectedGraph g(path);
+        check_is_ok(g.edges().insert(A, make_id(0, 3)));
+    }
+    set_read_only(path, true);
+    {
+        UndirectedGraph g(path);
+        bool result;
+        check_is_ok(g.edges().has(make_id(0, 3), A, result));
+        REQUIRE(result);
+    }
+}
+
+TEST_CASE("breadth-first traversal hop by hop", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto A = make_id(0, 0);
+    for (const auto& vertex: vertex_uids_t{A, {1, 1}, {1, 2}, {2, 5}, {2, 6}, {0, 9}}) {
+        check_is_ok(g.vertices().insert(vertex));
+    }
+    check_is_ok(g.edges().insert(A, make_id(1, 1)));
+    check_is_ok(g.edges().insert(A, make_id(1, 2)));
+    check_is_ok(g.edges().insert(make_id(1, 1), make_id(2, 5)));
+    check_is_ok(g.edges().insert(make_id(1, 2), make_id(2, 5)));
+    check_is_ok(g.edges().insert(make_id(1, 2), make_id(2, 6)));
+    check_is_ok(g.edges().insert(make_id(2, 5), make_id(0, 9)));
+
+    Hops hops;
+    check_is_ok(g.k_hop({A, A}, 4, {}, hops));
+    REQUIRE(hops.num_hops() == 4);
+    REQUIRE(hops.offsets == std::vector<std::size_t>{0, 2, 4, 5, 5});
+    REQUIRE(hops.types == std::vector<vertex_t>{1, 1, 2, 2, 0});
+    REQUIRE(hops.ids == std::vector<vertex_id_t>{1, 2, 5, 6, 9});
+
+    check_is_ok(g.k_hop({A}, 3, {1, 2, 0}, hops));
+    REQUIRE(hops.offsets == std::vector<std::size_t>{0, 2, 4, 5});
+    // the seed is not reached again
+    check_is_ok(g.k_hop({A}, 2, {1, 0}, hops));
+    REQUIRE(hops.offsets == std::vector<std::size_t>{0, 2, 2});
+    check_is_ok(g.k_hop({{2, 6}}, 2, {2, 2}, hops));
+    REQUIRE(hops.size(1) == 0);
+    REQUIRE(hops.size(2) == 0);
+
+    const auto status = g.k_hop({A}, 2, {1}, hops);
+    REQUIRE_FALSE(status);
+    REQUIRE(status.message.find("Invalid argument") != std::string::npos);
+}
+
+TEST_CASE("declarative traversal", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto A = make_id(0, 0);
+    for (const auto& vertex: vertex_uids_t{A, {1, 1}, {1, 2}, {2, 5}, {2, 6}, {0, 9}}) {
+        check_is_ok(g.vertices().insert(vertex));
+    }
+    check_is_ok(g.edges().insert(A, make_id(1, 1)));
+    check_is_ok(g.edges().insert(A, make_id(1, 2)));
+    check_is_ok(g.edges().insert(make_id(1, 1), make_id(2, 5)));
+    check_is_ok(g.edges().insert(make_id(1, 2), make_id(2, 5)));
+    check_is_ok(g.edges().insert(make_id(1, 2), make_id(2, 6)));
+    check_is_ok(g.edges().insert(make_id(2, 5), make_id(0, 9)));
+
+    std::vector<vertex_t> types;
+    std::vector<vertex_id_t> ids;
+    Traversal traversal;
+    traversal.out(1).out(2);
+    REQUIRE(traversal.steps().size() == 2);
+    check_is_ok(g.traverse({A}, traversal, types, ids));
+    REQUIRE(types == std::vector<vertex_t>{2, 2, 2});
+    REQUIRE(ids == std::vector<vertex_id_t>{5, 5, 6});
+
+    // vertex (2, 5) is reached twice, so is its neighbour
+    traversal.out(0);
+    check_is_ok(g.traverse({A}, traversal, types, ids));
+    REQUIRE(ids == std::vector<vertex_id_t>{9, 9});
+    traversal.distinct();
+    check_is_ok(g.traverse({A}, traversal, types, ids));
+    REQUIRE(types == std::vector<vertex_t>{0});
+    REQUIRE(ids == std::vector<vertex_id_t>{9});
+
+    // every copy of a seed is expanded
+    check_is_ok(g.traverse({A, A}, Traversal().out(1), types, ids));
+    REQUIRE(ids == std::vector<vertex_id_t>{1, 2, 1, 2});
+    check_is_ok(g.traverse({A, A}, Traversal().distinct().out(), types, ids));
+    REQUIRE(types == std::vector<vertex_t>{1, 1});
+    check_is_ok(g.traverse({{2, 6}}, Traversal().out(0), types, ids));
+    REQUIRE(ids.empty());
+}
+
+TEST_CASE("common neighbours and set operations", "[GraphKV]") {
+    UndirectedGraph g(new_db_path());
+    const auto A = make_id(0, 1);
+    const auto B = make_id(0, 2);
+    const auto C = make_id(0, 3);
+    std::vector<vertex_id_t> ids(1000);
+    std::iota(ids.begin(), ids.end(), 0);
+    const std::vector<vertex_t> types(ids.size(), 1);
+    check_is_ok(g.vertices().insert(types.data(), ids.data(), nullptr, nullptr, ids.size()));
+    for (const auto& vertex: {A, B, C}) {
+        check_is_ok(g.vertices().insert(vertex));
+    }
+    // A has many more neighbours than B, so that the intersection gallops through them
+    check_is_ok(g.edges().insert(A, 1, ids.data(), ids.size()));
+    const std::vector<vertex_id_t> b_ids{5, 50, 999};
+    check_is_ok(g.edges().insert(B, 1, b_ids.data(), b_ids.size()));
+    const std::vector<vertex_id_t> c_ids{50, 51};
+    check_is_ok(g.edges().insert(C, 1, c_ids.data(), c_ids.size()));
+    check_is_ok(g.edges().insert(A, B));
+    check_is_ok(g.edges().insert(C, B));
+
+    std::vector<vertex_id_t> result;
+    check_is_ok(g.edges().common(A, B, 1, result));
+    REQUIRE(result == b_ids);
+    check_is_ok(g.edges().common(B, A, 1, result));
+    REQUIRE(result == b_ids);
+    vertex_uids_t vertices;
+    check_is_ok(g.edges().common(A, C, vertices));
+    REQUIRE(vertices == vertex_uids_t{B, {1, 50}, {1, 51}});
+
+    check_is_ok(g.edges().combine(SetOperation::set_intersection, {A, B, C}, 1, result));
+    REQUIRE(result == std::vector<vertex_id_t>{50});
+    check_is_ok(g.edges().combine(SetOperation::set_intersection, {B, C, A}, 0, result));
+    REQUIRE(result.empty());
+    check_is_ok(g.edges().combine(SetOperation::set_union, {B, C}, 1, result));
+    REQUIRE(result == std::vector<vertex_id_t>{5, 50, 51, 999});
+    check_is_ok(g.edges().combine(SetOperation::set_difference, {C, B}, 1, result));
+    REQUIRE(result == std::vector<vertex_id_t>{51});
+    check_is_ok(g.edges().combine(SetOperation::set_difference, {B, A}, 1, result));
+    REQUIRE(result.empty());
+    check_is_ok(g.edges().combine(SetOperation::set_union, {}, 1, result));
+    REQUIRE(result.empty());
+}